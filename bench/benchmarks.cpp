@@ -0,0 +1,2111 @@
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <span>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include "../include/Point.h"
+#include "../include/Array.h"
+#include "../include/Figure.h"
+#include "../include/Polygon.h"
+#include "../include/Rectangle.h"
+#include "../include/Rhombus.h"
+#include "../include/Trapezoid.h"
+#include "../include/FigureStore.h"
+#include "../include/AreaBatch.h"
+#include "../include/MemoryResource.h"
+#include "../include/ThreadPool.h"
+#include "../include/SceneFile.h"
+#include "../include/FigureVariant.h"
+#include "../include/SpatialIndex.h"
+#include "../include/FigureStream.h"
+#include "../include/TextCodec.h"
+#include "../include/PredicateBatch.h"
+#include "../include/Arithmetic.h"
+#include "../include/ConcurrentArray.h"
+#include "../include/StaticPolygon.h"
+#include "../include/Instrumentation.h"
+#include "../include/Simplification.h"
+
+
+// ============================================================================
+// HELPERS
+// ============================================================================
+
+// Счетчик вызовов глобального operator new для бенчмарков аллокаций.
+// operator new зовут и рабочие потоки пула, поэтому счетчик атомарный.
+static std::atomic<size_t> global_allocations = 0;
+
+// Память из замененного operator new освобождается здесь. Функция не
+// встраивается, иначе GCC видит free() на указателе от operator new
+// и выдает -Wmismatched-new-delete.
+[[gnu::noinline]] static void release_allocation(void* pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void* operator new(size_t size)
+{
+    global_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* pointer = std::malloc(size == 0 ? 1 : size))
+    {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept
+{
+    release_allocation(pointer);
+}
+
+void operator delete(void* pointer, size_t) noexcept
+{
+    release_allocation(pointer);
+}
+
+void* operator new(size_t size, std::align_val_t alignment)
+{
+    global_allocations.fetch_add(1, std::memory_order_relaxed);
+    const size_t align = static_cast<size_t>(alignment);
+    if (void* pointer = std::aligned_alloc(align, (size + align - 1) / align * align))
+    {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* pointer, std::align_val_t) noexcept
+{
+    release_allocation(pointer);
+}
+
+void operator delete(void* pointer, size_t, std::align_val_t) noexcept
+{
+    release_allocation(pointer);
+}
+
+template<template<Scalar> class F, Scalar T>
+F<T> make_quad(size_t i)
+{
+    const T x = static_cast<T>(i % 1000);
+    const T y = static_cast<T>(i / 1000);
+    const T w = static_cast<T>(1 + i % 7);
+    const T h = static_cast<T>(1 + i % 5);
+
+    F<T> figure;
+    figure.set_vertex(0, Point<T>(x, y));
+    figure.set_vertex(1, Point<T>(x + w, y));
+    figure.set_vertex(2, Point<T>(x + w, y + h));
+    figure.set_vertex(3, Point<T>(x, y + h));
+
+    return figure;
+}
+
+
+template<Scalar T>
+Rectangle<T> make_rectangle(size_t i)
+{
+    return make_quad<Rectangle, T>(i);
+}
+
+
+template<Scalar T>
+Polygon<T> make_regular_polygon(size_t vertices, double offset = 0.0, double radius = 100.0)
+{
+    Polygon<T> polygon(vertices);
+    for (size_t j = 0; j < vertices; ++j)
+    {
+        const double angle = 2.0 * M_PI * j / vertices;
+        polygon.set_vertex(j, Point<T>(static_cast<T>(offset + radius * std::cos(angle)), static_cast<T>(radius * std::sin(angle))));
+    }
+
+    return polygon;
+}
+
+
+// ============================================================================
+// ARRAY: APPEND, RESIZE, REMOVE
+// ============================================================================
+
+template<Scalar T>
+static void BM_Array_Append(benchmark::State& state)
+{
+    const size_t count = state.range(0);
+
+    for (auto _ : state)
+    {
+        Array<Point<T>> points;
+        for (size_t i = 0; i < count; ++i)
+        {
+            points.append(Point<T>(static_cast<T>(i), static_cast<T>(i)));
+        }
+        benchmark::DoNotOptimize(points.get_size());
+    }
+
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_Array_Append<int>)->RangeMultiplier(10)->Range(100, 10000000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_Array_Append<float>)->RangeMultiplier(10)->Range(100, 10000000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_Array_Append<double>)->RangeMultiplier(10)->Range(100, 10000000)->Unit(benchmark::kMicrosecond);
+
+
+// Тот же append, но без resize: емкость задана заранее
+template<Scalar T>
+static void BM_Array_AppendPresized(benchmark::State& state)
+{
+    const size_t count = state.range(0);
+
+    for (auto _ : state)
+    {
+        Array<Point<T>> points(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            points.append(Point<T>(static_cast<T>(i), static_cast<T>(i)));
+        }
+        benchmark::DoNotOptimize(points.get_size());
+    }
+
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_Array_AppendPresized<int>)->RangeMultiplier(10)->Range(100, 10000000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_Array_AppendPresized<double>)->RangeMultiplier(10)->Range(100, 10000000)->Unit(benchmark::kMicrosecond);
+
+
+// Удаление из середины массива и возврат элемента в конец
+template<Scalar T>
+static void BM_Array_RemoveMiddle(benchmark::State& state)
+{
+    const size_t count = state.range(0);
+    Array<Point<T>> points(count + 1);
+    for (size_t i = 0; i < count; ++i)
+    {
+        points.append(Point<T>(static_cast<T>(i), static_cast<T>(i)));
+    }
+
+    for (auto _ : state)
+    {
+        points.remove(count / 2);
+        points.append(Point<T>(0, 0));
+    }
+
+    state.SetItemsProcessed(state.iterations() * count / 2);
+}
+BENCHMARK(BM_Array_RemoveMiddle<int>)->RangeMultiplier(10)->Range(100, 10000000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_Array_RemoveMiddle<double>)->RangeMultiplier(10)->Range(100, 10000000)->Unit(benchmark::kMicrosecond);
+
+
+// ============================================================================
+// POLYGON: AREA AND CENTER
+// ============================================================================
+
+// set_vertex сбрасывает кэш, поэтому каждая итерация честно пересчитывает площадь
+template<Scalar T>
+static void BM_Polygon_Area(benchmark::State& state)
+{
+    Polygon<T> polygon = make_regular_polygon<T>(state.range(0));
+    const Point<T> first = polygon.get_vertex(0);
+
+    for (auto _ : state)
+    {
+        polygon.set_vertex(0, first);
+        benchmark::DoNotOptimize(polygon.area());
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_Polygon_Area<int>)->RangeMultiplier(4)->Range(4, 4096);
+BENCHMARK(BM_Polygon_Area<float>)->RangeMultiplier(4)->Range(4, 4096);
+BENCHMARK(BM_Polygon_Area<double>)->RangeMultiplier(4)->Range(4, 4096);
+
+
+template<Scalar T>
+static void BM_Polygon_Center(benchmark::State& state)
+{
+    Polygon<T> polygon = make_regular_polygon<T>(state.range(0));
+    const Point<T> first = polygon.get_vertex(0);
+
+    for (auto _ : state)
+    {
+        polygon.set_vertex(0, first);
+        benchmark::DoNotOptimize(polygon.get_center());
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_Polygon_Center<int>)->RangeMultiplier(4)->Range(4, 4096);
+BENCHMARK(BM_Polygon_Center<float>)->RangeMultiplier(4)->Range(4, 4096);
+BENCHMARK(BM_Polygon_Center<double>)->RangeMultiplier(4)->Range(4, 4096);
+
+
+// ============================================================================
+// POLYGON: STREAM READ AND WRITE
+// ============================================================================
+
+template<Scalar T>
+static void BM_Polygon_Write(benchmark::State& state)
+{
+    const Polygon<T> polygon = make_regular_polygon<T>(state.range(0));
+    std::ostringstream stream;
+
+    for (auto _ : state)
+    {
+        stream.str(std::string());
+        stream << polygon;
+        benchmark::DoNotOptimize(stream.tellp());
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_Polygon_Write<int>)->RangeMultiplier(8)->Range(4, 4096);
+BENCHMARK(BM_Polygon_Write<double>)->RangeMultiplier(8)->Range(4, 4096);
+
+
+template<Scalar T>
+static void BM_Polygon_Read(benchmark::State& state)
+{
+    const size_t vertices = state.range(0);
+    const Polygon<T> source = make_regular_polygon<T>(vertices);
+    std::ostringstream text;
+    for (size_t i = 0; i < vertices; ++i)
+    {
+        const Point<T> vertex = source.get_vertex(i);
+        text << vertex.x << ' ' << vertex.y << '\n';
+    }
+    const std::string input = text.str();
+    Polygon<T> polygon(vertices);
+
+    for (auto _ : state)
+    {
+        std::istringstream stream(input);
+        stream >> polygon;
+        benchmark::DoNotOptimize(polygon.get_vertex(0));
+    }
+
+    state.SetItemsProcessed(state.iterations() * vertices);
+    state.SetBytesProcessed(state.iterations() * input.size());
+}
+BENCHMARK(BM_Polygon_Read<int>)->RangeMultiplier(8)->Range(4, 4096);
+BENCHMARK(BM_Polygon_Read<double>)->RangeMultiplier(8)->Range(4, 4096);
+
+
+template<Scalar T>
+static void BM_Polygon_WriteCodec(benchmark::State& state)
+{
+    const Polygon<T> polygon = make_regular_polygon<T>(state.range(0));
+    std::ostringstream stream;
+
+    for (auto _ : state)
+    {
+        stream.str(std::string());
+        {
+            TextWriter writer(stream);
+            write_text(writer, polygon);
+        }
+        benchmark::DoNotOptimize(stream.tellp());
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_Polygon_WriteCodec<int>)->RangeMultiplier(8)->Range(4, 4096);
+BENCHMARK(BM_Polygon_WriteCodec<double>)->RangeMultiplier(8)->Range(4, 4096);
+
+
+template<Scalar T>
+static void BM_Polygon_ReadCodec(benchmark::State& state)
+{
+    const size_t vertices = state.range(0);
+    const Polygon<T> source = make_regular_polygon<T>(vertices);
+    std::ostringstream text;
+    for (size_t i = 0; i < vertices; ++i)
+    {
+        const Point<T> vertex = source.get_vertex(i);
+        text << vertex.x << ' ' << vertex.y << '\n';
+    }
+    const std::string input = text.str();
+    Polygon<T> polygon(vertices);
+
+    for (auto _ : state)
+    {
+        std::istringstream stream(input);
+        TextScanner scanner(stream);
+        read_text(scanner, polygon);
+        benchmark::DoNotOptimize(polygon.get_vertex(0));
+    }
+
+    state.SetItemsProcessed(state.iterations() * vertices);
+    state.SetBytesProcessed(state.iterations() * input.size());
+}
+BENCHMARK(BM_Polygon_ReadCodec<int>)->RangeMultiplier(8)->Range(4, 4096);
+BENCHMARK(BM_Polygon_ReadCodec<double>)->RangeMultiplier(8)->Range(4, 4096);
+
+
+// Дамп большого многоугольника в файл: operator<< против TextWriter.
+static std::string polygon_dump_path()
+{
+    return (std::filesystem::temp_directory_path() / "bench_polygon_dump.txt").string();
+}
+
+
+static void BM_Polygon_DumpStream(benchmark::State& state)
+{
+    const Polygon<double> polygon = make_regular_polygon<double>(state.range(0));
+
+    for (auto _ : state)
+    {
+        std::ofstream file(polygon_dump_path());
+        file << polygon;
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.SetBytesProcessed(state.iterations() * std::filesystem::file_size(polygon_dump_path()));
+}
+BENCHMARK(BM_Polygon_DumpStream)->Arg(1 << 20)->Unit(benchmark::kMillisecond);
+
+
+static void BM_Polygon_DumpCodec(benchmark::State& state)
+{
+    const Polygon<double> polygon = make_regular_polygon<double>(state.range(0));
+
+    for (auto _ : state)
+    {
+        std::ofstream file(polygon_dump_path());
+        TextWriter writer(file);
+        write_text(writer, polygon);
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.SetBytesProcessed(state.iterations() * std::filesystem::file_size(polygon_dump_path()));
+}
+BENCHMARK(BM_Polygon_DumpCodec)->Arg(1 << 20)->Unit(benchmark::kMillisecond);
+
+
+// ============================================================================
+// FIGURE STORE VS ARRAY OF SHARED_PTR
+// ============================================================================
+
+static void BM_SharedPtrArray_TotalArea(benchmark::State& state)
+{
+    const size_t count = state.range(0);
+    Array<std::shared_ptr<Figure<double>>> figures;
+    for (size_t i = 0; i < count; ++i)
+    {
+        figures.append(std::make_shared<Rectangle<double>>(make_rectangle<double>(i)));
+    }
+
+    for (auto _ : state)
+    {
+        double total = 0.0;
+        for (size_t i = 0; i < figures.get_size(); ++i)
+        {
+            total += figures[i]->area();
+        }
+        benchmark::DoNotOptimize(total);
+    }
+
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_SharedPtrArray_TotalArea)->RangeMultiplier(10)->Range(1000, 1000000);
+
+
+static void BM_FigureStore_TotalArea(benchmark::State& state)
+{
+    const size_t count = state.range(0);
+    FigureStore<double> store;
+    store.reserve(count, count * 4);
+    for (size_t i = 0; i < count; ++i)
+    {
+        store.append(make_rectangle<double>(i));
+    }
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(store.total_area());
+    }
+
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_FigureStore_TotalArea)->RangeMultiplier(10)->Range(1000, 1000000);
+
+
+static void BM_SharedPtrArray_Centers(benchmark::State& state)
+{
+    const size_t count = state.range(0);
+    Array<std::shared_ptr<Figure<double>>> figures;
+    for (size_t i = 0; i < count; ++i)
+    {
+        figures.append(std::make_shared<Rectangle<double>>(make_rectangle<double>(i)));
+    }
+    std::vector<Point<double>> centers(count);
+
+    for (auto _ : state)
+    {
+        for (size_t i = 0; i < figures.get_size(); ++i)
+        {
+            centers[i] = figures[i]->get_center();
+        }
+        benchmark::DoNotOptimize(centers.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_SharedPtrArray_Centers)->RangeMultiplier(10)->Range(1000, 1000000);
+
+
+static void BM_FigureStore_Centers(benchmark::State& state)
+{
+    const size_t count = state.range(0);
+    FigureStore<double> store;
+    store.reserve(count, count * 4);
+    for (size_t i = 0; i < count; ++i)
+    {
+        store.append(make_rectangle<double>(i));
+    }
+    std::vector<Point<double>> centers(count);
+
+    for (auto _ : state)
+    {
+        store.centers(centers);
+        benchmark::DoNotOptimize(centers.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_FigureStore_Centers)->RangeMultiplier(10)->Range(1000, 1000000);
+
+
+// ============================================================================
+// AREA BATCH KERNELS
+// ============================================================================
+
+template<Scalar T>
+static void BM_AreaBatch(benchmark::State& state)
+{
+    const SimdLevel level = static_cast<SimdLevel>(state.range(1));
+    if (static_cast<int>(level) > static_cast<int>(detect_simd_level()))
+    {
+        state.SkipWithError("SIMD level is not supported by this CPU");
+        return;
+    }
+
+    const size_t count = state.range(0);
+    FigureStore<T> store;
+    store.reserve(count, count * 4);
+    for (size_t i = 0; i < count; ++i)
+    {
+        store.append(make_rectangle<T>(i));
+    }
+    std::vector<double> areas(count);
+
+    const SimdLevel previous = get_simd_level();
+    set_simd_level(level);
+    for (auto _ : state)
+    {
+        area_batch(store, std::span<double>(areas));
+        benchmark::DoNotOptimize(areas.data());
+    }
+    set_simd_level(previous);
+
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_AreaBatch<double>)->ArgsProduct({{10000, 1000000}, {0, 1, 2}});
+BENCHMARK(BM_AreaBatch<float>)->ArgsProduct({{10000, 1000000}, {0, 1, 2}});
+BENCHMARK(BM_AreaBatch<int>)->ArgsProduct({{10000, 1000000}, {0, 1, 2}});
+
+
+// ============================================================================
+// QUADRILATERAL CONSTRUCTION, COPY AND MOVE
+// ============================================================================
+
+static void BM_Rectangle_Construct(benchmark::State& state)
+{
+    const size_t count = state.range(0);
+    std::vector<Rectangle<double>> rectangles;
+    rectangles.reserve(count);
+
+    for (auto _ : state)
+    {
+        rectangles.clear();
+        for (size_t i = 0; i < count; ++i)
+        {
+            Rectangle<double>& rectangle = rectangles.emplace_back();
+            const double x = static_cast<double>(i % 1000);
+            const double y = static_cast<double>(i / 1000);
+            rectangle.set_vertex(0, Point<double>(x, y));
+            rectangle.set_vertex(1, Point<double>(x + 1, y));
+            rectangle.set_vertex(2, Point<double>(x + 1, y + 1));
+            rectangle.set_vertex(3, Point<double>(x, y + 1));
+        }
+        benchmark::DoNotOptimize(rectangles.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_Rectangle_Construct)->Arg(100000)->Arg(10000000)->Unit(benchmark::kMillisecond);
+
+
+template<template<Scalar> class F, Scalar T>
+static void BM_Figure_Copy(benchmark::State& state)
+{
+    const size_t count = state.range(0);
+    std::vector<F<T>> source;
+    source.reserve(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        source.push_back(make_quad<F, T>(i));
+    }
+    std::vector<F<T>> copies;
+    copies.reserve(count);
+
+    for (auto _ : state)
+    {
+        copies.clear();
+        for (size_t i = 0; i < count; ++i)
+        {
+            copies.push_back(source[i]);
+        }
+        benchmark::DoNotOptimize(copies.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_Figure_Copy<Rectangle, int>)->RangeMultiplier(100)->Range(100, 1000000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_Figure_Copy<Rectangle, float>)->RangeMultiplier(100)->Range(100, 1000000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_Figure_Copy<Rectangle, double>)->RangeMultiplier(100)->Range(100, 10000000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_Figure_Copy<Rhombus, double>)->RangeMultiplier(100)->Range(100, 1000000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_Figure_Copy<Trapezoid, double>)->RangeMultiplier(100)->Range(100, 1000000)->Unit(benchmark::kMicrosecond);
+
+
+template<template<Scalar> class F, Scalar T>
+static void BM_Figure_Move(benchmark::State& state)
+{
+    const size_t count = state.range(0);
+    std::vector<F<T>> first;
+    first.reserve(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        first.push_back(make_quad<F, T>(i));
+    }
+    std::vector<F<T>> second(count);
+
+    for (auto _ : state)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            second[i] = std::move(first[i]);
+        }
+        std::swap(first, second);
+        benchmark::DoNotOptimize(first.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_Figure_Move<Rectangle, int>)->RangeMultiplier(100)->Range(100, 1000000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_Figure_Move<Rectangle, float>)->RangeMultiplier(100)->Range(100, 1000000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_Figure_Move<Rectangle, double>)->RangeMultiplier(100)->Range(100, 10000000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_Figure_Move<Rhombus, double>)->RangeMultiplier(100)->Range(100, 1000000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_Figure_Move<Trapezoid, double>)->RangeMultiplier(100)->Range(100, 1000000)->Unit(benchmark::kMicrosecond);
+
+
+// ============================================================================
+// FRAME ALLOCATION: NEW/DELETE VS ARENA
+// ============================================================================
+
+template<Scalar T>
+void fill_hexagon(Polygon<T>& hexagon, size_t i)
+{
+    for (size_t j = 0; j < 6; ++j)
+    {
+        hexagon.set_vertex(j, Point<T>(static_cast<T>(i + std::cos(j * 1.047)), static_cast<T>(std::sin(j * 1.047))));
+    }
+}
+
+
+static void BM_Frame_NewDelete(benchmark::State& state)
+{
+    const size_t count = state.range(0);
+    size_t allocations = 0;
+
+    for (auto _ : state)
+    {
+        const size_t before = global_allocations.load(std::memory_order_relaxed);
+        {
+            Array<std::shared_ptr<Figure<double>>> figures;
+            for (size_t i = 0; i < count; ++i)
+            {
+                if (i % 2 == 0)
+                {
+                    figures.append(std::make_shared<Rectangle<double>>(make_rectangle<double>(i)));
+                }
+                else
+                {
+                    auto hexagon = std::make_shared<Polygon<double>>(6);
+                    fill_hexagon(*hexagon, i);
+                    figures.append(std::move(hexagon));
+                }
+            }
+            benchmark::DoNotOptimize(figures[count - 1]);
+        }
+        allocations = global_allocations.load(std::memory_order_relaxed) - before;
+    }
+
+    state.counters["allocations_per_frame"] = static_cast<double>(allocations);
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_Frame_NewDelete)->Arg(1000)->Arg(100000);
+
+
+static void BM_Frame_Arena(benchmark::State& state)
+{
+    using FigureArray = Array<std::shared_ptr<Figure<double>>>;
+
+    const size_t count = state.range(0);
+    CountingResource upstream;
+    FrameArena arena(1 << 20, &upstream);
+    size_t allocations = 0;
+
+    for (auto _ : state)
+    {
+        const size_t before = global_allocations.load(std::memory_order_relaxed) + upstream.allocation_count();
+
+        // Весь кадр живет в арене, поэтому деструкторы не вызываются:
+        // reset() освобождает кадр целиком за O(1).
+        FigureArray* figures = new (arena.allocate(sizeof(FigureArray), alignof(FigureArray))) FigureArray(FigureArray::allocator_type(&arena));
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (i % 2 == 0)
+            {
+                figures->append(std::allocate_shared<Rectangle<double>>(std::pmr::polymorphic_allocator<Rectangle<double>>(&arena), make_rectangle<double>(i)));
+            }
+            else
+            {
+                auto hexagon = std::allocate_shared<Polygon<double>>(std::pmr::polymorphic_allocator<Polygon<double>>(&arena), 6);
+                fill_hexagon(*hexagon, i);
+                figures->append(std::move(hexagon));
+            }
+        }
+        benchmark::DoNotOptimize((*figures)[count - 1]);
+
+        allocations = global_allocations.load(std::memory_order_relaxed) + upstream.allocation_count() - before;
+        arena.reset();
+    }
+
+    state.counters["allocations_per_frame"] = static_cast<double>(allocations);
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_Frame_Arena)->Arg(1000)->Arg(100000);
+
+
+// ============================================================================
+// POLYGON PROPERTY CACHE
+// ============================================================================
+
+static std::vector<Polygon<double>> make_regular_polygons(size_t count, size_t vertices)
+{
+    std::vector<Polygon<double>> polygons;
+    polygons.reserve(count);
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        polygons.push_back(make_regular_polygon<double>(vertices, i, 1.0));
+    }
+
+    return polygons;
+}
+
+
+static void BM_Polygon_RepeatedQueries(benchmark::State& state)
+{
+    std::vector<Polygon<double>> polygons = make_regular_polygons(1000, state.range(0));
+    Polygon<double>::reset_cache_statistics();
+
+    for (auto _ : state)
+    {
+        double total = 0.0;
+        for (const Polygon<double>& polygon : polygons)
+        {
+            total += polygon.area() + static_cast<double>(polygon) + polygon.get_center().x;
+        }
+        benchmark::DoNotOptimize(total);
+    }
+
+    if constexpr (instrumentation_enabled)
+    {
+        CacheStatistics statistics = Polygon<double>::cache_statistics();
+        state.counters["hit_ratio"] = static_cast<double>(statistics.hits) / (statistics.hits + statistics.misses);
+    }
+    state.SetItemsProcessed(state.iterations() * polygons.size());
+}
+BENCHMARK(BM_Polygon_RepeatedQueries)->Arg(4)->Arg(16)->Arg(256);
+
+
+static void BM_Polygon_EditThenQuery(benchmark::State& state)
+{
+    std::vector<Polygon<double>> polygons = make_regular_polygons(1000, state.range(0));
+    Polygon<double>::reset_cache_statistics();
+
+    for (auto _ : state)
+    {
+        double total = 0.0;
+        for (Polygon<double>& polygon : polygons)
+        {
+            polygon.set_vertex(0, polygon.get_vertex(0));
+            total += polygon.area() + static_cast<double>(polygon) + polygon.get_center().x;
+        }
+        benchmark::DoNotOptimize(total);
+    }
+
+    if constexpr (instrumentation_enabled)
+    {
+        CacheStatistics statistics = Polygon<double>::cache_statistics();
+        state.counters["hit_ratio"] = static_cast<double>(statistics.hits) / (statistics.hits + statistics.misses);
+    }
+    state.SetItemsProcessed(state.iterations() * polygons.size());
+}
+BENCHMARK(BM_Polygon_EditThenQuery)->Arg(4)->Arg(16)->Arg(256);
+
+
+// ============================================================================
+// PARALLEL REDUCTIONS
+// ============================================================================
+
+static void BM_Array_ParallelTotalArea(benchmark::State& state)
+{
+    const size_t count = state.range(0);
+    Array<Rectangle<double>> rectangles(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        rectangles.append(make_rectangle<double>(i));
+    }
+
+    ThreadPool pool(state.range(1));
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(rectangles.area_statistics(pool));
+    }
+
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_Array_ParallelTotalArea)->ArgsProduct({{100000, 10000000}, {0, 1, 2, 4}})->Unit(benchmark::kMillisecond)->UseRealTime();
+
+
+// ============================================================================
+// ARRAY: PURGING HALF OF THE ELEMENTS
+// ============================================================================
+
+static Array<std::shared_ptr<Figure<double>>> make_shared_figures(size_t count)
+{
+    Array<std::shared_ptr<Figure<double>>> figures(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        figures.append(std::make_shared<Rectangle<double>>(make_rectangle<double>(i)));
+    }
+
+    return figures;
+}
+
+
+static bool is_odd_figure(const std::shared_ptr<Figure<double>>& figure)
+{
+    return static_cast<long long>(figure->get_center().x) % 2 != 0;
+}
+
+
+static void BM_Array_PurgeHalf_Remove(benchmark::State& state)
+{
+    const Array<std::shared_ptr<Figure<double>>> source = make_shared_figures(state.range(0));
+
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        Array<std::shared_ptr<Figure<double>>> figures = source;
+        state.ResumeTiming();
+
+        for (size_t i = 0; i < figures.get_size();)
+        {
+            if (is_odd_figure(figures[i]))
+            {
+                figures.remove(i);
+            }
+            else
+            {
+                ++i;
+            }
+        }
+        benchmark::DoNotOptimize(figures.get_size());
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_Array_PurgeHalf_Remove)->Arg(10000)->Arg(100000)->Unit(benchmark::kMillisecond);
+
+
+static void BM_Array_PurgeHalf_SwapRemove(benchmark::State& state)
+{
+    const Array<std::shared_ptr<Figure<double>>> source = make_shared_figures(state.range(0));
+
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        Array<std::shared_ptr<Figure<double>>> figures = source;
+        state.ResumeTiming();
+
+        for (size_t i = 0; i < figures.get_size();)
+        {
+            if (is_odd_figure(figures[i]))
+            {
+                figures.swap_remove(i);
+            }
+            else
+            {
+                ++i;
+            }
+        }
+        benchmark::DoNotOptimize(figures.get_size());
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_Array_PurgeHalf_SwapRemove)->Arg(10000)->Arg(100000)->Arg(1000000)->Unit(benchmark::kMillisecond);
+
+
+static void BM_Array_PurgeHalf_EraseIf(benchmark::State& state)
+{
+    const Array<std::shared_ptr<Figure<double>>> source = make_shared_figures(state.range(0));
+
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        Array<std::shared_ptr<Figure<double>>> figures = source;
+        state.ResumeTiming();
+
+        benchmark::DoNotOptimize(figures.erase_if(is_odd_figure));
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_Array_PurgeHalf_EraseIf)->Arg(10000)->Arg(100000)->Arg(1000000)->Unit(benchmark::kMillisecond);
+
+
+// ============================================================================
+// ARRAY: GROWTH POLICY
+// ============================================================================
+
+// Второй аргумент - коэффициент роста, умноженный на 10
+static void BM_Array_AppendPolygons(benchmark::State& state)
+{
+    const size_t count = state.range(0);
+    const Polygon<double> octagon = make_regular_polygon<double>(8);
+
+    for (auto _ : state)
+    {
+        Array<Polygon<double>> polygons;
+        polygons.set_growth_factor(state.range(1) / 10.0);
+        for (size_t i = 0; i < count; ++i)
+        {
+            polygons.append(octagon);
+        }
+        benchmark::DoNotOptimize(polygons.get_size());
+    }
+
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_Array_AppendPolygons)->ArgsProduct({{1000, 100000}, {15, 20}})->Unit(benchmark::kMicrosecond);
+
+
+static void BM_Array_EmplacePolygons(benchmark::State& state)
+{
+    const size_t count = state.range(0);
+
+    for (auto _ : state)
+    {
+        Array<Polygon<double>> polygons;
+        polygons.reserve(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            polygons.emplace_back(8);
+        }
+        benchmark::DoNotOptimize(polygons.get_size());
+    }
+
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_Array_EmplacePolygons)->Arg(1000)->Arg(100000)->Unit(benchmark::kMicrosecond);
+
+
+// ============================================================================
+// SCENE LOADING: TEXT VS MEMORY-MAPPED BINARY
+// ============================================================================
+
+static std::string make_scene_files(size_t count)
+{
+    const std::string base = (std::filesystem::temp_directory_path() / ("bench_scene_" + std::to_string(count))).string();
+
+    if (!std::filesystem::exists(base + ".bin"))
+    {
+        FigureStore<double> store;
+        for (size_t i = 0; i < count; ++i)
+        {
+            store.append(make_rectangle<double>(i));
+        }
+
+        std::ofstream text(base + ".txt");
+        write_scene_text(store, text);
+        save_scene(store, base + ".bin");
+    }
+
+    return base;
+}
+
+
+static void BM_Scene_LoadText(benchmark::State& state)
+{
+    const std::string path = make_scene_files(state.range(0)) + ".txt";
+
+    for (auto _ : state)
+    {
+        std::ifstream istream(path);
+        benchmark::DoNotOptimize(read_scene_text<double>(istream).total_area());
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.SetBytesProcessed(state.iterations() * std::filesystem::file_size(path));
+}
+BENCHMARK(BM_Scene_LoadText)->Arg(100000)->Arg(1000000)->Unit(benchmark::kMillisecond);
+
+
+static void BM_Scene_LoadBinary(benchmark::State& state)
+{
+    const std::string path = make_scene_files(state.range(0)) + ".bin";
+
+    for (auto _ : state)
+    {
+        SceneFile<double> scene(path);
+        benchmark::DoNotOptimize(scene.view().total_area());
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.SetBytesProcessed(state.iterations() * std::filesystem::file_size(path));
+}
+BENCHMARK(BM_Scene_LoadBinary)->Arg(100000)->Arg(1000000)->Unit(benchmark::kMillisecond);
+
+
+// ============================================================================
+// VIRTUAL VS VARIANT DISPATCH
+// ============================================================================
+
+static std::shared_ptr<Figure<double>> make_mixed_figure(size_t i)
+{
+    switch (i % 4)
+    {
+        case 0: return std::make_shared<Polygon<double>>(make_regular_polygon<double>(5, i % 1000));
+        case 1: return std::make_shared<Rectangle<double>>(make_quad<Rectangle, double>(i));
+        case 2: return std::make_shared<Rhombus<double>>(make_quad<Rhombus, double>(i));
+        default: return std::make_shared<Trapezoid<double>>(make_quad<Trapezoid, double>(i));
+    }
+}
+
+
+static void BM_Dispatch_Virtual(benchmark::State& state)
+{
+    const size_t count = state.range(0);
+    Array<std::shared_ptr<Figure<double>>> figures(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        figures.append(make_mixed_figure(i));
+    }
+
+    for (auto _ : state)
+    {
+        double total = 0.0;
+        for (size_t i = 0; i < count; ++i)
+        {
+            total += figures[i]->area() + figures[i]->get_center().x;
+        }
+        benchmark::DoNotOptimize(total);
+    }
+
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_Dispatch_Virtual)->Arg(1000000)->Unit(benchmark::kMillisecond);
+
+
+static void BM_Dispatch_Variant(benchmark::State& state)
+{
+    const size_t count = state.range(0);
+    Array<FigureVariant<double>> figures(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        figures.emplace_back(FigureVariant<double>::from_figure(*make_mixed_figure(i)));
+    }
+
+    for (auto _ : state)
+    {
+        double total = 0.0;
+        for (size_t i = 0; i < count; ++i)
+        {
+            total += figures[i].area() + figures[i].get_center().x;
+        }
+        benchmark::DoNotOptimize(total);
+    }
+
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_Dispatch_Variant)->Arg(1000000)->Unit(benchmark::kMillisecond);
+
+
+// ============================================================================
+// QUADRILATERALS: CLOSED-FORM KERNELS VS GENERIC POLYGON
+// ============================================================================
+
+template<Scalar T>
+static void BM_Quad_AreaGeneric(benchmark::State& state)
+{
+    Polygon<T> polygon(make_rectangle<T>(state.range(0)));
+    const Point<T> first = polygon.get_vertex(0);
+
+    for (auto _ : state)
+    {
+        polygon.set_vertex(0, first);
+        benchmark::DoNotOptimize(polygon.area() + polygon.get_center().x);
+    }
+}
+BENCHMARK(BM_Quad_AreaGeneric<int>)->Arg(12345);
+BENCHMARK(BM_Quad_AreaGeneric<float>)->Arg(12345);
+BENCHMARK(BM_Quad_AreaGeneric<double>)->Arg(12345);
+
+
+template<template<Scalar> class F, Scalar T>
+static void BM_Quad_AreaClosedForm(benchmark::State& state)
+{
+    F<T> figure = make_quad<F, T>(state.range(0));
+    const Point<T> first = figure.get_vertex(0);
+
+    for (auto _ : state)
+    {
+        figure.set_vertex(0, first);
+        benchmark::DoNotOptimize(figure.area() + figure.get_center().x);
+    }
+}
+BENCHMARK(BM_Quad_AreaClosedForm<Rectangle, int>)->Arg(12345);
+BENCHMARK(BM_Quad_AreaClosedForm<Rectangle, float>)->Arg(12345);
+BENCHMARK(BM_Quad_AreaClosedForm<Rectangle, double>)->Arg(12345);
+BENCHMARK(BM_Quad_AreaClosedForm<Rhombus, double>)->Arg(12345);
+BENCHMARK(BM_Quad_AreaClosedForm<Trapezoid, double>)->Arg(12345);
+
+
+// ============================================================================
+// SPATIAL INDEX: R-TREE AND UNIFORM GRID VS LINEAR SCAN
+// ============================================================================
+
+// Сетка 1000 x 1000 перекрывающихся прямоугольников; строится один раз.
+static Array<Rectangle<double>>& spatial_figures(size_t count)
+{
+    static Array<Rectangle<double>> figures;
+
+    if (figures.get_size() != count)
+    {
+        figures = Array<Rectangle<double>>(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            figures.emplace_back(make_rectangle<double>(i));
+        }
+    }
+
+    return figures;
+}
+
+
+static Point<double> spatial_query_point(size_t i, size_t count)
+{
+    const double side = std::sqrt(static_cast<double>(count));
+    return Point<double>(std::fmod(i * 7919.0, side) + 0.5, std::fmod(i * 104729.0, side) + 0.3);
+}
+
+
+template<SpatialIndexKind Kind>
+static void BM_Spatial_Build(benchmark::State& state)
+{
+    const auto& figures = spatial_figures(state.range(0));
+
+    for (auto _ : state)
+    {
+        SpatialIndex<double, Rectangle<double>> index(figures, Kind);
+        benchmark::DoNotOptimize(index.get_size());
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_Spatial_Build<SpatialIndexKind::RTree>)->Arg(1000000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_Spatial_Build<SpatialIndexKind::Grid>)->Arg(1000000)->Unit(benchmark::kMillisecond);
+
+
+template<SpatialIndexKind Kind>
+static void BM_Spatial_RangeQuery(benchmark::State& state)
+{
+    const auto& figures = spatial_figures(state.range(0));
+    const SpatialIndex<double, Rectangle<double>> index(figures, Kind);
+    size_t i = 0;
+
+    for (auto _ : state)
+    {
+        const Point<double> point = spatial_query_point(i++, state.range(0));
+        const BoundingBox<double> box(point, Point<double>(point.x + 10.0, point.y + 10.0));
+        benchmark::DoNotOptimize(index.query_range(box));
+    }
+}
+BENCHMARK(BM_Spatial_RangeQuery<SpatialIndexKind::RTree>)->Arg(1000000);
+BENCHMARK(BM_Spatial_RangeQuery<SpatialIndexKind::Grid>)->Arg(1000000);
+
+
+template<SpatialIndexKind Kind>
+static void BM_Spatial_PointQuery(benchmark::State& state)
+{
+    const auto& figures = spatial_figures(state.range(0));
+    const SpatialIndex<double, Rectangle<double>> index(figures, Kind);
+    size_t i = 0;
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(index.query_point(spatial_query_point(i++, state.range(0))));
+    }
+}
+BENCHMARK(BM_Spatial_PointQuery<SpatialIndexKind::RTree>)->Arg(1000000);
+BENCHMARK(BM_Spatial_PointQuery<SpatialIndexKind::Grid>)->Arg(1000000);
+
+
+template<SpatialIndexKind Kind>
+static void BM_Spatial_Nearest(benchmark::State& state)
+{
+    const auto& figures = spatial_figures(state.range(0));
+    const SpatialIndex<double, Rectangle<double>> index(figures, Kind);
+    size_t i = 0;
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(index.nearest(spatial_query_point(i++, state.range(0)), 10));
+    }
+}
+BENCHMARK(BM_Spatial_Nearest<SpatialIndexKind::RTree>)->Arg(1000000);
+BENCHMARK(BM_Spatial_Nearest<SpatialIndexKind::Grid>)->Arg(1000000);
+
+
+template<SpatialIndexKind Kind>
+static void BM_Spatial_Update(benchmark::State& state)
+{
+    const auto& figures = spatial_figures(state.range(0));
+    SpatialIndex<double, Rectangle<double>> index(figures, Kind);
+    size_t i = 0;
+
+    for (auto _ : state)
+    {
+        index.update((i++ * 7919) % state.range(0));
+    }
+}
+BENCHMARK(BM_Spatial_Update<SpatialIndexKind::RTree>)->Arg(1000000);
+BENCHMARK(BM_Spatial_Update<SpatialIndexKind::Grid>)->Arg(1000000);
+
+
+// То, что было до индекса: проверка каждой фигуры.
+static void BM_Spatial_LinearPointScan(benchmark::State& state)
+{
+    Array<Rectangle<double>>& figures = spatial_figures(state.range(0));
+    size_t i = 0;
+
+    for (auto _ : state)
+    {
+        const Point<double> point = spatial_query_point(i++, state.range(0));
+        std::vector<size_t> ids;
+        for (size_t j = 0; j < figures.get_size(); ++j)
+        {
+            if (figures[j].contains(point))
+            {
+                ids.push_back(j);
+            }
+        }
+        benchmark::DoNotOptimize(ids);
+    }
+}
+BENCHMARK(BM_Spatial_LinearPointScan)->Arg(1000000)->Unit(benchmark::kMillisecond);
+
+
+// ============================================================================
+// STREAMING READER VS OPERATOR>>
+// ============================================================================
+
+// Прежний путь: имя и число вершин через >>, затем operator>> многоугольника.
+static void BM_Stream_OperatorRead(benchmark::State& state)
+{
+    const std::string path = make_scene_files(state.range(0)) + ".txt";
+
+    for (auto _ : state)
+    {
+        std::ifstream file(path);
+        std::string name;
+        size_t count = 0;
+        double total = 0.0;
+
+        while (file >> name >> count)
+        {
+            Polygon<double> polygon(count);
+            file >> polygon;
+            total += polygon.area();
+        }
+        benchmark::DoNotOptimize(total);
+    }
+
+    state.SetBytesProcessed(state.iterations() * std::filesystem::file_size(path));
+}
+BENCHMARK(BM_Stream_OperatorRead)->Arg(1000000)->Unit(benchmark::kMillisecond);
+
+
+static void BM_Stream_Reader(benchmark::State& state)
+{
+    const std::string path = make_scene_files(state.range(0)) + ".txt";
+
+    for (auto _ : state)
+    {
+        std::ifstream file(path, std::ios::binary);
+        AreaHistogram histogram(0.0, 50.0, 10);
+        benchmark::DoNotOptimize(stream_area_statistics<double>(file, &histogram));
+    }
+
+    state.SetBytesProcessed(state.iterations() * std::filesystem::file_size(path));
+}
+BENCHMARK(BM_Stream_Reader)->Arg(1000000)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+
+// ============================================================================
+// PREDICATES
+// ============================================================================
+
+static std::vector<Point<double>> make_query_points(size_t count)
+{
+    std::vector<Point<double>> points(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        points[i] = Point<double>(static_cast<double>(i % 997) / 4.0 - 125.0, static_cast<double>(i % 991) / 4.0 - 125.0);
+    }
+    return points;
+}
+
+
+static void BM_Predicates_Contains(benchmark::State& state)
+{
+    const Polygon<double> polygon = make_regular_polygon<double>(state.range(0));
+    const std::vector<Point<double>> points = make_query_points(1 << 16);
+    std::vector<unsigned char> inside(points.size());
+
+    for (auto _ : state)
+    {
+        for (size_t i = 0; i < points.size(); ++i)
+        {
+            inside[i] = polygon.contains(points[i]);
+        }
+        benchmark::DoNotOptimize(inside.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * points.size());
+}
+BENCHMARK(BM_Predicates_Contains)->Arg(4)->Arg(16)->Arg(64);
+
+
+static void BM_Predicates_ContainsBatch(benchmark::State& state)
+{
+    const SimdLevel level = static_cast<SimdLevel>(state.range(1));
+    if (static_cast<int>(level) > static_cast<int>(detect_simd_level()))
+    {
+        state.SkipWithError("SIMD level is not supported by this CPU");
+        return;
+    }
+
+    const Polygon<double> polygon = make_regular_polygon<double>(state.range(0));
+    const std::vector<Point<double>> points = make_query_points(1 << 16);
+    std::vector<unsigned char> inside(points.size());
+
+    const SimdLevel previous = get_simd_level();
+    set_simd_level(level);
+    for (auto _ : state)
+    {
+        contains_batch(polygon, std::span<const Point<double>>(points), std::span<unsigned char>(inside));
+        benchmark::DoNotOptimize(inside.data());
+    }
+    set_simd_level(previous);
+
+    state.SetItemsProcessed(state.iterations() * points.size());
+}
+BENCHMARK(BM_Predicates_ContainsBatch)->ArgsProduct({{4, 16, 64}, {0, 1, 2}});
+
+
+static void BM_Predicates_Intersects(benchmark::State& state)
+{
+    const Polygon<double> first = make_regular_polygon<double>(state.range(0));
+    Polygon<double> second = make_regular_polygon<double>(state.range(0));
+    for (size_t i = 0; i < second.vertex_count(); ++i)
+    {
+        const Point<double> vertex = second.get_vertex(i);
+        second.set_vertex(i, Point<double>(vertex.x + 150.0, vertex.y + 50.0));
+    }
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(first.intersects(second));
+    }
+}
+BENCHMARK(BM_Predicates_Intersects)->Arg(4)->Arg(16)->Arg(64);
+
+
+// ============================================================================
+// ARITHMETIC POLICIES
+// ============================================================================
+
+// Площадь без кэша: set_vertex сбрасывает кэш перед каждым вызовом.
+template<Scalar T, ArithmeticPolicy Policy>
+static void BM_Arithmetic_Area(benchmark::State& state)
+{
+    const Polygon<T> source = make_regular_polygon<T>(state.range(0));
+    Polygon<T, Policy> polygon(source.vertex_count());
+    for (size_t i = 0; i < source.vertex_count(); ++i)
+    {
+        polygon.set_vertex(i, source.get_vertex(i));
+    }
+    const Point<T> first = polygon.get_vertex(0);
+
+    for (auto _ : state)
+    {
+        polygon.set_vertex(0, first);
+        benchmark::DoNotOptimize(polygon.area());
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_Arithmetic_Area<int, FastArithmetic>)->Arg(4)->Arg(64)->Arg(4096);
+BENCHMARK(BM_Arithmetic_Area<int, RobustArithmetic>)->Arg(4)->Arg(64)->Arg(4096);
+BENCHMARK(BM_Arithmetic_Area<double, FastArithmetic>)->Arg(4)->Arg(64)->Arg(4096);
+BENCHMARK(BM_Arithmetic_Area<double, RobustArithmetic>)->Arg(4)->Arg(64)->Arg(4096);
+
+
+// Ориентация тройки: state.range(0) = 1 - почти коллинеарные точки,
+// для которых адаптивный предикат уходит в точный пересчет.
+template<Scalar T, ArithmeticPolicy Policy>
+static void BM_Arithmetic_Orientation(benchmark::State& state)
+{
+    const bool degenerate = state.range(0) != 0;
+    std::vector<Point<T>> points(1024);
+    for (size_t i = 0; i < points.size(); ++i)
+    {
+        const double t = static_cast<double>(i) / 7.0;
+        points[i] = degenerate ? Point<T>(static_cast<T>(t), static_cast<T>(t))
+                               : Point<T>(static_cast<T>(std::cos(t) * 1000.0), static_cast<T>(std::sin(t * 1.3) * 1000.0));
+    }
+
+    for (auto _ : state)
+    {
+        int sum = 0;
+        for (size_t i = 0; i + 2 < points.size(); ++i)
+        {
+            sum += Policy::orientation(points[i], points[i + 1], points[i + 2]);
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+
+    state.SetItemsProcessed(state.iterations() * (points.size() - 2));
+}
+BENCHMARK(BM_Arithmetic_Orientation<int, FastArithmetic>)->Arg(0);
+BENCHMARK(BM_Arithmetic_Orientation<int, RobustArithmetic>)->Arg(0);
+BENCHMARK(BM_Arithmetic_Orientation<double, FastArithmetic>)->Arg(0)->Arg(1);
+BENCHMARK(BM_Arithmetic_Orientation<double, RobustArithmetic>)->Arg(0)->Arg(1);
+
+
+template<ArithmeticPolicy Policy>
+static void BM_Arithmetic_Contains(benchmark::State& state)
+{
+    const Polygon<double> source = make_regular_polygon<double>(state.range(0));
+    Polygon<double, Policy> polygon(source.vertex_count());
+    for (size_t i = 0; i < source.vertex_count(); ++i)
+    {
+        polygon.set_vertex(i, source.get_vertex(i));
+    }
+    const std::vector<Point<double>> points = make_query_points(1 << 12);
+
+    for (auto _ : state)
+    {
+        size_t inside = 0;
+        for (const Point<double>& point : points)
+        {
+            inside += polygon.contains(point);
+        }
+        benchmark::DoNotOptimize(inside);
+    }
+
+    state.SetItemsProcessed(state.iterations() * points.size());
+}
+BENCHMARK(BM_Arithmetic_Contains<FastArithmetic>)->Arg(16);
+BENCHMARK(BM_Arithmetic_Contains<RobustArithmetic>)->Arg(16);
+
+
+// ============================================================================
+// ARRAY SNAPSHOTS
+// ============================================================================
+
+static Array<Polygon<double>> make_report_figures(size_t count)
+{
+    Array<Polygon<double>> figures;
+    figures.reserve(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        figures.append(make_regular_polygon<double>(6, static_cast<double>(i)));
+    }
+    return figures;
+}
+
+
+// Полная копия: так выглядел снимок до копирования при записи.
+static void BM_Array_DeepCopy(benchmark::State& state)
+{
+    const Array<Polygon<double>> figures = make_report_figures(state.range(0));
+    std::pmr::unsynchronized_pool_resource pool;
+
+    for (auto _ : state)
+    {
+        Array<Polygon<double>> copy(figures, Array<Polygon<double>>::allocator_type(&pool));
+        benchmark::DoNotOptimize(copy.get_size());
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_Array_DeepCopy)->Arg(1000)->Arg(100000)->Unit(benchmark::kMicrosecond);
+
+
+static void BM_Array_Snapshot(benchmark::State& state)
+{
+    const Array<Polygon<double>> figures = make_report_figures(state.range(0));
+
+    for (auto _ : state)
+    {
+        const Array<Polygon<double>> snapshot = figures.snapshot();
+        benchmark::DoNotOptimize(snapshot.get_size());
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_Array_Snapshot)->Arg(1000)->Arg(100000)->Unit(benchmark::kMicrosecond);
+
+
+// Писатель после каждого снимка меняет одну фигуру: первая запись
+// копирует хранилище, поэтому стоимость переезжает из снимка в нее.
+static void BM_Array_SnapshotThenWrite(benchmark::State& state)
+{
+    Array<Polygon<double>> figures = make_report_figures(state.range(0));
+    const Point<double> vertex = figures[0].get_vertex(0);
+
+    for (auto _ : state)
+    {
+        const Array<Polygon<double>> snapshot = figures.snapshot();
+        figures[0].set_vertex(0, vertex);
+        benchmark::DoNotOptimize(snapshot.get_size());
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_Array_SnapshotThenWrite)->Arg(1000)->Arg(100000)->Unit(benchmark::kMicrosecond);
+
+
+// ============================================================================
+// CONCURRENT ARRAY
+// ============================================================================
+
+constexpr size_t ingest_points_per_producer = 1 << 16;
+
+
+// Прежний способ: Array под общим мьютексом.
+static void BM_Ingest_MutexArray(benchmark::State& state)
+{
+    const size_t producers = state.range(0);
+
+    for (auto _ : state)
+    {
+        Array<Point<double>> points;
+        std::mutex mutex;
+        std::vector<std::thread> threads;
+
+        for (size_t producer = 0; producer < producers; ++producer)
+        {
+            threads.emplace_back([&points, &mutex, producer]
+            {
+                for (size_t i = 0; i < ingest_points_per_producer; ++i)
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    points.append(Point<double>(static_cast<double>(producer), static_cast<double>(i)));
+                }
+            });
+        }
+        for (std::thread& thread : threads)
+        {
+            thread.join();
+        }
+        benchmark::DoNotOptimize(points.get_size());
+    }
+
+    state.SetItemsProcessed(state.iterations() * producers * ingest_points_per_producer);
+}
+BENCHMARK(BM_Ingest_MutexArray)->RangeMultiplier(2)->Range(1, 32)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+
+static void BM_Ingest_ConcurrentArray(benchmark::State& state)
+{
+    const size_t producers = state.range(0);
+
+    for (auto _ : state)
+    {
+        ConcurrentArray<Point<double>> points;
+        std::vector<std::thread> threads;
+
+        for (size_t producer = 0; producer < producers; ++producer)
+        {
+            threads.emplace_back([&points, producer]
+            {
+                for (size_t i = 0; i < ingest_points_per_producer; ++i)
+                {
+                    points.append(Point<double>(static_cast<double>(producer), static_cast<double>(i)));
+                }
+            });
+        }
+        for (std::thread& thread : threads)
+        {
+            thread.join();
+        }
+        benchmark::DoNotOptimize(points.get_size());
+    }
+
+    state.SetItemsProcessed(state.iterations() * producers * ingest_points_per_producer);
+}
+BENCHMARK(BM_Ingest_ConcurrentArray)->RangeMultiplier(2)->Range(1, 32)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+
+// Последовательный обход после загрузки: по сегментам и по индексу.
+static void BM_ConcurrentArray_ForEach(benchmark::State& state)
+{
+    ConcurrentArray<Point<double>> points;
+    for (size_t i = 0; i < static_cast<size_t>(state.range(0)); ++i)
+    {
+        points.append(Point<double>(static_cast<double>(i), 1.0));
+    }
+    if (state.range(1))
+    {
+        points.compact();
+    }
+
+    for (auto _ : state)
+    {
+        double sum = 0.0;
+        points.for_each([&](const Point<double>& point) { sum += point.x; });
+        benchmark::DoNotOptimize(sum);
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ConcurrentArray_ForEach)->Args({1 << 20, 0})->Args({1 << 20, 1});
+
+
+static void BM_ConcurrentArray_Index(benchmark::State& state)
+{
+    ConcurrentArray<Point<double>> points;
+    for (size_t i = 0; i < static_cast<size_t>(state.range(0)); ++i)
+    {
+        points.append(Point<double>(static_cast<double>(i), 1.0));
+    }
+
+    for (auto _ : state)
+    {
+        double sum = 0.0;
+        for (size_t i = 0; i < points.get_size(); ++i)
+        {
+            sum += points[i].x;
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ConcurrentArray_Index)->Arg(1 << 20);
+
+
+// ============================================================================
+// ARRAY: CONST ACCESS
+// ============================================================================
+
+// Чтение через const-ссылку; копия в теле цикла повторяет прежний
+// operator[] const, который возвращал элемент по значению.
+template<bool Copy>
+static void BM_Array_ConstReadPolygons(benchmark::State& state)
+{
+    const Array<Polygon<double>> figures = make_report_figures(state.range(0));
+
+    for (auto _ : state)
+    {
+        size_t vertices = 0;
+        for (size_t i = 0; i < figures.get_size(); ++i)
+        {
+            if constexpr (Copy)
+            {
+                const Polygon<double> figure = figures[i];
+                vertices += figure.vertex_count();
+            }
+            else
+            {
+                vertices += figures[i].vertex_count();
+            }
+        }
+        benchmark::DoNotOptimize(vertices);
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_Array_ConstReadPolygons<true>)->Arg(100000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_Array_ConstReadPolygons<false>)->Arg(100000)->Unit(benchmark::kMicrosecond);
+
+
+template<bool Copy>
+static void BM_Array_ConstReadShared(benchmark::State& state)
+{
+    const Array<std::shared_ptr<Figure<double>>> figures = make_shared_figures(state.range(0));
+
+    for (auto _ : state)
+    {
+        double sum = 0.0;
+        for (size_t i = 0; i < figures.get_size(); ++i)
+        {
+            if constexpr (Copy)
+            {
+                const std::shared_ptr<Figure<double>> figure = figures[i];
+                sum += figure->get_center().x;
+            }
+            else
+            {
+                sum += figures[i]->get_center().x;
+            }
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_Array_ConstReadShared<true>)->Arg(100000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_Array_ConstReadShared<false>)->Arg(100000)->Unit(benchmark::kMicrosecond);
+
+
+static void BM_Array_RangesSort(benchmark::State& state)
+{
+    Array<double> values;
+    for (size_t i = 0; i < static_cast<size_t>(state.range(0)); ++i)
+    {
+        values.append(static_cast<double>((i * 2654435761u) % state.range(0)));
+    }
+
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        Array<double> unsorted = values;
+        state.ResumeTiming();
+        std::ranges::sort(unsorted);
+        benchmark::DoNotOptimize(unsorted.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_Array_RangesSort)->Arg(100000)->Unit(benchmark::kMicrosecond);
+
+
+// ============================================================================
+// CONSTEXPR GEOMETRY
+// ============================================================================
+
+// Point тривиально копируется, поэтому копия вектора вершин - один memmove.
+static void BM_Point_VectorCopy(benchmark::State& state)
+{
+    std::vector<Point<double>> source(state.range(0));
+    for (size_t i = 0; i < source.size(); ++i)
+    {
+        source[i] = Point<double>(static_cast<double>(i), 1.0);
+    }
+
+    for (auto _ : state)
+    {
+        std::vector<Point<double>> copy = source;
+        benchmark::DoNotOptimize(copy.data());
+    }
+
+    state.SetBytesProcessed(state.iterations() * state.range(0) * sizeof(Point<double>));
+}
+BENCHMARK(BM_Point_VectorCopy)->Arg(1 << 20)->Unit(benchmark::kMicrosecond);
+
+
+// Сдвинутый трафарет 4x3: площадь небольшой фигуры без кучи и с ней.
+static void BM_StaticPolygon_StencilArea(benchmark::State& state)
+{
+    int offset = 0;
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(offset);
+        const StaticPolygon stencil(Point<int>(offset, 0), Point<int>(offset + 4, 0), Point<int>(offset + 4, 3), Point<int>(offset, 3));
+        benchmark::DoNotOptimize(stencil.area());
+        ++offset;
+    }
+}
+BENCHMARK(BM_StaticPolygon_StencilArea);
+
+
+static void BM_Polygon_StencilArea(benchmark::State& state)
+{
+    int offset = 0;
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(offset);
+        Polygon<int> stencil(4);
+        stencil.set_vertex(0, Point<int>(offset, 0));
+        stencil.set_vertex(1, Point<int>(offset + 4, 0));
+        stencil.set_vertex(2, Point<int>(offset + 4, 3));
+        stencil.set_vertex(3, Point<int>(offset, 3));
+        benchmark::DoNotOptimize(stencil.area());
+        ++offset;
+    }
+}
+BENCHMARK(BM_Polygon_StencilArea);
+
+
+// ============================================================================
+// BITWISE COPIES OF POINTS
+// ============================================================================
+
+template<Scalar T>
+static void BM_Polygon_CopyConstruct(benchmark::State& state)
+{
+    const Polygon<T> source = make_regular_polygon<T>(state.range(0));
+
+    for (auto _ : state)
+    {
+        Polygon<T> copy(source);
+        benchmark::DoNotOptimize(copy.get_vertex(0));
+    }
+
+    state.SetBytesProcessed(state.iterations() * state.range(0) * sizeof(Point<T>));
+}
+BENCHMARK(BM_Polygon_CopyConstruct<int>)->Arg(1 << 20)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_Polygon_CopyConstruct<double>)->Arg(1 << 20)->Unit(benchmark::kMicrosecond);
+
+
+template<Scalar T>
+static void BM_Polygon_CopyAssign(benchmark::State& state)
+{
+    const Polygon<T> source = make_regular_polygon<T>(state.range(0));
+    Polygon<T> target(state.range(0));
+
+    for (auto _ : state)
+    {
+        target = source;
+        benchmark::DoNotOptimize(target.get_vertex(0));
+    }
+
+    state.SetBytesProcessed(state.iterations() * state.range(0) * sizeof(Point<T>));
+}
+BENCHMARK(BM_Polygon_CopyAssign<int>)->Arg(1 << 20)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_Polygon_CopyAssign<double>)->Arg(1 << 20)->Unit(benchmark::kMicrosecond);
+
+
+// Рост без reserve: каждый переезд хранилища - копия всех точек.
+static void BM_Array_GrowPoints(benchmark::State& state)
+{
+    for (auto _ : state)
+    {
+        Array<Point<double>> points;
+        for (size_t i = 0; i < static_cast<size_t>(state.range(0)); ++i)
+        {
+            points.append(Point<double>(static_cast<double>(i), 1.0));
+        }
+        benchmark::DoNotOptimize(points.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_Array_GrowPoints)->Arg(1 << 20)->Unit(benchmark::kMicrosecond);
+
+
+// Удаление первой точки сдвигает все остальные.
+static void BM_Array_RemoveFrontPoints(benchmark::State& state)
+{
+    Array<Point<double>> points;
+    for (size_t i = 0; i < static_cast<size_t>(state.range(0)); ++i)
+    {
+        points.append(Point<double>(static_cast<double>(i), 1.0));
+    }
+
+    for (auto _ : state)
+    {
+        points.remove(0);
+        points.append(Point<double>(0.0, 1.0));
+        benchmark::DoNotOptimize(points.data());
+    }
+
+    state.SetBytesProcessed(state.iterations() * state.range(0) * sizeof(Point<double>));
+}
+BENCHMARK(BM_Array_RemoveFrontPoints)->Arg(1 << 20)->Unit(benchmark::kMicrosecond);
+
+
+// Копия в другой ресурс памяти не делит хранилище, а копирует точки.
+static void BM_Array_CopyPointsAcrossResources(benchmark::State& state)
+{
+    Array<Point<double>> points;
+    for (size_t i = 0; i < static_cast<size_t>(state.range(0)); ++i)
+    {
+        points.append(Point<double>(static_cast<double>(i), 1.0));
+    }
+
+    for (auto _ : state)
+    {
+        Array<Point<double>> copy(points, Array<Point<double>>::allocator_type(std::pmr::new_delete_resource()));
+        benchmark::DoNotOptimize(copy.data());
+    }
+
+    state.SetBytesProcessed(state.iterations() * state.range(0) * sizeof(Point<double>));
+}
+BENCHMARK(BM_Array_CopyPointsAcrossResources)->Arg(1 << 20)->Unit(benchmark::kMicrosecond);
+
+
+// ============================================================================
+// INSTRUMENTATION
+// ============================================================================
+
+// Цена одной записи при включенном GEOMETRY_INSTRUMENTATION (без замера
+// времени); в обычной сборке горячие пути ее не платят вовсе.
+static void BM_Instrumentation_Record(benchmark::State& state)
+{
+    uint64_t nanoseconds = 0;
+
+    for (auto _ : state)
+    {
+        Instrumentation::record(InstrumentedOperation::ArrayShift, 1, nanoseconds++ & 1023);
+    }
+
+    Instrumentation::reset();
+}
+BENCHMARK(BM_Instrumentation_Record);
+
+
+static void BM_Instrumentation_Scope(benchmark::State& state)
+{
+    for (auto _ : state)
+    {
+        InstrumentationScope scope(InstrumentedOperation::ArrayShift, 1);
+    }
+
+    Instrumentation::reset();
+}
+BENCHMARK(BM_Instrumentation_Scope);
+
+
+// ============================================================================
+// BATCH CONSTRUCTION
+// ============================================================================
+
+static std::vector<double> make_rectangle_coordinates(size_t count)
+{
+    std::vector<double> coordinates;
+    coordinates.reserve(count * 8);
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        const double x = static_cast<double>(i % 1000);
+        const double y = static_cast<double>(i / 1000);
+        coordinates.insert(coordinates.end(), {x, y, x + 0.5, y, x + 0.5, y + 0.5, x, y + 0.5});
+    }
+
+    return coordinates;
+}
+
+
+// Прежний путь загрузчиков: пустой прямоугольник и четыре set_vertex.
+static void BM_Rectangle_SetVertices(benchmark::State& state)
+{
+    const std::vector<double> coordinates = make_rectangle_coordinates(1024);
+
+    for (auto _ : state)
+    {
+        for (size_t i = 0; i < 1024; ++i)
+        {
+            const double* figure = coordinates.data() + i * 8;
+            Rectangle<double> rectangle;
+            for (size_t j = 0; j < 4; ++j)
+            {
+                rectangle.set_vertex(j, Point<double>(figure[2 * j], figure[2 * j + 1]));
+            }
+            benchmark::DoNotOptimize(rectangle);
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * 1024);
+}
+BENCHMARK(BM_Rectangle_SetVertices);
+
+
+static void BM_Rectangle_FromCoordinates(benchmark::State& state)
+{
+    const std::vector<double> coordinates = make_rectangle_coordinates(1024);
+
+    for (auto _ : state)
+    {
+        for (size_t i = 0; i < 1024; ++i)
+        {
+            Rectangle<double> rectangle(std::span<const double>(coordinates).subspan(i * 8, 8));
+            benchmark::DoNotOptimize(rectangle);
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * 1024);
+}
+BENCHMARK(BM_Rectangle_FromCoordinates);
+
+
+// Память резервируется заранее в обоих вариантах, так что разница -
+// только в построении фигур.
+static void BM_Array_AppendRectanglesOneByOne(benchmark::State& state)
+{
+    const size_t count = static_cast<size_t>(state.range(0));
+    const std::vector<double> coordinates = make_rectangle_coordinates(count);
+
+    for (auto _ : state)
+    {
+        Array<Rectangle<double>> rectangles;
+        rectangles.reserve(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            const double* figure = coordinates.data() + i * 8;
+            Rectangle<double>& rectangle = rectangles.emplace_back();
+            for (size_t j = 0; j < 4; ++j)
+            {
+                rectangle.set_vertex(j, Point<double>(figure[2 * j], figure[2 * j + 1]));
+            }
+        }
+        benchmark::DoNotOptimize(rectangles.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_Array_AppendRectanglesOneByOne)->Arg(1 << 16)->Unit(benchmark::kMicrosecond);
+
+
+static void BM_Array_AppendRangeRectangles(benchmark::State& state)
+{
+    const size_t count = static_cast<size_t>(state.range(0));
+    const std::vector<double> coordinates = make_rectangle_coordinates(count);
+
+    for (auto _ : state)
+    {
+        Array<Rectangle<double>> rectangles;
+        rectangles.append_range(coordinates, 8);
+        benchmark::DoNotOptimize(rectangles.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_Array_AppendRangeRectangles)->Arg(1 << 16)->Unit(benchmark::kMicrosecond);
+
+
+// ============================================================================
+// SIMPLIFICATION AND LEVELS OF DETAIL
+// ============================================================================
+
+// Волнистые окружности по 4096 вершин: мелкие зубцы поверх крупной формы.
+static Array<Polygon<double>> make_detailed_polygons(size_t count)
+{
+    Array<Polygon<double>> polygons;
+    std::vector<Point<double>> vertices(4096);
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        const double radius = 100.0 + static_cast<double>(i % 50);
+        for (size_t j = 0; j < vertices.size(); ++j)
+        {
+            const double angle = 2.0 * M_PI * j / vertices.size();
+            const double r = radius + 2.0 * std::sin(7.0 * angle) + 0.2 * std::sin(300.0 * angle + i);
+            vertices[j] = Point<double>(r * std::cos(angle), r * std::sin(angle));
+        }
+        polygons.append(Polygon<double>(vertices));
+    }
+
+    return polygons;
+}
+
+
+constexpr double lod_tolerances[] = {0.05, 0.25, 1.0};
+
+
+// Построение трех уровней для 256 фигур; второй аргумент - число
+// рабочих потоков.
+template<SimplificationMethod Method>
+static void BM_Simplification_BuildLevels(benchmark::State& state)
+{
+    const Array<Polygon<double>> polygons = make_detailed_polygons(256);
+    ThreadPool pool(state.range(0));
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(build_levels_of_detail(polygons, pool, Method, lod_tolerances));
+    }
+
+    state.SetItemsProcessed(state.iterations() * polygons.get_size());
+}
+BENCHMARK(BM_Simplification_BuildLevels<SimplificationMethod::DouglasPeucker>)->Arg(0)->Arg(4)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_Simplification_BuildLevels<SimplificationMethod::VisvalingamWhyatt>)->Arg(0)->Arg(4)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_Simplification_BuildLevels<SimplificationMethod::AreaPreserving>)->Arg(0)->Arg(4)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+
+// Площадь всех фигур на выбранном уровне без кэша против исходных
+// фигур (аргумент 0 - исходные, k - допуск lod_tolerances[k - 1]).
+// Ускорение - отношение времени к аргументу 0, area_error - ошибка
+// суммарной площади.
+template<SimplificationMethod Method>
+static void BM_Simplification_LevelArea(benchmark::State& state)
+{
+    const Array<Polygon<double>> polygons = make_detailed_polygons(256);
+    const std::vector<PolygonLevels<double>> levels = build_levels_of_detail(polygons, Method, lod_tolerances);
+    const double tolerance = state.range(0) == 0 ? 0.0 : lod_tolerances[state.range(0) - 1];
+
+    Array<Polygon<double>> selected;
+    size_t vertices = 0;
+    for (const PolygonLevels<double>& figure : levels)
+    {
+        selected.append(figure.select(tolerance));
+        vertices += selected[selected.get_size() - 1].vertex_count();
+    }
+
+    for (auto _ : state)
+    {
+        double total = 0.0;
+        for (Polygon<double>& polygon : selected)
+        {
+            polygon.set_vertex(0, polygon.get_vertex(0));
+            total += polygon.area();
+        }
+        benchmark::DoNotOptimize(total);
+    }
+
+    state.SetItemsProcessed(state.iterations() * selected.get_size());
+    state.counters["vertices_per_figure"] = static_cast<double>(vertices) / selected.get_size();
+    state.counters["area_error"] = std::abs(selected.total_area() - polygons.total_area()) / polygons.total_area();
+}
+BENCHMARK(BM_Simplification_LevelArea<SimplificationMethod::DouglasPeucker>)->DenseRange(0, 3);
+BENCHMARK(BM_Simplification_LevelArea<SimplificationMethod::VisvalingamWhyatt>)->DenseRange(0, 3);
+BENCHMARK(BM_Simplification_LevelArea<SimplificationMethod::AreaPreserving>)->DenseRange(0, 3);
@@ -0,0 +1,383 @@
+#ifndef AREA_BATCH_H
+#define AREA_BATCH_H
+
+
+#include "Point.h"
+#include "Polygon.h"
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#define AREA_BATCH_X86 1
+#include <immintrin.h>
+#endif
+
+
+// Пакетное вычисление площадей по формуле шнурков.
+//
+// Векторные ядра обрабатывают несколько фигур с одинаковым числом вершин
+// одновременно (по фигуре на линию) и повторяют в каждой линии ровно те же
+// операции в том же порядке, что и Polygon<T>::area(): произведения считаются
+// в T, разность приводится к double и добавляется к сумме. Поэтому результат
+// совпадает с Polygon<T>::area() побитово для float, double и int. Для int
+// это верно, пока произведения координат помещаются в int: переполнение
+// в скалярном коде - неопределенное поведение, а векторное умножение
+// (_mm_mullo_epi32) просто отбрасывает старшие биты.
+
+
+enum class SimdLevel : unsigned char
+{
+    Scalar,
+    SSE4,
+    AVX2
+};
+
+
+template<class T>
+concept SimdScalar = std::is_same_v<T, float> || std::is_same_v<T, double> || std::is_same_v<T, int>;
+
+
+inline SimdLevel detect_simd_level()
+{
+#ifdef AREA_BATCH_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+    {
+        return SimdLevel::AVX2;
+    }
+    if (__builtin_cpu_supports("sse4.1"))
+    {
+        return SimdLevel::SSE4;
+    }
+#endif
+    return SimdLevel::Scalar;
+}
+
+
+inline std::atomic<SimdLevel>& simd_level_storage()
+{
+    static std::atomic<SimdLevel> level(detect_simd_level());
+    return level;
+}
+
+
+inline SimdLevel get_simd_level()
+{
+    return simd_level_storage().load(std::memory_order_relaxed);
+}
+
+
+inline void set_simd_level(SimdLevel level)
+{
+    if (static_cast<unsigned char>(level) > static_cast<unsigned char>(detect_simd_level()))
+    {
+        throw std::invalid_argument("Error: SIMD level is not supported by this CPU.");
+    }
+
+    simd_level_storage().store(level, std::memory_order_relaxed);
+}
+
+
+template<Scalar T>
+double shoelace_area(const T* xs, const T* ys, size_t size)
+{
+    if (size == 0)
+    {
+        return 0.0;
+    }
+
+    double area = 0;
+
+    for (size_t i = 0; i + 1 < size; ++i)
+    {
+        area += (xs[i] * ys[i + 1] - xs[i + 1] * ys[i]);
+    }
+    area += (xs[size - 1] * ys[0] - xs[0] * ys[size - 1]);
+
+    return std::abs(area) / 2.0;
+}
+
+
+template<Scalar T>
+void area_batch_scalar(const T* xs, const T* ys, const size_t* offsets, const size_t* counts, size_t figures, double* out)
+{
+    for (size_t i = 0; i < figures; ++i)
+    {
+        out[i] = shoelace_area(xs + offsets[i], ys + offsets[i], counts[i]);
+    }
+}
+
+
+#ifdef AREA_BATCH_X86
+
+template<SimdScalar T>
+__attribute__((target("sse4.1")))
+void area_batch_sse4(const T* xs, const T* ys, const size_t* offsets, const size_t* counts, size_t figures, double* out)
+{
+    size_t i = 0;
+
+    while (i + 2 <= figures)
+    {
+        const size_t size = counts[i];
+        if (counts[i + 1] != size || size == 0)
+        {
+            out[i] = shoelace_area(xs + offsets[i], ys + offsets[i], size);
+            ++i;
+            continue;
+        }
+
+        const T* xa = xs + offsets[i];
+        const T* ya = ys + offsets[i];
+        const T* xb = xs + offsets[i + 1];
+        const T* yb = ys + offsets[i + 1];
+        __m128d sum = _mm_setzero_pd();
+
+        for (size_t k = 0; k < size; ++k)
+        {
+            const size_t next = (k + 1 == size) ? 0 : k + 1;
+
+            if constexpr (std::is_same_v<T, double>)
+            {
+                const __m128d xk = _mm_set_pd(xb[k], xa[k]);
+                const __m128d yk = _mm_set_pd(yb[k], ya[k]);
+                const __m128d xn = _mm_set_pd(xb[next], xa[next]);
+                const __m128d yn = _mm_set_pd(yb[next], ya[next]);
+                sum = _mm_add_pd(sum, _mm_sub_pd(_mm_mul_pd(xk, yn), _mm_mul_pd(xn, yk)));
+            }
+            else if constexpr (std::is_same_v<T, float>)
+            {
+                const __m128 xk = _mm_set_ps(0.0f, 0.0f, xb[k], xa[k]);
+                const __m128 yk = _mm_set_ps(0.0f, 0.0f, yb[k], ya[k]);
+                const __m128 xn = _mm_set_ps(0.0f, 0.0f, xb[next], xa[next]);
+                const __m128 yn = _mm_set_ps(0.0f, 0.0f, yb[next], ya[next]);
+                sum = _mm_add_pd(sum, _mm_cvtps_pd(_mm_sub_ps(_mm_mul_ps(xk, yn), _mm_mul_ps(xn, yk))));
+            }
+            else
+            {
+                const __m128i xk = _mm_set_epi32(0, 0, xb[k], xa[k]);
+                const __m128i yk = _mm_set_epi32(0, 0, yb[k], ya[k]);
+                const __m128i xn = _mm_set_epi32(0, 0, xb[next], xa[next]);
+                const __m128i yn = _mm_set_epi32(0, 0, yb[next], ya[next]);
+                sum = _mm_add_pd(sum, _mm_cvtepi32_pd(_mm_sub_epi32(_mm_mullo_epi32(xk, yn), _mm_mullo_epi32(xn, yk))));
+            }
+        }
+
+        alignas(16) double lanes[2];
+        _mm_store_pd(lanes, sum);
+        out[i] = std::abs(lanes[0]) / 2.0;
+        out[i + 1] = std::abs(lanes[1]) / 2.0;
+        i += 2;
+    }
+
+    for (; i < figures; ++i)
+    {
+        out[i] = shoelace_area(xs + offsets[i], ys + offsets[i], counts[i]);
+    }
+}
+
+
+// Четыре четырехугольника, лежащие в хранилище подряд: вместо gather
+// координаты загружаются строками и транспонируются так, чтобы в линии
+// оказалась одна фигура.
+template<SimdScalar T>
+__attribute__((target("avx2")))
+void area_batch_avx2_quads(const T* xs, const T* ys, double* out)
+{
+    __m256d sum = _mm256_setzero_pd();
+
+    if constexpr (std::is_same_v<T, double>)
+    {
+        __m256d x[4];
+        __m256d y[4];
+
+        for (int axis = 0; axis < 2; ++axis)
+        {
+            const double* source = axis == 0 ? xs : ys;
+            __m256d* columns = axis == 0 ? x : y;
+
+            const __m256d r0 = _mm256_loadu_pd(source);
+            const __m256d r1 = _mm256_loadu_pd(source + 4);
+            const __m256d r2 = _mm256_loadu_pd(source + 8);
+            const __m256d r3 = _mm256_loadu_pd(source + 12);
+            const __m256d t0 = _mm256_unpacklo_pd(r0, r1);
+            const __m256d t1 = _mm256_unpackhi_pd(r0, r1);
+            const __m256d t2 = _mm256_unpacklo_pd(r2, r3);
+            const __m256d t3 = _mm256_unpackhi_pd(r2, r3);
+            columns[0] = _mm256_permute2f128_pd(t0, t2, 0x20);
+            columns[1] = _mm256_permute2f128_pd(t1, t3, 0x20);
+            columns[2] = _mm256_permute2f128_pd(t0, t2, 0x31);
+            columns[3] = _mm256_permute2f128_pd(t1, t3, 0x31);
+        }
+
+        for (int k = 0; k < 4; ++k)
+        {
+            const int next = (k + 1) & 3;
+            sum = _mm256_add_pd(sum, _mm256_sub_pd(_mm256_mul_pd(x[k], y[next]), _mm256_mul_pd(x[next], y[k])));
+        }
+    }
+    else
+    {
+        __m128 xr[4];
+        __m128 yr[4];
+        for (int row = 0; row < 4; ++row)
+        {
+            xr[row] = _mm_loadu_ps(reinterpret_cast<const float*>(xs + 4 * row));
+            yr[row] = _mm_loadu_ps(reinterpret_cast<const float*>(ys + 4 * row));
+        }
+        _MM_TRANSPOSE4_PS(xr[0], xr[1], xr[2], xr[3]);
+        _MM_TRANSPOSE4_PS(yr[0], yr[1], yr[2], yr[3]);
+
+        for (int k = 0; k < 4; ++k)
+        {
+            const int next = (k + 1) & 3;
+            if constexpr (std::is_same_v<T, float>)
+            {
+                sum = _mm256_add_pd(sum, _mm256_cvtps_pd(_mm_sub_ps(_mm_mul_ps(xr[k], yr[next]), _mm_mul_ps(xr[next], yr[k]))));
+            }
+            else
+            {
+                const __m128i xk = _mm_castps_si128(xr[k]);
+                const __m128i yk = _mm_castps_si128(yr[k]);
+                const __m128i xn = _mm_castps_si128(xr[next]);
+                const __m128i yn = _mm_castps_si128(yr[next]);
+                sum = _mm256_add_pd(sum, _mm256_cvtepi32_pd(_mm_sub_epi32(_mm_mullo_epi32(xk, yn), _mm_mullo_epi32(xn, yk))));
+            }
+        }
+    }
+
+    const __m256d sign_mask = _mm256_set1_pd(-0.0);
+    _mm256_storeu_pd(out, _mm256_mul_pd(_mm256_andnot_pd(sign_mask, sum), _mm256_set1_pd(0.5)));
+}
+
+
+template<SimdScalar T>
+__attribute__((target("avx2")))
+void area_batch_avx2(const T* xs, const T* ys, const size_t* offsets, const size_t* counts, size_t figures, double* out)
+{
+    static_assert(sizeof(size_t) == sizeof(long long));
+
+    size_t i = 0;
+
+    while (i + 4 <= figures)
+    {
+        const size_t size = counts[i];
+        if (counts[i + 1] != size || counts[i + 2] != size || counts[i + 3] != size || size == 0)
+        {
+            out[i] = shoelace_area(xs + offsets[i], ys + offsets[i], size);
+            ++i;
+            continue;
+        }
+
+        if (size == 4 && offsets[i + 1] == offsets[i] + 4 && offsets[i + 2] == offsets[i] + 8 && offsets[i + 3] == offsets[i] + 12)
+        {
+            area_batch_avx2_quads(xs + offsets[i], ys + offsets[i], out + i);
+            i += 4;
+            continue;
+        }
+
+        const __m256i base = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(offsets + i));
+        __m256d sum = _mm256_setzero_pd();
+
+        for (size_t k = 0; k < size; ++k)
+        {
+            const size_t next = (k + 1 == size) ? 0 : k + 1;
+            const __m256i current_index = _mm256_add_epi64(base, _mm256_set1_epi64x(static_cast<long long>(k)));
+            const __m256i next_index = _mm256_add_epi64(base, _mm256_set1_epi64x(static_cast<long long>(next)));
+
+            if constexpr (std::is_same_v<T, double>)
+            {
+                const __m256d xk = _mm256_i64gather_pd(xs, current_index, 8);
+                const __m256d yk = _mm256_i64gather_pd(ys, current_index, 8);
+                const __m256d xn = _mm256_i64gather_pd(xs, next_index, 8);
+                const __m256d yn = _mm256_i64gather_pd(ys, next_index, 8);
+                sum = _mm256_add_pd(sum, _mm256_sub_pd(_mm256_mul_pd(xk, yn), _mm256_mul_pd(xn, yk)));
+            }
+            else if constexpr (std::is_same_v<T, float>)
+            {
+                const __m128 xk = _mm256_i64gather_ps(xs, current_index, 4);
+                const __m128 yk = _mm256_i64gather_ps(ys, current_index, 4);
+                const __m128 xn = _mm256_i64gather_ps(xs, next_index, 4);
+                const __m128 yn = _mm256_i64gather_ps(ys, next_index, 4);
+                sum = _mm256_add_pd(sum, _mm256_cvtps_pd(_mm_sub_ps(_mm_mul_ps(xk, yn), _mm_mul_ps(xn, yk))));
+            }
+            else
+            {
+                const __m128i xk = _mm256_i64gather_epi32(xs, current_index, 4);
+                const __m128i yk = _mm256_i64gather_epi32(ys, current_index, 4);
+                const __m128i xn = _mm256_i64gather_epi32(xs, next_index, 4);
+                const __m128i yn = _mm256_i64gather_epi32(ys, next_index, 4);
+                sum = _mm256_add_pd(sum, _mm256_cvtepi32_pd(_mm_sub_epi32(_mm_mullo_epi32(xk, yn), _mm_mullo_epi32(xn, yk))));
+            }
+        }
+
+        alignas(32) double lanes[4];
+        _mm256_store_pd(lanes, sum);
+        for (size_t lane = 0; lane < 4; ++lane)
+        {
+            out[i + lane] = std::abs(lanes[lane]) / 2.0;
+        }
+        i += 4;
+    }
+
+    for (; i < figures; ++i)
+    {
+        out[i] = shoelace_area(xs + offsets[i], ys + offsets[i], counts[i]);
+    }
+}
+
+#endif // AREA_BATCH_X86
+
+
+template<Scalar T>
+void area_batch(const T* xs, const T* ys, std::span<const size_t> offsets, std::span<const size_t> counts, std::span<double> out)
+{
+    if (offsets.size() != counts.size())
+    {
+        throw std::invalid_argument("Error: Offsets and counts must have the same length.");
+    }
+    if (out.size() < offsets.size())
+    {
+        throw std::invalid_argument("Error: Output span is smaller than the number of figures.");
+    }
+
+#ifdef AREA_BATCH_X86
+    if constexpr (SimdScalar<T>)
+    {
+        switch (get_simd_level())
+        {
+        case SimdLevel::AVX2:
+            area_batch_avx2(xs, ys, offsets.data(), counts.data(), offsets.size(), out.data());
+            return;
+        case SimdLevel::SSE4:
+            area_batch_sse4(xs, ys, offsets.data(), counts.data(), offsets.size(), out.data());
+            return;
+        case SimdLevel::Scalar:
+            break;
+        }
+    }
+#endif
+
+    area_batch_scalar(xs, ys, offsets.data(), counts.data(), offsets.size(), out.data());
+}
+
+
+template<Scalar T>
+void area_batch(std::span<const Polygon<T>> polygons, std::span<double> out)
+{
+    if (out.size() < polygons.size())
+    {
+        throw std::invalid_argument("Error: Output span is smaller than the number of figures.");
+    }
+
+    for (size_t i = 0; i < polygons.size(); ++i)
+    {
+        out[i] = polygons[i].Polygon<T>::area();
+    }
+}
+
+
+#endif // AREA_BATCH_H
@@ -0,0 +1,323 @@
+#ifndef ARITHMETIC_H
+#define ARITHMETIC_H
+
+
+#include "Point.h"
+#include <cmath>
+#include <cstddef>
+#include <type_traits>
+
+
+// Политики арифметики для Polygon и предикатов.
+//
+// FastArithmetic - прежнее поведение: произведения считаются в T, суммы -
+// обычным сложением double, знак векторного произведения - по значению
+// в double. Для int большие координаты переполняют произведения, а для
+// почти коллинеарных точек знак может оказаться неверным.
+//
+// RobustArithmetic - для целых T произведения и суммы считаются в
+// __int128. Знак векторного произведения точен, пока координаты по
+// модулю меньше 2^62. Слагаемое формулы шнурков по модулю не больше
+// 2 * |c|^2, поэтому сумма по n ребрам точна при
+// |c| < 2^(62 - ceil(log2(n)) / 2); для 32-битных координат это
+// выполняется при любом n < 2^62. Для вещественных T произведения
+// раскладываются без ошибок через fma, а суммы компенсируются
+// (Ноймайер). Знак векторного произведения определяется адаптивно:
+// быстрая оценка в double с границей ошибки Шевчука и точный пересчет,
+// только если оценка ненадежна.
+
+
+using wide_integer = __int128;
+
+
+// a + b = sum + error точно.
+inline void two_sum(double a, double b, double& sum, double& error)
+{
+    sum = a + b;
+    const double b_virtual = sum - a;
+    const double a_virtual = sum - b_virtual;
+    error = (a - a_virtual) + (b - b_virtual);
+}
+
+
+// a * b = product + error точно (без переполнения и потери значимости).
+inline void two_product(double a, double b, double& product, double& error)
+{
+    product = a * b;
+    error = std::fma(a, b, -product);
+}
+
+
+// Знак точной суммы values. Слагаемые накапливаются в неперекрывающееся
+// разложение (grow-expansion Шевчука) на месте; компоненты растут по
+// модулю, поэтому знак суммы - знак старшего ненулевого компонента.
+inline int exact_sign(double* values, size_t count)
+{
+    size_t length = 0;
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        double carry = values[i];
+        for (size_t j = 0; j < length; ++j)
+        {
+            double error;
+            two_sum(carry, values[j], carry, error);
+            values[j] = error;
+        }
+        values[length++] = carry;
+    }
+
+    for (size_t i = length; i > 0; --i)
+    {
+        if (values[i - 1] != 0.0)
+        {
+            return values[i - 1] > 0.0 ? 1 : -1;
+        }
+    }
+
+    return 0;
+}
+
+
+// Точный знак (b - a) x (c - a) для координат в double: выражение
+// раскрывается в шесть произведений самих координат (разности тоже
+// округлялись бы), а произведения через two_product точны. Вынесено
+// из orientation, чтобы быстрая ветка встраивалась.
+[[gnu::noinline]] inline int exact_orientation(double a_x, double a_y, double b_x, double b_y, double c_x, double c_y)
+{
+    double terms[12];
+    two_product(b_x, c_y, terms[0], terms[1]);
+    two_product(-b_x, a_y, terms[2], terms[3]);
+    two_product(-a_x, c_y, terms[4], terms[5]);
+    two_product(-c_x, b_y, terms[6], terms[7]);
+    two_product(c_x, a_y, terms[8], terms[9]);
+    two_product(a_x, b_y, terms[10], terms[11]);
+
+    return exact_sign(terms, 12);
+}
+
+
+// Обычное сложение double - для FastArithmetic.
+class PlainSum final
+{
+private:
+    double sum = 0.0;
+
+public:
+    constexpr void add(double value);
+    constexpr double value() const;
+};
+
+
+// Суммирование Ноймайера: погрешность не растет с числом слагаемых.
+class CompensatedSum final
+{
+private:
+    double sum = 0.0;
+    double compensation = 0.0;
+
+public:
+    CompensatedSum() = default;
+    explicit CompensatedSum(double value);
+
+public:
+    void add(double value);
+    void merge(const CompensatedSum& other);
+    double value() const;
+};
+
+
+struct FastArithmetic final
+{
+    constexpr static bool exact = false;
+
+    using Sum = PlainSum;
+
+    // Удвоенная ориентированная площадь многоугольника по формуле шнурков.
+    template<Scalar T>
+    class AreaSum final
+    {
+    private:
+        double sum = 0.0;
+
+    public:
+        constexpr void add(const Point<T>& current, const Point<T>& next);
+        constexpr double value() const;
+    };
+
+    // Знак (b - a) x (c - a): 1 - c слева от ab, -1 - справа, 0 - на прямой.
+    template<Scalar T>
+    static int orientation(const Point<T>& a, const Point<T>& b, const Point<T>& c);
+};
+
+
+struct RobustArithmetic final
+{
+    constexpr static bool exact = true;
+
+    using Sum = CompensatedSum;
+
+    template<Scalar T>
+    class AreaSum final
+    {
+    private:
+        std::conditional_t<std::is_integral_v<T>, wide_integer, CompensatedSum> sum{};
+
+    public:
+        void add(const Point<T>& current, const Point<T>& next);
+        double value() const;
+    };
+
+    template<Scalar T>
+    static int orientation(const Point<T>& a, const Point<T>& b, const Point<T>& c);
+};
+
+
+template<class P>
+concept ArithmeticPolicy = std::is_same_v<P, FastArithmetic> || std::is_same_v<P, RobustArithmetic>;
+
+
+constexpr void PlainSum::add(double value)
+{
+    sum += value;
+}
+
+
+constexpr double PlainSum::value() const
+{
+    return sum;
+}
+
+
+inline CompensatedSum::CompensatedSum(double value): sum(value) {}
+
+
+inline void CompensatedSum::add(double value)
+{
+    const double total = sum + value;
+
+    if (std::abs(sum) >= std::abs(value))
+    {
+        compensation += (sum - total) + value;
+    }
+    else
+    {
+        compensation += (value - total) + sum;
+    }
+
+    sum = total;
+}
+
+
+inline void CompensatedSum::merge(const CompensatedSum& other)
+{
+    add(other.sum);
+    compensation += other.compensation;
+}
+
+
+inline double CompensatedSum::value() const
+{
+    return sum + compensation;
+}
+
+
+template<Scalar T>
+constexpr void FastArithmetic::AreaSum<T>::add(const Point<T>& current, const Point<T>& next)
+{
+    sum += (current.x * next.y - next.x * current.y);
+}
+
+
+template<Scalar T>
+constexpr double FastArithmetic::AreaSum<T>::value() const
+{
+    return sum;
+}
+
+
+template<Scalar T>
+int FastArithmetic::orientation(const Point<T>& a, const Point<T>& b, const Point<T>& c)
+{
+    const double a_x = static_cast<double>(a.x);
+    const double a_y = static_cast<double>(a.y);
+    const double cross = (static_cast<double>(b.x) - a_x) * (static_cast<double>(c.y) - a_y)
+                       - (static_cast<double>(c.x) - a_x) * (static_cast<double>(b.y) - a_y);
+
+    return cross > 0.0 ? 1 : (cross < 0.0 ? -1 : 0);
+}
+
+
+template<Scalar T>
+void RobustArithmetic::AreaSum<T>::add(const Point<T>& current, const Point<T>& next)
+{
+    if constexpr (std::is_integral_v<T>)
+    {
+        sum += static_cast<wide_integer>(current.x) * static_cast<wide_integer>(next.y)
+             - static_cast<wide_integer>(next.x) * static_cast<wide_integer>(current.y);
+    }
+    else
+    {
+        double product, error;
+
+        two_product(static_cast<double>(current.x), static_cast<double>(next.y), product, error);
+        sum.add(product);
+        sum.add(error);
+        two_product(static_cast<double>(next.x), static_cast<double>(current.y), product, error);
+        sum.add(-product);
+        sum.add(-error);
+    }
+}
+
+
+template<Scalar T>
+double RobustArithmetic::AreaSum<T>::value() const
+{
+    if constexpr (std::is_integral_v<T>)
+    {
+        return static_cast<double>(sum);
+    }
+    else
+    {
+        return sum.value();
+    }
+}
+
+
+// Для вещественных T - фильтр Шевчука: значение в double надежно,
+// если превышает границу ошибки, иначе точный пересчет.
+template<Scalar T>
+int RobustArithmetic::orientation(const Point<T>& a, const Point<T>& b, const Point<T>& c)
+{
+    if constexpr (std::is_integral_v<T>)
+    {
+        const wide_integer cross = (static_cast<wide_integer>(b.x) - a.x) * (static_cast<wide_integer>(c.y) - a.y)
+                                 - (static_cast<wide_integer>(c.x) - a.x) * (static_cast<wide_integer>(b.y) - a.y);
+
+        return cross > 0 ? 1 : (cross < 0 ? -1 : 0);
+    }
+    else
+    {
+        const double a_x = static_cast<double>(a.x);
+        const double a_y = static_cast<double>(a.y);
+        const double b_x = static_cast<double>(b.x);
+        const double b_y = static_cast<double>(b.y);
+        const double c_x = static_cast<double>(c.x);
+        const double c_y = static_cast<double>(c.y);
+
+        const double left = (b_x - a_x) * (c_y - a_y);
+        const double right = (c_x - a_x) * (b_y - a_y);
+        const double cross = left - right;
+        const double bound = (3.0 + 16.0 * 0x1p-53) * 0x1p-53 * (std::abs(left) + std::abs(right));
+
+        if (cross > bound || -cross > bound)
+        {
+            return cross > 0.0 ? 1 : -1;
+        }
+
+        return exact_orientation(a_x, a_y, b_x, b_y, c_x, c_y);
+    }
+}
+
+
+#endif // ARITHMETIC_H
@@ -2,97 +2,426 @@
 #define ARRAY_H
 
 
+#include "Instrumentation.h"
+#include "Reduction.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <atomic>
+#include <concepts>
 #include <cstddef>
+#include <cstring>
 #include <memory>
-#include <iomanip>
+#include <memory_resource>
 #include <iostream>
+#include <new>
+#include <ranges>
+#include <span>
 #include <stdexcept>
-
-
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+// Копии массива делят одно хранилище (копирование при записи): копия
+// и snapshot() стоят O(1), а изменяющие операции (append, emplace_back,
+// append_range, remove, swap_remove, remove_range, erase_if, неконстантные operator[],
+// data(), begin() и end()) сначала получают собственную копию элементов.
+// Счетчик ссылок атомарный, поэтому снимок можно читать в другом потоке,
+// пока писатель меняет исходный массив. Ссылки, указатели и итераторы,
+// полученные для записи, нельзя использовать после копирования массива.
+// Итераторы - указатели на элементы, так что массив - contiguous_range.
 template<class T>
 class Array final
 {
+public:
+    using allocator_type = std::pmr::polymorphic_allocator<T>;
+    using value_type = T;
+    using iterator = T*;
+    using const_iterator = const T*;
+    constexpr static size_t reduce_block_size = 4096;
+
+private:
+    using allocator_traits = std::allocator_traits<allocator_type>;
+
+    // Заголовок лежит в том же блоке памяти прямо перед элементами.
+    struct StorageHeader
+    {
+        std::atomic<size_t> references;
+    };
+
+    // Такие элементы копируются, переносятся и сдвигаются memcpy/memmove.
+    constexpr static bool bitwise_copyable = std::is_trivially_copyable_v<T> && !std::uses_allocator_v<T, allocator_type>;
+
+    constexpr static size_t storage_alignment = std::max(alignof(T), alignof(StorageHeader));
+    constexpr static size_t header_size = (sizeof(StorageHeader) + storage_alignment - 1) / storage_alignment * storage_alignment;
+
 private:
     size_t size = 0;
     size_t capacity = 16;
-    std::shared_ptr<T[]> array;
+    double growth_factor = 2.0;
+    allocator_type allocator;
+    T* array = nullptr;
 
 private:
-    void resize();
+    static StorageHeader* header_of(T* storage);
+    T* allocate_storage(size_t count);
+    void deallocate_storage(T* storage, size_t count) noexcept;
+    void release_storage() noexcept;
+    void discard_elements() noexcept;
+    void share(const Array& other) noexcept;
+    void detach();
+    size_t next_capacity() const;
+    void copy_elements(const T* source, size_t count, T* destination);
+    void shift_elements(size_t from, size_t to, size_t count);
+    void relocate(T* destination);
+    void reallocate(size_t new_capacity);
+    void release_tail(size_t new_size) noexcept;
+    template<class... Args>
+    [[gnu::noinline]] T& grow_and_emplace(Args&&... args);
 
 public:
     Array();
+    explicit Array(const allocator_type& allocator);
     Array(size_t size);
+    Array(size_t size, const allocator_type& allocator);
     Array(const Array& other);
+    Array(const Array& other, const allocator_type& allocator);
     Array(Array&& other) noexcept;
-    ~Array() noexcept = default;
+    ~Array() noexcept;
 
 public:
     Array& append(const T& figure);
     Array& append(T&& figure);
+    template<class... Args>
+    T& emplace_back(Args&&... args);
+    template<std::ranges::contiguous_range R>
+        requires std::ranges::sized_range<R> && std::constructible_from<T, std::span<const std::ranges::range_value_t<R>>>
+    Array& append_range(const R& buffer, size_t stride);
+    void reserve(size_t new_capacity);
+    void shrink_to_fit();
+    void set_growth_factor(double factor);
+    double get_growth_factor() const;
     void remove(size_t index);
+    void swap_remove(size_t index);
+    void remove_range(size_t first, size_t last);
+    template<class Predicate>
+    size_t erase_if(Predicate predicate);
     void print() const;
     void print(size_t index) const;
-    void total_area() const;
+    template<class R, class Accumulate, class Combine>
+    R parallel_reduce(ThreadPool& pool, R identity, Accumulate accumulate, Combine combine) const;
+    double total_area() const;
+    double total_area(ThreadPool& pool) const;
+    AreaStatistics area_statistics() const;
+    AreaStatistics area_statistics(ThreadPool& pool) const;
     size_t get_size() const;
     size_t get_capacity() const;
+    allocator_type get_allocator() const;
+    bool is_shared() const;
+    Array snapshot() const;
+    T* data();
+    const T* data() const;
+    iterator begin();
+    iterator end();
+    const_iterator begin() const;
+    const_iterator end() const;
+    const_iterator cbegin() const;
+    const_iterator cend() const;
 
 public:
     Array& operator=(const Array& other);
-    Array& operator=(Array&& other) noexcept;
+    Array& operator=(Array&& other);
     operator double() const;
     T& operator[](size_t index);
-    T operator[](size_t index) const;
+    const T& operator[](size_t index) const;
 };
 
 
 template<class T>
-void Array<T>::resize()
+typename Array<T>::StorageHeader* Array<T>::header_of(T* storage)
+{
+    return reinterpret_cast<StorageHeader*>(reinterpret_cast<std::byte*>(storage) - header_size);
+}
+
+
+template<class T>
+T* Array<T>::allocate_storage(size_t count)
 {
-    capacity *= 2;
-    auto new_array = std::make_shared<T[]>(capacity);
+    if (count == 0)
+    {
+        return nullptr;
+    }
 
-    for (size_t i = 0; i < size; ++i)
+    void* block = allocator.allocate_bytes(header_size + count * sizeof(T), storage_alignment);
+    ::new (block) StorageHeader{1};
+    return reinterpret_cast<T*>(static_cast<std::byte*>(block) + header_size);
+}
+
+
+// Освобождает память без уничтожения элементов.
+template<class T>
+void Array<T>::deallocate_storage(T* storage, size_t count) noexcept
+{
+    if (storage != nullptr)
+    {
+        StorageHeader* header = header_of(storage);
+        header->~StorageHeader();
+        allocator.deallocate_bytes(header, header_size + count * sizeof(T), storage_alignment);
+    }
+}
+
+
+// Отпускает хранилище; последний владелец уничтожает элементы и память.
+template<class T>
+void Array<T>::release_storage() noexcept
+{
+    if (array != nullptr && header_of(array)->references.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    {
+        release_tail(0);
+        deallocate_storage(array, capacity);
+    }
+
+    array = nullptr;
+    size = 0;
+}
+
+
+// Очищает массив перед заполнением заново: свое хранилище
+// переиспользуется, общее отпускается.
+template<class T>
+void Array<T>::discard_elements() noexcept
+{
+    if (is_shared())
+    {
+        release_storage();
+        capacity = 0;
+    }
+    else
+    {
+        release_tail(0);
+    }
+}
+
+
+template<class T>
+void Array<T>::share(const Array& other) noexcept
+{
+    array = other.array;
+    size = other.size;
+    capacity = other.capacity;
+
+    if (array != nullptr)
+    {
+        header_of(array)->references.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+
+// Перед изменением: общее хранилище заменяется собственной копией.
+template<class T>
+void Array<T>::detach()
+{
+    if (is_shared())
+    {
+        reallocate(capacity);
+    }
+}
+
+
+template<class T>
+size_t Array<T>::next_capacity() const
+{
+    return std::max(capacity + 1, static_cast<size_t>(capacity * growth_factor));
+}
+
+
+// Копирует count элементов в неинициализированную память destination.
+// При исключении уже построенные копии уничтожаются.
+template<class T>
+void Array<T>::copy_elements(const T* source, size_t count, T* destination)
+{
+    if constexpr (bitwise_copyable)
+    {
+        if (count > 0)
+        {
+            std::memcpy(destination, source, count * sizeof(T));
+        }
+    }
+    else
+    {
+        size_t constructed = 0;
+
+        try
+        {
+            for (; constructed < count; ++constructed)
+            {
+                allocator_traits::construct(allocator, destination + constructed, source[constructed]);
+            }
+        }
+        catch (...)
+        {
+            for (size_t i = 0; i < constructed; ++i)
+            {
+                allocator_traits::destroy(allocator, destination + i);
+            }
+            throw;
+        }
+    }
+}
+
+
+// Сдвигает count живых элементов с позиции from на позицию to < from.
+template<class T>
+void Array<T>::shift_elements(size_t from, size_t to, size_t count)
+{
+    GEOMETRY_INSTRUMENT(InstrumentedOperation::ArrayShift, count);
+
+    if constexpr (bitwise_copyable)
+    {
+        if (count > 0)
+        {
+            std::memmove(array + to, array + from, count * sizeof(T));
+        }
+    }
+    else
+    {
+        std::move(array + from, array + from + count, array + to);
+    }
+}
+
+
+// Переносит элементы в неинициализированную память destination; из
+// общего хранилища элементы копируются. При исключении уже построенные
+// копии уничтожаются, исходные элементы не тронуты.
+template<class T>
+void Array<T>::relocate(T* destination)
+{
+    if (bitwise_copyable || is_shared())
+    {
+        copy_elements(array, size, destination);
+        return;
+    }
+
+    size_t constructed = 0;
+
+    try
+    {
+        for (; constructed < size; ++constructed)
+        {
+            allocator_traits::construct(allocator, destination + constructed, std::move_if_noexcept(array[constructed]));
+        }
+    }
+    catch (...)
+    {
+        for (size_t i = 0; i < constructed; ++i)
+        {
+            allocator_traits::destroy(allocator, destination + i);
+        }
+        throw;
+    }
+}
+
+
+template<class T>
+void Array<T>::reallocate(size_t new_capacity)
+{
+    GEOMETRY_INSTRUMENT(InstrumentedOperation::ArrayReallocation, size);
+    T* new_array = allocate_storage(new_capacity);
+
+    try
+    {
+        relocate(new_array);
+    }
+    catch (...)
     {
-        new_array[i] = std::move(array[i]);
+        deallocate_storage(new_array, new_capacity);
+        throw;
     }
 
-    array = std::move(new_array);
+    const size_t old_size = size;
+    release_storage();
+
+    array = new_array;
+    capacity = new_capacity;
+    size = old_size;
+}
+
+
+// Уничтожает элементы начиная с new_size, чтобы не удерживать ресурсы
+// (например, фигуры за shared_ptr) после удаления.
+template<class T>
+void Array<T>::release_tail(size_t new_size) noexcept
+{
+    for (size_t i = new_size; i < size; ++i)
+    {
+        allocator_traits::destroy(allocator, array + i);
+    }
+
+    size = new_size;
 }
 
 
 template<class T>
 Array<T>::Array()
 {
-    array = std::make_shared<T[]>(capacity);
+    array = allocate_storage(capacity);
 }
 
 
 template<class T>
-Array<T>::Array(size_t reserve_size): capacity(reserve_size)
+Array<T>::Array(const allocator_type& allocator): allocator(allocator)
+{
+    array = allocate_storage(capacity);
+}
+
+
+template<class T>
+Array<T>::Array(size_t reserve_size): Array(reserve_size, allocator_type()) {}
+
+
+template<class T>
+Array<T>::Array(size_t reserve_size, const allocator_type& allocator): capacity(reserve_size), allocator(allocator)
 {
     if (reserve_size <= 0)
     {
         throw std::invalid_argument("Error: You passed incorrect size for array.\nSize should be greater than 0.");
     }
-    array = std::make_shared<T[]>(capacity);
+    array = allocate_storage(capacity);
 }
 
 
 template<class T>
-Array<T>::Array(const Array& other): size(other.size), capacity(other.capacity)
+Array<T>::Array(const Array& other): Array(other, allocator_type()) {}
+
+
+// С тем же ресурсом памяти копия делит хранилище с other.
+template<class T>
+Array<T>::Array(const Array& other, const allocator_type& allocator): capacity(other.capacity), growth_factor(other.growth_factor), allocator(allocator)
 {
-    array = std::make_shared<T[]>(capacity);
+    if (this->allocator == other.allocator)
+    {
+        share(other);
+        return;
+    }
 
-    for (size_t i = 0; i < size; ++i)
+    array = allocate_storage(capacity);
+
+    try
+    {
+        copy_elements(other.array, other.size, array);
+        size = other.size;
+    }
+    catch (...)
     {
-        array[i] = other.array[i];
+        release_storage();
+        throw;
     }
 }
 
 
 template<class T>
-Array<T>::Array(Array&& other) noexcept: size(other.size), capacity(other.capacity), array(std::move(other.array))
+Array<T>::Array(Array&& other) noexcept
+    : size(other.size), capacity(other.capacity), growth_factor(other.growth_factor), allocator(other.allocator), array(other.array)
 {
     other.size = 0;
     other.capacity = 0;
@@ -100,34 +429,161 @@ Array<T>::Array(Array&& other) noexcept: size(other.size), capacity(other.capaci
 }
 
 
+template<class T>
+Array<T>::~Array() noexcept
+{
+    release_storage();
+}
+
+
 template<class T>
 Array<T>& Array<T>::append(const T& figure)
 {
-    if (size == capacity)
+    emplace_back(figure);
+    return *this;
+}
+
+
+template<class T>
+Array<T>& Array<T>::append(T&& figure)
+{
+    emplace_back(std::move(figure));
+    return *this;
+}
+
+
+// Элемент строится прямо в хранилище.
+template<class T>
+template<class... Args>
+T& Array<T>::emplace_back(Args&&... args)
+{
+    if (size == capacity || is_shared())
     {
-        resize();
+        return grow_and_emplace(std::forward<Args>(args)...);
     }
 
-    array[size++] = figure;
+    allocator_traits::construct(allocator, array + size, std::forward<Args>(args)...);
+    return array[size++];
+}
 
-    return *this;
+
+// Новый элемент создается раньше переноса старых, так как args могут
+// ссылаться на элементы этого же массива. Вынесено из emplace_back,
+// чтобы быстрый путь встраивался в вызывающий код. Общее хранилище
+// копируется в новое той же емкости, если место еще есть.
+template<class T>
+template<class... Args>
+T& Array<T>::grow_and_emplace(Args&&... args)
+{
+    GEOMETRY_INSTRUMENT(InstrumentedOperation::ArrayReallocation, size);
+    const size_t new_capacity = size == capacity ? next_capacity() : capacity;
+    T* new_array = allocate_storage(new_capacity);
+
+    try
+    {
+        allocator_traits::construct(allocator, new_array + size, std::forward<Args>(args)...);
+    }
+    catch (...)
+    {
+        deallocate_storage(new_array, new_capacity);
+        throw;
+    }
+
+    try
+    {
+        relocate(new_array);
+    }
+    catch (...)
+    {
+        allocator_traits::destroy(allocator, new_array + size);
+        deallocate_storage(new_array, new_capacity);
+        throw;
+    }
+
+    const size_t old_size = size;
+    release_storage();
+
+    array = new_array;
+    capacity = new_capacity;
+    size = old_size + 1;
+
+    return array[old_size];
 }
 
 
+// Строит фигуры подряд из плоского буфера: i-я получает отрезок
+// buffer длиной stride (вершины или чередующиеся координаты) и
+// аллокатор массива. Память выделяется один раз на весь буфер.
 template<class T>
-Array<T>& Array<T>::append(T&& figure)
+template<std::ranges::contiguous_range R>
+    requires std::ranges::sized_range<R> && std::constructible_from<T, std::span<const std::ranges::range_value_t<R>>>
+Array<T>& Array<T>::append_range(const R& buffer, size_t stride)
 {
-    if (size == capacity)
+    const std::span<const std::ranges::range_value_t<R>> items(buffer);
+
+    if (stride == 0 || items.size() % stride != 0)
     {
-        resize();
+        throw std::invalid_argument("Error: The buffer size is not a multiple of the stride.");
     }
 
-    array[size++] = std::move(figure);
+    const size_t count = items.size() / stride;
+    if (size + count > capacity)
+    {
+        reallocate(std::max(size + count, next_capacity()));
+    }
+    else
+    {
+        detach();
+    }
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        allocator_traits::construct(allocator, array + size, items.subspan(i * stride, stride));
+        ++size;
+    }
 
     return *this;
 }
 
 
+template<class T>
+void Array<T>::reserve(size_t new_capacity)
+{
+    if (new_capacity > capacity)
+    {
+        reallocate(new_capacity);
+    }
+}
+
+
+template<class T>
+void Array<T>::shrink_to_fit()
+{
+    if (capacity > size)
+    {
+        reallocate(size);
+    }
+}
+
+
+template<class T>
+void Array<T>::set_growth_factor(double factor)
+{
+    if (!(factor > 1.0))
+    {
+        throw std::invalid_argument("Error: Growth factor should be greater than 1.");
+    }
+
+    growth_factor = factor;
+}
+
+
+template<class T>
+double Array<T>::get_growth_factor() const
+{
+    return growth_factor;
+}
+
 
 template<class T>
 void Array<T>::remove(size_t index)
@@ -137,12 +593,64 @@ void Array<T>::remove(size_t index)
         throw std::out_of_range("Error: Index out of range.");
     }
 
-    for (size_t i = index + 1; i < size; ++i)
+    detach();
+    shift_elements(index + 1, index, size - index - 1);
+    release_tail(size - 1);
+}
+
+
+// Удаление за O(1) без сохранения порядка: на место удаленного
+// элемента переносится последний.
+template<class T>
+void Array<T>::swap_remove(size_t index)
+{
+    if (index >= size)
     {
-        array[i - 1] = array[i];
+        throw std::out_of_range("Error: Index out of range.");
     }
 
-    --size;
+    detach();
+    if (index != size - 1)
+    {
+        array[index] = std::move(array[size - 1]);
+    }
+    release_tail(size - 1);
+}
+
+
+// Удаляет элементы из полуинтервала [first, last).
+template<class T>
+void Array<T>::remove_range(size_t first, size_t last)
+{
+    if (first > last || last > size)
+    {
+        throw std::out_of_range("Error: Index out of range.");
+    }
+
+    if (first == last)
+    {
+        return;
+    }
+
+    detach();
+    shift_elements(last, first, size - last);
+    release_tail(size - (last - first));
+}
+
+
+// Удаляет все элементы, для которых predicate вернул true, за один проход
+// с сохранением порядка остальных. Возвращает число удаленных элементов.
+template<class T>
+template<class Predicate>
+size_t Array<T>::erase_if(Predicate predicate)
+{
+    detach();
+    GEOMETRY_INSTRUMENT(InstrumentedOperation::ArrayShift, size);
+    T* end = std::remove_if(array, array + size, predicate);
+    const size_t removed = array + size - end;
+
+    release_tail(end - array);
+    return removed;
 }
 
 
@@ -181,25 +689,103 @@ Array<T>& Array<T>::operator=(const Array& other)
         return *this;
     }
 
-    size = other.size;
-    capacity = other.capacity;
-    array = std::make_shared<T[]>(capacity);
+    if (array == other.array && array != nullptr)
+    {
+        growth_factor = other.growth_factor;
+        return *this;
+    }
 
-    for (size_t i = 0; i < size; ++i)
+    if (allocator == other.allocator)
     {
-        array[i] = other.array[i]; 
+        release_storage();
+        share(other);
+        growth_factor = other.growth_factor;
+        return *this;
     }
-    
+
+    discard_elements();
+
+    if (capacity < other.size)
+    {
+        deallocate_storage(array, capacity);
+        capacity = other.capacity;
+        array = allocate_storage(capacity);
+    }
+
+    copy_elements(other.array, other.size, array);
+    size = other.size;
+    growth_factor = other.growth_factor;
+
     return *this;
 }
 
 
+// С другим ресурсом памяти хранилище забрать нельзя: элементы переносятся
+// по одному (из общего хранилища - копируются) в новое хранилище, и
+// только после успеха массив отпускает старое. Выделение памяти может
+// бросить исключение, поэтому оператор не noexcept.
 template<class T>
-Array<T>& Array<T>::operator=(Array&& other) noexcept
+Array<T>& Array<T>::operator=(Array&& other)
 {
+    if (this == &other)
+    {
+        return *this;
+    }
+
+    if (allocator != other.allocator)
+    {
+        T* new_array = allocate_storage(other.capacity);
+
+        if (bitwise_copyable || other.is_shared())
+        {
+            try
+            {
+                copy_elements(other.array, other.size, new_array);
+            }
+            catch (...)
+            {
+                deallocate_storage(new_array, other.capacity);
+                throw;
+            }
+        }
+        else
+        {
+            size_t constructed = 0;
+
+            try
+            {
+                for (; constructed < other.size; ++constructed)
+                {
+                    allocator_traits::construct(allocator, new_array + constructed, std::move(other.array[constructed]));
+                }
+            }
+            catch (...)
+            {
+                for (size_t i = 0; i < constructed; ++i)
+                {
+                    allocator_traits::destroy(allocator, new_array + i);
+                }
+                deallocate_storage(new_array, other.capacity);
+                throw;
+            }
+        }
+
+        release_storage();
+        array = new_array;
+        size = other.size;
+        capacity = other.capacity;
+        growth_factor = other.growth_factor;
+
+        other.discard_elements();
+        return *this;
+    }
+
+    release_storage();
+
     size = other.size;
     capacity = other.capacity;
-    array = std::move(other.array);
+    growth_factor = other.growth_factor;
+    array = other.array;
 
     other.size = 0;
     other.capacity = 0;
@@ -209,23 +795,85 @@ Array<T>& Array<T>::operator=(Array&& other) noexcept
 }
 
 
+// Массив делится на блоки фиксированного размера, не зависящего от числа
+// потоков. accumulate(R&, const T&) сворачивает блок, combine(R&, const R&)
+// объединяет частичные результаты блоков попарно в фиксированном порядке,
+// поэтому результат побитово одинаков при любом числе рабочих потоков.
+// Единственный блок сворачивается в вызывающем потоке, без пула.
 template<class T>
-void Array<T>::total_area() const
+template<class R, class Accumulate, class Combine>
+R Array<T>::parallel_reduce(ThreadPool& pool, R identity, Accumulate accumulate, Combine combine) const
 {
-    if (size == 0)
+    const size_t blocks = (size + reduce_block_size - 1) / reduce_block_size;
+    if (blocks <= 1)
     {
-        std::cout << "Total area is: 0\n";
-        return;
+        for (size_t i = 0; i < size; ++i)
+        {
+            accumulate(identity, array[i]);
+        }
+        return identity;
     }
 
-    long double total_area = 0.0;
+    std::vector<R> partials(blocks, identity);
 
-    for (size_t i = 0; i < size; ++i)
+    pool.parallel_for(blocks, [&](size_t block)
+    {
+        const size_t first = block * reduce_block_size;
+        const size_t last = std::min(size, first + reduce_block_size);
+
+        R partial = identity;
+        for (size_t i = first; i < last; ++i)
+        {
+            accumulate(partial, array[i]);
+        }
+        partials[block] = std::move(partial);
+    });
+
+    for (size_t step = 1; step < blocks; step *= 2)
     {
-        total_area += static_cast<double>(array);
+        for (size_t i = 0; i + step < blocks; i += 2 * step)
+        {
+            combine(partials[i], partials[i + step]);
+        }
     }
-    
-    std::cout << "Total area is: " << std::setprecision(2) << total_area << std::endl;
+
+    return std::move(partials[0]);
+}
+
+
+template<class T>
+double Array<T>::total_area() const
+{
+    return total_area(size <= reduce_block_size ? inline_thread_pool() : default_thread_pool());
+}
+
+
+template<class T>
+double Array<T>::total_area(ThreadPool& pool) const
+{
+    return parallel_reduce(pool, CompensatedSum(),
+        [](CompensatedSum& sum, const T& element) { sum.add(figure_reference(element).area()); },
+        [](CompensatedSum& sum, const CompensatedSum& other) { sum.merge(other); }).value();
+}
+
+
+template<class T>
+AreaStatistics Array<T>::area_statistics() const
+{
+    return area_statistics(size <= reduce_block_size ? inline_thread_pool() : default_thread_pool());
+}
+
+
+template<class T>
+AreaStatistics Array<T>::area_statistics(ThreadPool& pool) const
+{
+    return parallel_reduce(pool, AreaAccumulator(),
+        [](AreaAccumulator& accumulator, const T& element)
+        {
+            const auto& figure = figure_reference(element);
+            accumulator.add(figure.area(), figure.get_center());
+        },
+        [](AreaAccumulator& accumulator, const AreaAccumulator& other) { accumulator.merge(other); }).result();
 }
 
 
@@ -243,6 +891,95 @@ size_t Array<T>::get_capacity() const
 }
 
 
+template<class T>
+typename Array<T>::allocator_type Array<T>::get_allocator() const
+{
+    return allocator;
+}
+
+
+template<class T>
+bool Array<T>::is_shared() const
+{
+    return array != nullptr && header_of(array)->references.load(std::memory_order_acquire) > 1;
+}
+
+
+// Неизменяемый снимок за O(1): копия с тем же ресурсом памяти, которая
+// делит хранилище, пока одна из сторон не изменится. Снимок берется в
+// потоке писателя, после чего его можно читать из любого потока.
+template<class T>
+Array<T> Array<T>::snapshot() const
+{
+    return Array(*this, allocator);
+}
+
+
+// Без проверок: указатель на size элементов (или nullptr).
+template<class T>
+T* Array<T>::data()
+{
+    detach();
+    return array;
+}
+
+
+template<class T>
+const T* Array<T>::data() const
+{
+    return array;
+}
+
+
+template<class T>
+typename Array<T>::iterator Array<T>::begin()
+{
+    return data();
+}
+
+
+template<class T>
+typename Array<T>::iterator Array<T>::end()
+{
+    return data() + size;
+}
+
+
+template<class T>
+typename Array<T>::const_iterator Array<T>::begin() const
+{
+    return array;
+}
+
+
+template<class T>
+typename Array<T>::const_iterator Array<T>::end() const
+{
+    return array + size;
+}
+
+
+template<class T>
+typename Array<T>::const_iterator Array<T>::cbegin() const
+{
+    return begin();
+}
+
+
+template<class T>
+typename Array<T>::const_iterator Array<T>::cend() const
+{
+    return end();
+}
+
+
+template<class T>
+Array<T>::operator double() const
+{
+    return total_area();
+}
+
+
 template<class T>
 T& Array<T>::operator[](size_t index)
 {
@@ -251,12 +988,13 @@ T& Array<T>::operator[](size_t index)
         throw std::out_of_range("Error: index out of range.");
     }
 
+    detach();
     return array[index];
 }
 
 
 template<class T>
-T Array<T>::operator[](size_t index) const
+const T& Array<T>::operator[](size_t index) const
 {
     if (index < 0 || index >= size)
     {
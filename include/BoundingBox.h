@@ -0,0 +1,101 @@
+#ifndef BOUNDING_BOX_H
+#define BOUNDING_BOX_H
+
+#include "Point.h"
+#include <algorithm>
+
+
+template<Scalar T>
+class BoundingBox final
+{
+public:
+    Point<T> min;
+    Point<T> max;
+
+public:
+    BoundingBox() = default;
+    BoundingBox(Point<T> min, Point<T> max);
+
+public:
+    bool contains(const Point<T>& point) const;
+    bool intersects(const BoundingBox& other) const;
+    void expand(const Point<T>& point);
+    void expand(const BoundingBox& other);
+    double width() const;
+    double height() const;
+    Point<double> center() const;
+    double distance_squared(const Point<double>& point) const;
+};
+
+
+template<Scalar T>
+BoundingBox<T>::BoundingBox(Point<T> min, Point<T> max): min(min), max(max) {}
+
+
+template<Scalar T>
+bool BoundingBox<T>::contains(const Point<T>& point) const
+{
+    return min.x <= point.x && point.x <= max.x && min.y <= point.y && point.y <= max.y;
+}
+
+
+template<Scalar T>
+bool BoundingBox<T>::intersects(const BoundingBox& other) const
+{
+    return min.x <= other.max.x && other.min.x <= max.x && min.y <= other.max.y && other.min.y <= max.y;
+}
+
+
+template<Scalar T>
+void BoundingBox<T>::expand(const Point<T>& point)
+{
+    min.x = std::min(min.x, point.x);
+    min.y = std::min(min.y, point.y);
+    max.x = std::max(max.x, point.x);
+    max.y = std::max(max.y, point.y);
+}
+
+
+template<Scalar T>
+void BoundingBox<T>::expand(const BoundingBox& other)
+{
+    expand(other.min);
+    expand(other.max);
+}
+
+
+template<Scalar T>
+double BoundingBox<T>::width() const
+{
+    return static_cast<double>(max.x) - static_cast<double>(min.x);
+}
+
+
+template<Scalar T>
+double BoundingBox<T>::height() const
+{
+    return static_cast<double>(max.y) - static_cast<double>(min.y);
+}
+
+
+template<Scalar T>
+Point<double> BoundingBox<T>::center() const
+{
+    return Point<double>((static_cast<double>(min.x) + static_cast<double>(max.x)) / 2.0,
+                         (static_cast<double>(min.y) + static_cast<double>(max.y)) / 2.0);
+}
+
+
+
+// Квадрат расстояния от точки до прямоугольника (0, если точка внутри).
+template<Scalar T>
+double BoundingBox<T>::distance_squared(const Point<double>& point) const
+{
+    const double dx = std::max({static_cast<double>(min.x) - point.x, 0.0, point.x - static_cast<double>(max.x)});
+    const double dy = std::max({static_cast<double>(min.y) - point.y, 0.0, point.y - static_cast<double>(max.y)});
+
+    return dx * dx + dy * dy;
+}
+
+
+#endif // BOUNDING_BOX_H
@@ -0,0 +1,159 @@
+#ifndef CACHE_STATISTICS_H
+#define CACHE_STATISTICS_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+
+struct CacheStatistics
+{
+    size_t hits = 0;
+    size_t misses = 0;
+};
+
+
+// Счетчики попаданий в кэш Polygon. Polygon считает их только в сборке
+// с GEOMETRY_INSTRUMENTATION (Instrumentation.h), иначе снимок нулевой.
+// Каждый поток пишет только в свой слот, поэтому параллельное чтение
+// площадей не упирается в одну кэш-линию. При завершении потока его
+// значения переносятся в общий итог, а слот удаляется из реестра.
+// reset() не трогает слоты, а запоминает их текущие значения как точку
+// отсчета, так что приращения других потоков не теряются.
+class PolygonCacheCounters final
+{
+private:
+    struct alignas(64) Slot
+    {
+        std::atomic<size_t> hits = 0;
+        std::atomic<size_t> misses = 0;
+        CacheStatistics baseline;
+    };
+
+    struct Registry
+    {
+        std::mutex mutex;
+        std::vector<Slot*> slots;
+        CacheStatistics retired;
+    };
+
+    // Владеет слотом потока и выписывает его из реестра при выходе потока.
+    class LocalSlot final
+    {
+    private:
+        Slot slot;
+
+    public:
+        LocalSlot();
+        LocalSlot(const LocalSlot& other) = delete;
+        ~LocalSlot() noexcept;
+
+    public:
+        Slot& get();
+        LocalSlot& operator=(const LocalSlot& other) = delete;
+    };
+
+private:
+    static Registry& registry();
+    static Slot& local();
+    static void increment(std::atomic<size_t>& counter);
+
+public:
+    static void hit();
+    static void miss();
+    static CacheStatistics snapshot();
+    static void reset();
+};
+
+
+inline PolygonCacheCounters::LocalSlot::LocalSlot()
+{
+    Registry& shared = registry();
+    std::lock_guard<std::mutex> lock(shared.mutex);
+    shared.slots.push_back(&slot);
+}
+
+
+inline PolygonCacheCounters::LocalSlot::~LocalSlot() noexcept
+{
+    Registry& shared = registry();
+    std::lock_guard<std::mutex> lock(shared.mutex);
+
+    shared.retired.hits += slot.hits.load(std::memory_order_relaxed) - slot.baseline.hits;
+    shared.retired.misses += slot.misses.load(std::memory_order_relaxed) - slot.baseline.misses;
+    shared.slots.erase(std::find(shared.slots.begin(), shared.slots.end(), &slot));
+}
+
+
+inline PolygonCacheCounters::Slot& PolygonCacheCounters::LocalSlot::get()
+{
+    return slot;
+}
+
+
+inline PolygonCacheCounters::Registry& PolygonCacheCounters::registry()
+{
+    static Registry registry;
+    return registry;
+}
+
+
+inline PolygonCacheCounters::Slot& PolygonCacheCounters::local()
+{
+    thread_local LocalSlot slot;
+    return slot.get();
+}
+
+
+// Слот пишет только его поток, поэтому хватает load + store без RMW.
+inline void PolygonCacheCounters::increment(std::atomic<size_t>& counter)
+{
+    counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+
+inline void PolygonCacheCounters::hit()
+{
+    increment(local().hits);
+}
+
+
+inline void PolygonCacheCounters::miss()
+{
+    increment(local().misses);
+}
+
+
+inline CacheStatistics PolygonCacheCounters::snapshot()
+{
+    Registry& shared = registry();
+    std::lock_guard<std::mutex> lock(shared.mutex);
+    CacheStatistics statistics = shared.retired;
+
+    for (const Slot* slot : shared.slots)
+    {
+        statistics.hits += slot->hits.load(std::memory_order_relaxed) - slot->baseline.hits;
+        statistics.misses += slot->misses.load(std::memory_order_relaxed) - slot->baseline.misses;
+    }
+
+    return statistics;
+}
+
+
+inline void PolygonCacheCounters::reset()
+{
+    Registry& shared = registry();
+    std::lock_guard<std::mutex> lock(shared.mutex);
+
+    shared.retired = CacheStatistics();
+    for (Slot* slot : shared.slots)
+    {
+        slot->baseline.hits = slot->hits.load(std::memory_order_relaxed);
+        slot->baseline.misses = slot->misses.load(std::memory_order_relaxed);
+    }
+}
+
+
+#endif // CACHE_STATISTICS_H
@@ -0,0 +1,576 @@
+#ifndef CONCURRENT_ARRAY_H
+#define CONCURRENT_ARRAY_H
+
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <iterator>
+#include <memory_resource>
+#include <mutex>
+#include <new>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+// Массив для одновременного добавления из нескольких потоков.
+//
+// Элементы лежат в сегментах растущего размера (base, 2 * base,
+// 4 * base, ...) и после добавления никогда не перемещаются. append
+// занимает индекс через CAS, когда сегмент под него уже выделен, и
+// строит элемент, не дожидаясь других писателей; ждать приходится,
+// только если нужный сегмент еще выделяется (сегменты выделяются на шаг
+// вперед, так что это редкость).
+// operator[] и for_each не блокируются и не ждут: видны первые
+// get_size() элементов - те, что уже построены целиком. После
+// добавления элементы только читаются.
+//
+// compact() собирает элементы в один сегмент. Его нельзя вызывать
+// одновременно с append, но читатели могут продолжать работу, если
+// вошли через pin(): прежние сегменты освобождаются, только когда
+// выйдут все читатели, закрепившиеся до замены. Без compact() pin()
+// не нужен. Поток, сам держащий ReadGuard этого массива, вызвать
+// compact() не может: он ждал бы сам себя, поэтому compact() в таком
+// случае бросает std::logic_error. Для этой проверки ReadGuard нужно
+// освобождать в том же потоке, где он получен.
+template<class T>
+class ConcurrentArray final
+{
+public:
+    using allocator_type = std::pmr::polymorphic_allocator<std::byte>;
+    constexpr static size_t default_segment_size = 64;
+
+    class ReadGuard;
+
+private:
+    struct Slot
+    {
+        alignas(T) std::byte storage[sizeof(T)];
+        std::atomic<bool> ready = false;
+    };
+
+    constexpr static size_t max_segments = 48;
+
+    // Сегмент k вмещает 2^(base_bits + k) элементов.
+    struct Table
+    {
+        size_t base_bits = 0;
+        std::atomic<Slot*> segments[max_segments] = {};
+        std::atomic<bool> allocating[max_segments] = {};
+    };
+
+private:
+    allocator_type allocator;
+    size_t min_base_bits;
+    std::atomic<Table*> table;
+    std::atomic<size_t> claimed = 0;
+    std::atomic<size_t> published = 0;
+    std::atomic<size_t> epoch = 0;
+    mutable std::atomic<size_t> readers[2] = {};
+    std::mutex compact_mutex;
+
+private:
+    static std::vector<const ConcurrentArray*>& pinned_by_thread();
+    static T& value_of(Slot& slot);
+    static size_t segment_of(const Table& table, size_t index, size_t& offset);
+    Table* allocate_table(size_t base_bits);
+    Slot* allocate_segment(size_t count);
+    void destroy_table(Table* table, size_t count) noexcept;
+    Slot* ensure_segment(Table& current, size_t segment, bool wait);
+    Slot& claim_slot(size_t& index);
+    void advance_published(size_t position);
+    void publish(Slot& slot, size_t index);
+    template<class... Args>
+    size_t construct_back(Args&&... args);
+
+public:
+    explicit ConcurrentArray(size_t segment_size = default_segment_size, const allocator_type& allocator = allocator_type());
+    ConcurrentArray(const ConcurrentArray& other) = delete;
+    ~ConcurrentArray() noexcept;
+
+public:
+    size_t append(const T& figure);
+    size_t append(T&& figure);
+    template<class... Args>
+    size_t emplace_back(Args&&... args);
+    template<class Callback>
+    void for_each(Callback callback) const;
+    void compact();
+    ReadGuard pin() const;
+    size_t get_size() const;
+    size_t segment_count() const;
+    allocator_type get_allocator() const;
+
+public:
+    ConcurrentArray& operator=(const ConcurrentArray& other) = delete;
+    const T& operator[](size_t index) const;
+};
+
+
+// Пока жив, compact() не освобождает сегменты, видимые читателю.
+template<class T>
+class ConcurrentArray<T>::ReadGuard final
+{
+private:
+    const ConcurrentArray* owner = nullptr;
+    std::atomic<size_t>* readers = nullptr;
+
+public:
+    ReadGuard(const ConcurrentArray* owner, std::atomic<size_t>* readers);
+    ReadGuard(ReadGuard&& other) noexcept;
+    ~ReadGuard() noexcept;
+
+public:
+    ReadGuard& operator=(ReadGuard&& other) = delete;
+};
+
+
+// Массивы, закрепленные текущим потоком через pin().
+template<class T>
+std::vector<const ConcurrentArray<T>*>& ConcurrentArray<T>::pinned_by_thread()
+{
+    thread_local std::vector<const ConcurrentArray*> pinned;
+    return pinned;
+}
+
+
+template<class T>
+T& ConcurrentArray<T>::value_of(Slot& slot)
+{
+    return *std::launder(reinterpret_cast<T*>(slot.storage));
+}
+
+
+template<class T>
+size_t ConcurrentArray<T>::segment_of(const Table& table, size_t index, size_t& offset)
+{
+    const size_t shifted = index + (size_t(1) << table.base_bits);
+    const size_t segment = std::bit_width(shifted) - 1 - table.base_bits;
+
+    offset = shifted - (size_t(1) << (segment + table.base_bits));
+    return segment;
+}
+
+
+template<class T>
+typename ConcurrentArray<T>::Table* ConcurrentArray<T>::allocate_table(size_t base_bits)
+{
+    Table* fresh = allocator.template new_object<Table>();
+    fresh->base_bits = base_bits;
+    return fresh;
+}
+
+
+template<class T>
+typename ConcurrentArray<T>::Slot* ConcurrentArray<T>::allocate_segment(size_t count)
+{
+    Slot* segment = allocator.template allocate_object<Slot>(count);
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        ::new (segment + i) Slot;
+    }
+
+    return segment;
+}
+
+
+// Уничтожает первые count элементов и освобождает сегменты и таблицу.
+template<class T>
+void ConcurrentArray<T>::destroy_table(Table* old, size_t count) noexcept
+{
+    for (size_t k = 0; k < max_segments; ++k)
+    {
+        Slot* segment = old->segments[k].load(std::memory_order_relaxed);
+        const size_t segment_size = size_t(1) << (old->base_bits + k);
+
+        if (segment != nullptr)
+        {
+            std::for_each_n(segment, std::min(count, segment_size), [](Slot& slot) { value_of(slot).~T(); });
+            allocator.deallocate_object(segment, segment_size);
+        }
+        count -= std::min(count, segment_size);
+    }
+
+    allocator.delete_object(old);
+}
+
+
+// Сегмент выделяет первый, кто до него дошел; остальные уступают
+// процессор, пока он не появится, а не строят свои копии. При wait =
+// false занятый другим потоком сегмент не ждут и возвращают nullptr.
+template<class T>
+typename ConcurrentArray<T>::Slot* ConcurrentArray<T>::ensure_segment(Table& current, size_t segment, bool wait)
+{
+    Slot* slots = current.segments[segment].load();
+
+    while (slots == nullptr)
+    {
+        if (!current.allocating[segment].exchange(true))
+        {
+            slots = current.segments[segment].load();
+            if (slots == nullptr)
+            {
+                try
+                {
+                    slots = allocate_segment(size_t(1) << (current.base_bits + segment));
+                }
+                catch (...)
+                {
+                    current.allocating[segment].store(false);
+                    throw;
+                }
+                current.segments[segment].store(slots);
+            }
+            break;
+        }
+
+        if (!wait)
+        {
+            break;
+        }
+        std::this_thread::yield();
+        slots = current.segments[segment].load();
+    }
+
+    return slots;
+}
+
+
+// Занимает следующий индекс и возвращает его ячейку. Сегмент под индекс
+// (а на первом индексе сегмента и следующий) выделяется до того, как
+// индекс занят: если выделение бросит исключение, индекс останется
+// свободным, и граница видимых элементов на нем не остановится.
+template<class T>
+typename ConcurrentArray<T>::Slot& ConcurrentArray<T>::claim_slot(size_t& index)
+{
+    Table& current = *table.load(std::memory_order_acquire);
+    index = claimed.load();
+
+    for (;;)
+    {
+        size_t offset;
+        const size_t segment = segment_of(current, index, offset);
+
+        if (segment >= max_segments)
+        {
+            throw std::length_error("Error: Concurrent array is full.");
+        }
+
+        Slot* slots = ensure_segment(current, segment, true);
+        if (offset == 0 && segment + 1 < max_segments)
+        {
+            ensure_segment(current, segment + 1, false);
+        }
+
+        if (claimed.compare_exchange_weak(index, index + 1))
+        {
+            return slots[offset];
+        }
+    }
+}
+
+
+// Сдвигает published за готовые подряд элементы начиная с position:
+// граница переносится одним CAS через всю найденную серию, и после
+// каждого переноса поиск повторяется. Все операции seq_cst: иначе два
+// писателя могли бы одновременно не увидеть готовность друг друга
+// и граница бы застряла.
+template<class T>
+void ConcurrentArray<T>::advance_published(size_t position)
+{
+    const Table& current = *table.load(std::memory_order_acquire);
+
+    for (;;)
+    {
+        const size_t limit = claimed.load();
+        size_t end = position;
+
+        while (end < limit)
+        {
+            size_t offset;
+            const Slot* slots = current.segments[segment_of(current, end, offset)].load();
+
+            if (slots == nullptr || !slots[offset].ready.load())
+            {
+                break;
+            }
+            ++end;
+        }
+
+        if (end == position)
+        {
+            return;
+        }
+
+        if (published.compare_exchange_strong(position, end))
+        {
+            position = end;
+        }
+    }
+}
+
+
+// Писатель, чей элемент следующий за границей, сдвигает ее сам одним
+// CAS; иначе отмечает элемент готовым, и границу за него сдвинет тот,
+// кто дойдет до него, либо он сам, если предыдущие уже готовы.
+template<class T>
+void ConcurrentArray<T>::publish(Slot& slot, size_t index)
+{
+    size_t expected = index;
+
+    if (published.compare_exchange_strong(expected, index + 1))
+    {
+        advance_published(index + 1);
+        return;
+    }
+
+    slot.ready.store(true);
+    advance_published(published.load());
+}
+
+
+// Элемент строится до выдачи индекса, если его конструктор может
+// бросить исключение: выданный индекс обязан стать готовым, иначе
+// граница видимых элементов на нем остановится.
+template<class T>
+template<class... Args>
+size_t ConcurrentArray<T>::construct_back(Args&&... args)
+{
+    if constexpr (std::is_nothrow_constructible_v<T, Args&&...>)
+    {
+        size_t index;
+        Slot& slot = claim_slot(index);
+
+        ::new (slot.storage) T(std::forward<Args>(args)...);
+        publish(slot, index);
+        return index;
+    }
+    else
+    {
+        static_assert(std::is_nothrow_move_constructible_v<T>, "ConcurrentArray requires a noexcept move constructor.");
+
+        T value(std::forward<Args>(args)...);
+        return construct_back(std::move(value));
+    }
+}
+
+
+template<class T>
+ConcurrentArray<T>::ConcurrentArray(size_t segment_size, const allocator_type& allocator):
+    allocator(allocator), min_base_bits(std::countr_zero(std::bit_ceil(std::max<size_t>(segment_size, 1))))
+{
+    table.store(allocate_table(min_base_bits));
+}
+
+
+template<class T>
+ConcurrentArray<T>::~ConcurrentArray() noexcept
+{
+    destroy_table(table.load(), published.load());
+}
+
+
+template<class T>
+size_t ConcurrentArray<T>::append(const T& figure)
+{
+    return construct_back(figure);
+}
+
+
+template<class T>
+size_t ConcurrentArray<T>::append(T&& figure)
+{
+    return construct_back(std::move(figure));
+}
+
+
+// Возвращает индекс нового элемента.
+template<class T>
+template<class... Args>
+size_t ConcurrentArray<T>::emplace_back(Args&&... args)
+{
+    return construct_back(std::forward<Args>(args)...);
+}
+
+
+// Обходит первые get_size() элементов по сегментам, без вычисления
+// положения каждого индекса.
+template<class T>
+template<class Callback>
+void ConcurrentArray<T>::for_each(Callback callback) const
+{
+    size_t remaining = published.load(std::memory_order_acquire);
+    const Table& current = *table.load(std::memory_order_acquire);
+
+    for (size_t k = 0; remaining > 0; ++k)
+    {
+        Slot* slots = current.segments[k].load(std::memory_order_acquire);
+        const size_t count = std::min(remaining, size_t(1) << (current.base_bits + k));
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            callback(static_cast<const T&>(value_of(slots[i])));
+        }
+        remaining -= count;
+    }
+}
+
+
+// Копирует элементы в один сегмент подходящего размера и подменяет
+// таблицу. Старая таблица освобождается после смены эпохи, когда
+// закрепленных в прежней эпохе читателей не останется.
+template<class T>
+void ConcurrentArray<T>::compact()
+{
+    const std::vector<const ConcurrentArray*>& pinned = pinned_by_thread();
+    if (std::find(pinned.begin(), pinned.end(), this) != pinned.end())
+    {
+        throw std::logic_error("Error: Cannot compact while the calling thread holds a ReadGuard.");
+    }
+
+    std::lock_guard<std::mutex> lock(compact_mutex);
+
+    Table* old = table.load();
+    const size_t count = published.load();
+    const size_t base_bits = std::max<size_t>(min_base_bits, std::countr_zero(std::bit_ceil(std::max<size_t>(count, 1))));
+
+    if (old->base_bits == base_bits && old->segments[1].load() == nullptr)
+    {
+        return;
+    }
+
+    Table* fresh = allocate_table(base_bits);
+    Slot* slots = allocate_segment(size_t(1) << base_bits);
+    fresh->segments[0].store(slots, std::memory_order_relaxed);
+
+    size_t index = 0;
+    try
+    {
+        for_each([&](const T& figure)
+        {
+            ::new (slots[index].storage) T(figure);
+            ++index;
+        });
+    }
+    catch (...)
+    {
+        destroy_table(fresh, index);
+        throw;
+    }
+
+    table.store(fresh);
+
+    const size_t previous = epoch.fetch_add(1);
+    while (readers[previous & 1].load() != 0)
+    {
+        std::this_thread::yield();
+    }
+
+    destroy_table(old, count);
+}
+
+
+// Повторная проверка эпохи отсекает читателя, который успел прочитать
+// старую эпоху, но зарегистрировался уже после ее смены.
+template<class T>
+typename ConcurrentArray<T>::ReadGuard ConcurrentArray<T>::pin() const
+{
+    for (;;)
+    {
+        const size_t current = epoch.load();
+        readers[current & 1].fetch_add(1);
+
+        if (epoch.load() == current)
+        {
+            return ReadGuard(this, &readers[current & 1]);
+        }
+
+        readers[current & 1].fetch_sub(1);
+    }
+}
+
+
+template<class T>
+size_t ConcurrentArray<T>::get_size() const
+{
+    return published.load(std::memory_order_acquire);
+}
+
+
+template<class T>
+size_t ConcurrentArray<T>::segment_count() const
+{
+    const Table& current = *table.load(std::memory_order_acquire);
+
+    return std::count_if(std::begin(current.segments), std::end(current.segments),
+                         [](const std::atomic<Slot*>& segment) { return segment.load(std::memory_order_acquire) != nullptr; });
+}
+
+
+template<class T>
+typename ConcurrentArray<T>::allocator_type ConcurrentArray<T>::get_allocator() const
+{
+    return allocator;
+}
+
+
+template<class T>
+const T& ConcurrentArray<T>::operator[](size_t index) const
+{
+    if (index >= published.load(std::memory_order_acquire))
+    {
+        throw std::out_of_range("Error: Index out of range.");
+    }
+
+    const Table& current = *table.load(std::memory_order_acquire);
+    size_t offset;
+    const size_t segment = segment_of(current, index, offset);
+
+    return value_of(current.segments[segment].load(std::memory_order_acquire)[offset]);
+}
+
+
+template<class T>
+ConcurrentArray<T>::ReadGuard::ReadGuard(const ConcurrentArray* owner, std::atomic<size_t>* readers): owner(owner), readers(readers)
+{
+    try
+    {
+        pinned_by_thread().push_back(owner);
+    }
+    catch (...)
+    {
+        readers->fetch_sub(1);
+        throw;
+    }
+}
+
+
+template<class T>
+ConcurrentArray<T>::ReadGuard::ReadGuard(ReadGuard&& other) noexcept
+    : owner(other.owner), readers(std::exchange(other.readers, nullptr)) {}
+
+
+template<class T>
+ConcurrentArray<T>::ReadGuard::~ReadGuard() noexcept
+{
+    if (readers == nullptr)
+    {
+        return;
+    }
+
+    std::vector<const ConcurrentArray*>& pinned = pinned_by_thread();
+    const auto entry = std::find(pinned.rbegin(), pinned.rend(), owner);
+    if (entry != pinned.rend())
+    {
+        pinned.erase(std::next(entry).base());
+    }
+    readers->fetch_sub(1);
+}
+
+
+#endif // CONCURRENT_ARRAY_H
@@ -0,0 +1,55 @@
+#ifndef FIGURE_KIND_H
+#define FIGURE_KIND_H
+
+
+#include <cstddef>
+#include <optional>
+#include <string_view>
+
+
+enum class FigureKind : unsigned char
+{
+    Polygon,
+    Rectangle,
+    Rhombus,
+    Trapezoid
+};
+
+
+constexpr size_t figure_kind_count = 4;
+
+
+inline std::string_view figure_kind_name(FigureKind kind)
+{
+    switch (kind)
+    {
+        case FigureKind::Rectangle: return "rectangle";
+        case FigureKind::Rhombus: return "rhombus";
+        case FigureKind::Trapezoid: return "trapezoid";
+        default: return "polygon";
+    }
+}
+
+
+inline std::optional<FigureKind> parse_figure_kind(std::string_view name)
+{
+    for (size_t i = 0; i < figure_kind_count; ++i)
+    {
+        if (figure_kind_name(static_cast<FigureKind>(i)) == name)
+        {
+            return static_cast<FigureKind>(i);
+        }
+    }
+
+    return std::nullopt;
+}
+
+
+// Многоугольник имеет не меньше 3 вершин, четырехугольники - ровно 4.
+constexpr bool is_valid_vertex_count(FigureKind kind, size_t count)
+{
+    return kind == FigureKind::Polygon ? count >= 3 : count == 4;
+}
+
+
+#endif // FIGURE_KIND_H
@@ -0,0 +1,415 @@
+#ifndef FIGURE_STORE_H
+#define FIGURE_STORE_H
+
+
+#include "AreaBatch.h"
+#include "FigureKind.h"
+#include "Point.h"
+#include "Polygon.h"
+#include "Rectangle.h"
+#include "Rhombus.h"
+#include "Trapezoid.h"
+#include <algorithm>
+#include <cstddef>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+
+// Невладеющее представление одной фигуры из FigureStore.
+// Действительно, пока хранилище не изменяется.
+template<Scalar T>
+class PolygonView final
+{
+private:
+    const T* xs;
+    const T* ys;
+    size_t size;
+    FigureKind kind;
+
+public:
+    PolygonView(const T* xs, const T* ys, size_t size, FigureKind kind);
+
+public:
+    double area() const;
+    Point<double> get_center() const;
+    size_t vertex_count() const;
+    Point<T> get_vertex(size_t index) const;
+    FigureKind get_kind() const;
+    Polygon<T> to_polygon() const;
+    explicit operator double() const;
+};
+
+
+// Колоночное хранилище фигур: координаты всех вершин лежат подряд
+// в массивах x[] и y[], фигура описывается смещением, числом вершин и типом.
+template<Scalar T>
+class FigureStore final
+{
+private:
+    std::vector<T> xs;
+    std::vector<T> ys;
+    std::vector<size_t> offsets;
+    std::vector<size_t> counts;
+    std::vector<FigureKind> kinds;
+
+private:
+    void append_vertices(const Polygon<T>& polygon, FigureKind kind);
+
+public:
+    FigureStore() = default;
+    FigureStore(const FigureStore& other) = default;
+    FigureStore(FigureStore&& other) noexcept = default;
+    ~FigureStore() noexcept = default;
+
+public:
+    FigureStore& append(const Polygon<T>& polygon);
+    FigureStore& append(const Rectangle<T>& rectangle);
+    FigureStore& append(const Rhombus<T>& rhombus);
+    FigureStore& append(const Trapezoid<T>& trapezoid);
+    FigureStore& append(FigureKind kind, std::span<const T> x_values, std::span<const T> y_values);
+    void remove(size_t index);
+    void reserve(size_t figures, size_t vertices);
+    void clear();
+    size_t get_size() const;
+    size_t total_vertices() const;
+    double area(size_t index) const;
+    double total_area() const;
+    void areas(std::span<double> out) const;
+    void centers(std::span<Point<double>> out) const;
+
+public:
+    std::span<const T> x_coordinates() const;
+    std::span<const T> y_coordinates() const;
+    std::span<const size_t> vertex_offsets() const;
+    std::span<const size_t> vertex_counts() const;
+    std::span<const FigureKind> figure_kinds() const;
+
+public:
+    FigureStore& operator=(const FigureStore& other) = default;
+    FigureStore& operator=(FigureStore&& other) noexcept = default;
+    PolygonView<T> operator[](size_t index) const;
+};
+
+
+template<Scalar T>
+PolygonView<T>::PolygonView(const T* xs, const T* ys, size_t size, FigureKind kind): xs(xs), ys(ys), size(size), kind(kind) {}
+
+
+template<Scalar T>
+double PolygonView<T>::area() const
+{
+    return shoelace_area(xs, ys, size);
+}
+
+
+template<Scalar T>
+Point<double> PolygonView<T>::get_center() const
+{
+    double x_center = 0.0;
+    double y_center = 0.0;
+
+    for (size_t i = 0; i < size; ++i)
+    {
+        x_center += static_cast<double>(xs[i]);
+        y_center += static_cast<double>(ys[i]);
+    }
+
+    return Point<double>(x_center / size, y_center / size);
+}
+
+
+template<Scalar T>
+size_t PolygonView<T>::vertex_count() const
+{
+    return size;
+}
+
+
+template<Scalar T>
+Point<T> PolygonView<T>::get_vertex(size_t index) const
+{
+    if (index >= size)
+    {
+        throw std::out_of_range("Error: index out of range.");
+    }
+
+    return Point<T>(xs[index], ys[index]);
+}
+
+
+template<Scalar T>
+FigureKind PolygonView<T>::get_kind() const
+{
+    return kind;
+}
+
+
+template<Scalar T>
+Polygon<T> PolygonView<T>::to_polygon() const
+{
+    Polygon<T> polygon(size);
+
+    for (size_t i = 0; i < size; ++i)
+    {
+        polygon.set_vertex(i, Point<T>(xs[i], ys[i]));
+    }
+
+    return polygon;
+}
+
+
+template<Scalar T>
+PolygonView<T>::operator double() const
+{
+    return this->area();
+}
+
+
+template<Scalar T>
+void FigureStore<T>::append_vertices(const Polygon<T>& polygon, FigureKind kind)
+{
+    const size_t count = polygon.vertex_count();
+    if (count == 0)
+    {
+        throw std::invalid_argument("Error: Cannot store a polygon without vertices.");
+    }
+
+    offsets.push_back(xs.size());
+    counts.push_back(count);
+    kinds.push_back(kind);
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        Point<T> vertex = polygon.get_vertex(i);
+        xs.push_back(vertex.x);
+        ys.push_back(vertex.y);
+    }
+}
+
+
+template<Scalar T>
+FigureStore<T>& FigureStore<T>::append(const Polygon<T>& polygon)
+{
+    append_vertices(polygon, FigureKind::Polygon);
+    return *this;
+}
+
+
+template<Scalar T>
+FigureStore<T>& FigureStore<T>::append(const Rectangle<T>& rectangle)
+{
+    append_vertices(rectangle, FigureKind::Rectangle);
+    return *this;
+}
+
+
+template<Scalar T>
+FigureStore<T>& FigureStore<T>::append(const Rhombus<T>& rhombus)
+{
+    append_vertices(rhombus, FigureKind::Rhombus);
+    return *this;
+}
+
+
+template<Scalar T>
+FigureStore<T>& FigureStore<T>::append(const Trapezoid<T>& trapezoid)
+{
+    append_vertices(trapezoid, FigureKind::Trapezoid);
+    return *this;
+}
+
+
+// Добавление фигуры сразу из координат, без промежуточного Polygon.
+// Число вершин проверяется по виду фигуры так же, как при чтении сцены,
+// чтобы write_scene не записал файл, который SceneView отвергнет.
+template<Scalar T>
+FigureStore<T>& FigureStore<T>::append(FigureKind kind, std::span<const T> x_values, std::span<const T> y_values)
+{
+    if (x_values.empty() || x_values.size() != y_values.size())
+    {
+        throw std::invalid_argument("Error: Coordinate spans should be non-empty and of equal size.");
+    }
+    if (!is_valid_vertex_count(kind, x_values.size()))
+    {
+        throw std::invalid_argument("Error: Vertex count does not match figure kind.");
+    }
+
+    offsets.push_back(xs.size());
+    counts.push_back(x_values.size());
+    kinds.push_back(kind);
+
+    xs.insert(xs.end(), x_values.begin(), x_values.end());
+    ys.insert(ys.end(), y_values.begin(), y_values.end());
+
+    return *this;
+}
+
+
+template<Scalar T>
+void FigureStore<T>::remove(size_t index)
+{
+    if (index >= offsets.size())
+    {
+        throw std::out_of_range("Error: Index out of range.");
+    }
+
+    const size_t first = offsets[index];
+    const size_t count = counts[index];
+
+    xs.erase(xs.begin() + first, xs.begin() + first + count);
+    ys.erase(ys.begin() + first, ys.begin() + first + count);
+
+    offsets.erase(offsets.begin() + index);
+    counts.erase(counts.begin() + index);
+    kinds.erase(kinds.begin() + index);
+
+    for (size_t i = index; i < offsets.size(); ++i)
+    {
+        offsets[i] -= count;
+    }
+}
+
+
+template<Scalar T>
+void FigureStore<T>::reserve(size_t figures, size_t vertices)
+{
+    xs.reserve(vertices);
+    ys.reserve(vertices);
+    offsets.reserve(figures);
+    counts.reserve(figures);
+    kinds.reserve(figures);
+}
+
+
+template<Scalar T>
+void FigureStore<T>::clear()
+{
+    xs.clear();
+    ys.clear();
+    offsets.clear();
+    counts.clear();
+    kinds.clear();
+}
+
+
+template<Scalar T>
+size_t FigureStore<T>::get_size() const
+{
+    return offsets.size();
+}
+
+
+template<Scalar T>
+size_t FigureStore<T>::total_vertices() const
+{
+    return xs.size();
+}
+
+
+template<Scalar T>
+double FigureStore<T>::area(size_t index) const
+{
+    return (*this)[index].area();
+}
+
+
+template<Scalar T>
+double FigureStore<T>::total_area() const
+{
+    constexpr size_t chunk = 256;
+    double buffer[chunk];
+    double total_area = 0.0;
+
+    for (size_t first = 0; first < offsets.size(); first += chunk)
+    {
+        const size_t count = std::min(chunk, offsets.size() - first);
+        ::area_batch(xs.data(), ys.data(), vertex_offsets().subspan(first, count), vertex_counts().subspan(first, count), std::span<double>(buffer, count));
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            total_area += buffer[i];
+        }
+    }
+
+    return total_area;
+}
+
+
+template<Scalar T>
+void FigureStore<T>::areas(std::span<double> out) const
+{
+    ::area_batch(xs.data(), ys.data(), vertex_offsets(), vertex_counts(), out);
+}
+
+
+template<Scalar T>
+void FigureStore<T>::centers(std::span<Point<double>> out) const
+{
+    if (out.size() < offsets.size())
+    {
+        throw std::invalid_argument("Error: Output span is smaller than the number of figures.");
+    }
+
+    for (size_t i = 0; i < offsets.size(); ++i)
+    {
+        out[i] = PolygonView<T>(xs.data() + offsets[i], ys.data() + offsets[i], counts[i], kinds[i]).get_center();
+    }
+}
+
+
+template<Scalar T>
+std::span<const T> FigureStore<T>::x_coordinates() const
+{
+    return std::span<const T>(xs);
+}
+
+
+template<Scalar T>
+std::span<const T> FigureStore<T>::y_coordinates() const
+{
+    return std::span<const T>(ys);
+}
+
+
+template<Scalar T>
+std::span<const size_t> FigureStore<T>::vertex_offsets() const
+{
+    return std::span<const size_t>(offsets);
+}
+
+
+template<Scalar T>
+std::span<const size_t> FigureStore<T>::vertex_counts() const
+{
+    return std::span<const size_t>(counts);
+}
+
+
+template<Scalar T>
+std::span<const FigureKind> FigureStore<T>::figure_kinds() const
+{
+    return std::span<const FigureKind>(kinds);
+}
+
+
+template<Scalar T>
+PolygonView<T> FigureStore<T>::operator[](size_t index) const
+{
+    if (index >= offsets.size())
+    {
+        throw std::out_of_range("Error: index out of range.");
+    }
+
+    return PolygonView<T>(xs.data() + offsets[index], ys.data() + offsets[index], counts[index], kinds[index]);
+}
+
+
+template<Scalar T>
+void area_batch(const FigureStore<T>& store, std::span<double> out)
+{
+    store.areas(out);
+}
+
+
+#endif // FIGURE_STORE_H
@@ -0,0 +1,434 @@
+#ifndef FIGURE_STREAM_H
+#define FIGURE_STREAM_H
+
+
+#include "FigureKind.h"
+#include "FigureStore.h"
+#include "Reduction.h"
+#include "SceneFile.h"
+#include "TextCodec.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <istream>
+#include <iterator>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+
+// Разбирает записи текстового формата сцены ("kind n x0 y0 ...") из
+// [first, last) и дописывает их в store. first_record нужен только
+// для номера записи в сообщении об ошибке. Возвращает число записей.
+template<SceneScalar T>
+size_t parse_scene_records(const char* first, const char* last, FigureStore<T>& store, size_t first_record = 0)
+{
+    std::vector<T> xs;
+    std::vector<T> ys;
+    size_t records = 0;
+
+    auto malformed = [&]()
+    {
+        return std::runtime_error("Error: Malformed figure record " + std::to_string(first_record + records) + ".");
+    };
+
+    for (const char* cursor = skip_text_space(first, last); cursor != last; cursor = skip_text_space(cursor, last))
+    {
+        const char* name_end = std::find_if(cursor, last, is_text_space);
+        const std::optional<FigureKind> kind = parse_figure_kind(std::string_view(cursor, name_end - cursor));
+        size_t count = 0;
+
+        cursor = scan_number(name_end, last, count);
+        if (!kind || !cursor || count == 0)
+        {
+            throw malformed();
+        }
+        check_scene_vertex_count(*kind, count, first_record + records);
+
+        xs.clear();
+        ys.clear();
+        for (size_t i = 0; i < count && cursor; ++i)
+        {
+            T x;
+            T y;
+            cursor = scan_number(cursor, last, x);
+            cursor = cursor ? scan_number(cursor, last, y) : nullptr;
+            xs.push_back(x);
+            ys.push_back(y);
+        }
+
+        if (!cursor)
+        {
+            throw malformed();
+        }
+
+        store.append(*kind, xs, ys);
+        ++records;
+    }
+
+    return records;
+}
+
+
+// Потоковое чтение сцены в текстовом формате из файла или stdin.
+// Отдельный поток читает вход блоками по chunk_size байт, разбирает
+// целые строки в пачки FigureStore и складывает их в очередь глубиной
+// queue_depth. Потребитель получает фигуры как PolygonView через next(),
+// for_each или обход диапазоном. Пачки переиспользуются, поэтому
+// память ограничена примерно (queue_depth + 2) * max(chunk_size, L)
+// независимо от длины входа, где L - длина самой длинной строки: строка
+// длиннее chunk_size накапливается в буфере целиком, пока не встретится
+// '\n'. Каждая запись должна занимать свою строку, как пишет
+// write_scene_text.
+template<SceneScalar T>
+class FigureStreamReader final
+{
+public:
+    constexpr static size_t default_chunk_size = size_t(1) << 20;
+    constexpr static size_t default_queue_depth = 4;
+
+    class iterator;
+
+private:
+    std::istream& istream;
+    size_t chunk_size;
+    size_t queue_depth;
+    std::mutex mutex;
+    std::condition_variable ready;
+    std::condition_variable space;
+    std::deque<FigureStore<T>> batches;
+    std::vector<FigureStore<T>> spare;
+    std::exception_ptr error;
+    bool finished = false;
+    std::atomic<bool> stopping = false;
+    std::atomic<size_t> bytes = 0;
+    FigureStore<T> current;
+    size_t position = 0;
+    std::thread reader;
+
+private:
+    FigureStore<T> take_spare();
+    bool publish(FigureStore<T>&& batch);
+    void produce();
+    bool fetch();
+
+public:
+    explicit FigureStreamReader(std::istream& istream, size_t chunk_size = default_chunk_size, size_t queue_depth = default_queue_depth);
+    FigureStreamReader(const FigureStreamReader& other) = delete;
+    ~FigureStreamReader() noexcept;
+
+public:
+    std::optional<PolygonView<T>> next();
+    template<class Callback>
+    size_t for_each(Callback callback);
+    size_t bytes_read() const;
+    iterator begin();
+    std::default_sentinel_t end();
+
+public:
+    FigureStreamReader& operator=(const FigureStreamReader& other) = delete;
+};
+
+
+// Однопроходный итератор; представление действительно до следующего шага.
+template<SceneScalar T>
+class FigureStreamReader<T>::iterator final
+{
+public:
+    using iterator_category = std::input_iterator_tag;
+    using value_type = PolygonView<T>;
+    using difference_type = std::ptrdiff_t;
+
+private:
+    FigureStreamReader* stream = nullptr;
+    std::optional<PolygonView<T>> figure;
+
+public:
+    iterator() = default;
+    explicit iterator(FigureStreamReader* stream);
+
+public:
+    const PolygonView<T>& operator*() const;
+    const PolygonView<T>* operator->() const;
+    iterator& operator++();
+    void operator++(int);
+    bool operator==(std::default_sentinel_t) const;
+};
+
+
+template<SceneScalar T>
+FigureStore<T> FigureStreamReader<T>::take_spare()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    if (spare.empty())
+    {
+        return FigureStore<T>();
+    }
+
+    FigureStore<T> batch = std::move(spare.back());
+    spare.pop_back();
+    batch.clear();
+    return batch;
+}
+
+
+template<SceneScalar T>
+bool FigureStreamReader<T>::publish(FigureStore<T>&& batch)
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    space.wait(lock, [this] { return stopping.load() || batches.size() < queue_depth; });
+
+    if (stopping.load())
+    {
+        return false;
+    }
+
+    batches.push_back(std::move(batch));
+    ready.notify_one();
+    return true;
+}
+
+
+// Тело потока чтения. Хвост блока после последнего '\n' переносится
+// в начало следующего, так что разбираются только целые строки.
+template<SceneScalar T>
+void FigureStreamReader<T>::produce()
+{
+    try
+    {
+        std::string buffer;
+        size_t records = 0;
+        bool at_end = false;
+
+        while (!at_end && !stopping.load())
+        {
+            const size_t carried = buffer.size();
+            buffer.resize(carried + chunk_size);
+            istream.read(buffer.data() + carried, static_cast<std::streamsize>(chunk_size));
+
+            const size_t received = static_cast<size_t>(istream.gcount());
+            buffer.resize(carried + received);
+            bytes.fetch_add(received, std::memory_order_relaxed);
+            at_end = received < chunk_size;
+
+            size_t end = buffer.size();
+            if (!at_end)
+            {
+                const size_t newline = buffer.rfind('\n');
+                if (newline == std::string::npos)
+                {
+                    continue;
+                }
+                end = newline + 1;
+            }
+
+            // Записи блока до ошибочной публикуются, и только потом
+            // ошибка передается потребителю
+            FigureStore<T> batch = take_spare();
+            try
+            {
+                records += parse_scene_records(buffer.data(), buffer.data() + end, batch, records);
+            }
+            catch (...)
+            {
+                if (batch.get_size() > 0)
+                {
+                    publish(std::move(batch));
+                }
+                throw;
+            }
+            buffer.erase(0, end);
+
+            if (batch.get_size() > 0 && !publish(std::move(batch)))
+            {
+                break;
+            }
+        }
+    }
+    catch (...)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        error = std::current_exception();
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    finished = true;
+    ready.notify_all();
+}
+
+
+// Отдает прочитанную пачку на переиспользование и ждет следующую.
+template<SceneScalar T>
+bool FigureStreamReader<T>::fetch()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    spare.push_back(std::move(current));
+    current = FigureStore<T>();
+    position = 0;
+
+    ready.wait(lock, [this] { return !batches.empty() || finished; });
+    if (batches.empty())
+    {
+        if (error)
+        {
+            std::exception_ptr failure = error;
+            error = nullptr;
+            std::rethrow_exception(failure);
+        }
+        return false;
+    }
+
+    current = std::move(batches.front());
+    batches.pop_front();
+    space.notify_one();
+    return true;
+}
+
+
+template<SceneScalar T>
+FigureStreamReader<T>::FigureStreamReader(std::istream& istream, size_t chunk_size, size_t queue_depth):
+    istream(istream), chunk_size(std::max<size_t>(chunk_size, 1)), queue_depth(std::max<size_t>(queue_depth, 1))
+{
+    reader = std::thread([this] { produce(); });
+}
+
+
+// Поток чтения может быть занят блокирующим read (например, из stdin);
+// деструктор дождется его.
+template<SceneScalar T>
+FigureStreamReader<T>::~FigureStreamReader() noexcept
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping.store(true);
+        space.notify_all();
+    }
+
+    reader.join();
+}
+
+
+// Следующая фигура или nullopt в конце входа. Ошибка разбора
+// пробрасывается после фигур, прочитанных до нее.
+template<SceneScalar T>
+std::optional<PolygonView<T>> FigureStreamReader<T>::next()
+{
+    while (position >= current.get_size())
+    {
+        if (!fetch())
+        {
+            return std::nullopt;
+        }
+    }
+
+    return current[position++];
+}
+
+
+template<SceneScalar T>
+template<class Callback>
+size_t FigureStreamReader<T>::for_each(Callback callback)
+{
+    size_t count = 0;
+
+    while (std::optional<PolygonView<T>> figure = next())
+    {
+        callback(*figure);
+        ++count;
+    }
+
+    return count;
+}
+
+
+template<SceneScalar T>
+size_t FigureStreamReader<T>::bytes_read() const
+{
+    return bytes.load(std::memory_order_relaxed);
+}
+
+
+template<SceneScalar T>
+typename FigureStreamReader<T>::iterator FigureStreamReader<T>::begin()
+{
+    return iterator(this);
+}
+
+
+template<SceneScalar T>
+std::default_sentinel_t FigureStreamReader<T>::end()
+{
+    return std::default_sentinel;
+}
+
+
+template<SceneScalar T>
+FigureStreamReader<T>::iterator::iterator(FigureStreamReader* stream): stream(stream), figure(stream->next()) {}
+
+
+template<SceneScalar T>
+const PolygonView<T>& FigureStreamReader<T>::iterator::operator*() const
+{
+    return *figure;
+}
+
+
+template<SceneScalar T>
+const PolygonView<T>* FigureStreamReader<T>::iterator::operator->() const
+{
+    return &*figure;
+}
+
+
+template<SceneScalar T>
+typename FigureStreamReader<T>::iterator& FigureStreamReader<T>::iterator::operator++()
+{
+    figure = stream->next();
+    return *this;
+}
+
+
+template<SceneScalar T>
+void FigureStreamReader<T>::iterator::operator++(int)
+{
+    ++*this;
+}
+
+
+template<SceneScalar T>
+bool FigureStreamReader<T>::iterator::operator==(std::default_sentinel_t) const
+{
+    return !figure.has_value();
+}
+
+
+// Статистика площадей по потоку без загрузки сцены в память.
+template<SceneScalar T>
+AreaStatistics stream_area_statistics(std::istream& istream, AreaHistogram* histogram = nullptr)
+{
+    FigureStreamReader<T> reader(istream);
+    AreaAccumulator accumulator;
+
+    reader.for_each([&](const PolygonView<T>& figure)
+    {
+        const double figure_area = figure.area();
+        accumulator.add(figure_area, figure.get_center());
+        if (histogram)
+        {
+            histogram->add(figure_area);
+        }
+    });
+
+    return accumulator.result();
+}
+
+
+#endif // FIGURE_STREAM_H
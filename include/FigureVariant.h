@@ -0,0 +1,229 @@
+#ifndef FIGURE_VARIANT_H
+#define FIGURE_VARIANT_H
+
+
+#include "Array.h"
+#include "Figure.h"
+#include "FigureKind.h"
+#include "Point.h"
+#include "Polygon.h"
+#include "Rectangle.h"
+#include "Rhombus.h"
+#include "Trapezoid.h"
+#include <istream>
+#include <memory>
+#include <ostream>
+#include <stdexcept>
+#include <type_traits>
+#include <typeinfo>
+#include <utility>
+#include <variant>
+
+
+// Фигура из закрытого набора типов, хранящаяся по значению.
+// Вызовы area() и get_center() диспетчеризуются через std::visit
+// с квалифицированным (невиртуальным) вызовом, поэтому в циклах по
+// Array<FigureVariant<T>> они встраиваются. Порядок альтернатив
+// совпадает с FigureKind.
+template<Scalar T>
+class FigureVariant final
+{
+public:
+    using variant_type = std::variant<Polygon<T>, Rectangle<T>, Rhombus<T>, Trapezoid<T>>;
+
+private:
+    variant_type figure;
+
+public:
+    FigureVariant() = default;
+    template<class F>
+        requires (!std::is_same_v<std::remove_cvref_t<F>, FigureVariant>) && std::is_constructible_v<variant_type, F&&>
+    FigureVariant(F&& figure);
+    FigureVariant(const FigureVariant& other) = default;
+    FigureVariant(FigureVariant&& other) noexcept = default;
+    ~FigureVariant() noexcept = default;
+
+public:
+    static FigureVariant from_figure(const Figure<T>& figure);
+    double area() const;
+    Point<double> get_center() const;
+    FigureKind get_kind() const;
+    template<class F>
+    bool holds() const;
+    template<class F>
+    F& get();
+    template<class F>
+    const F& get() const;
+    template<class Visitor>
+    decltype(auto) visit(Visitor&& visitor);
+    template<class Visitor>
+    decltype(auto) visit(Visitor&& visitor) const;
+    Figure<T>& as_figure();
+    const Figure<T>& as_figure() const;
+
+public:
+    FigureVariant& operator=(const FigureVariant& other) = default;
+    FigureVariant& operator=(FigureVariant&& other) = default;
+    explicit operator double() const;
+    template<Scalar S>
+    friend std::ostream& operator<<(std::ostream& ostream, const FigureVariant<S>& figure);
+    template<Scalar S>
+    friend std::istream& operator>>(std::istream& istream, FigureVariant<S>& figure);
+};
+
+
+template<Scalar T>
+template<class F>
+    requires (!std::is_same_v<std::remove_cvref_t<F>, FigureVariant<T>>) && std::is_constructible_v<typename FigureVariant<T>::variant_type, F&&>
+FigureVariant<T>::FigureVariant(F&& figure): figure(std::forward<F>(figure)) {}
+
+
+// Переход от иерархии Figure<T>: копирует фигуру в альтернативу точно того же
+// типа. Прочие наследники, в том числе наследники Polygon<T>, не срезаются
+// до базового класса, а отвергаются.
+template<Scalar T>
+FigureVariant<T> FigureVariant<T>::from_figure(const Figure<T>& figure)
+{
+    const std::type_info& type = typeid(figure);
+
+    if (type == typeid(Rectangle<T>))
+    {
+        return FigureVariant(static_cast<const Rectangle<T>&>(figure));
+    }
+    if (type == typeid(Rhombus<T>))
+    {
+        return FigureVariant(static_cast<const Rhombus<T>&>(figure));
+    }
+    if (type == typeid(Trapezoid<T>))
+    {
+        return FigureVariant(static_cast<const Trapezoid<T>&>(figure));
+    }
+    if (type == typeid(Polygon<T>))
+    {
+        return FigureVariant(static_cast<const Polygon<T>&>(figure));
+    }
+
+    throw std::invalid_argument("Error: Figure type is not supported by FigureVariant.");
+}
+
+
+template<Scalar T>
+double FigureVariant<T>::area() const
+{
+    return std::visit([](const auto& figure)
+    {
+        using F = std::remove_cvref_t<decltype(figure)>;
+        return figure.F::area();
+    }, figure);
+}
+
+
+template<Scalar T>
+Point<double> FigureVariant<T>::get_center() const
+{
+    return std::visit([](const auto& figure)
+    {
+        using F = std::remove_cvref_t<decltype(figure)>;
+        return figure.F::get_center();
+    }, figure);
+}
+
+
+template<Scalar T>
+FigureKind FigureVariant<T>::get_kind() const
+{
+    return static_cast<FigureKind>(figure.index());
+}
+
+
+template<Scalar T>
+template<class F>
+bool FigureVariant<T>::holds() const
+{
+    return std::holds_alternative<F>(figure);
+}
+
+
+template<Scalar T>
+template<class F>
+F& FigureVariant<T>::get()
+{
+    return std::get<F>(figure);
+}
+
+
+template<Scalar T>
+template<class F>
+const F& FigureVariant<T>::get() const
+{
+    return std::get<F>(figure);
+}
+
+
+template<Scalar T>
+template<class Visitor>
+decltype(auto) FigureVariant<T>::visit(Visitor&& visitor)
+{
+    return std::visit(std::forward<Visitor>(visitor), figure);
+}
+
+
+template<Scalar T>
+template<class Visitor>
+decltype(auto) FigureVariant<T>::visit(Visitor&& visitor) const
+{
+    return std::visit(std::forward<Visitor>(visitor), figure);
+}
+
+
+// Адаптер для кода, написанного под Figure<T>&.
+template<Scalar T>
+Figure<T>& FigureVariant<T>::as_figure()
+{
+    return std::visit([](auto& figure) -> Figure<T>& { return figure; }, figure);
+}
+
+
+template<Scalar T>
+const Figure<T>& FigureVariant<T>::as_figure() const
+{
+    return std::visit([](const auto& figure) -> const Figure<T>& { return figure; }, figure);
+}
+
+
+template<Scalar T>
+FigureVariant<T>::operator double() const
+{
+    return this->area();
+}
+
+
+template<Scalar S>
+std::ostream& operator<<(std::ostream& ostream, const FigureVariant<S>& figure)
+{
+    return ostream << figure.as_figure();
+}
+
+
+template<Scalar S>
+std::istream& operator>>(std::istream& istream, FigureVariant<S>& figure)
+{
+    return istream >> figure.as_figure();
+}
+
+
+template<Scalar T>
+Array<FigureVariant<T>> make_variant_array(const Array<std::shared_ptr<Figure<T>>>& figures)
+{
+    Array<FigureVariant<T>> variants(figures.get_size() > 0 ? figures.get_size() : 1);
+
+    for (size_t i = 0; i < figures.get_size(); ++i)
+    {
+        variants.emplace_back(FigureVariant<T>::from_figure(*figures[i]));
+    }
+
+    return variants;
+}
+
+
+#endif // FIGURE_VARIANT_H
@@ -0,0 +1,364 @@
+#ifndef INSTRUMENTATION_H
+#define INSTRUMENTATION_H
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <vector>
+
+
+// Счетчики и гистограммы задержек горячих операций Array и Polygon.
+// Включаются при сборке с GEOMETRY_INSTRUMENTATION (опция CMake того же
+// имени); без него GEOMETRY_INSTRUMENT разворачивается в пустой
+// оператор и аргументы даже не вычисляются. Каждый поток пишет в свой
+// слот, snapshot() складывает слоты. При завершении потока его значения
+// переносятся в общий итог, а слот удаляется из реестра. reset() не
+// пишет в чужие слоты, а запоминает их текущие значения как точку
+// отсчета.
+#ifdef GEOMETRY_INSTRUMENTATION
+constexpr bool instrumentation_enabled = true;
+#define GEOMETRY_INSTRUMENT(operation, items) InstrumentationScope instrumentation_scope(operation, items)
+#else
+constexpr bool instrumentation_enabled = false;
+#define GEOMETRY_INSTRUMENT(operation, items) ((void)0)
+#endif
+
+
+enum class InstrumentedOperation
+{
+    ArrayReallocation,
+    ArrayShift,
+    PolygonCopy,
+    PolygonArea,
+};
+
+constexpr size_t instrumented_operation_count = 4;
+
+
+inline const char* instrumented_operation_name(InstrumentedOperation operation)
+{
+    switch (operation)
+    {
+    case InstrumentedOperation::ArrayReallocation:
+        return "array_reallocation";
+    case InstrumentedOperation::ArrayShift:
+        return "array_shift";
+    case InstrumentedOperation::PolygonCopy:
+        return "polygon_copy";
+    case InstrumentedOperation::PolygonArea:
+        return "polygon_area";
+    }
+
+    return "unknown";
+}
+
+
+// items - перенесенные, сдвинутые или скопированные элементы (вершины).
+// Корзина i гистограммы считает задержки от 2^i до 2^(i + 1) - 1 нс
+// включительно (корзина 0 - и нулевые).
+struct OperationStatistics
+{
+    constexpr static size_t bucket_count = 32;
+
+    size_t count = 0;
+    size_t items = 0;
+    uint64_t total_nanoseconds = 0;
+    std::array<size_t, bucket_count> latency_buckets{};
+};
+
+
+struct InstrumentationSnapshot
+{
+    std::array<OperationStatistics, instrumented_operation_count> operations;
+
+    const OperationStatistics& operator[](InstrumentedOperation operation) const;
+};
+
+
+class Instrumentation final
+{
+private:
+    struct Counters
+    {
+        std::atomic<size_t> count = 0;
+        std::atomic<size_t> items = 0;
+        std::atomic<uint64_t> total_nanoseconds = 0;
+        std::array<std::atomic<size_t>, OperationStatistics::bucket_count> latency_buckets{};
+    };
+
+    struct alignas(64) Slot
+    {
+        std::array<Counters, instrumented_operation_count> operations;
+        InstrumentationSnapshot baseline;
+    };
+
+    struct Registry
+    {
+        std::mutex mutex;
+        std::vector<Slot*> slots;
+        InstrumentationSnapshot retired;
+    };
+
+    // Владеет слотом потока и выписывает его из реестра при выходе потока.
+    class LocalSlot final
+    {
+    private:
+        Slot slot;
+
+    public:
+        LocalSlot();
+        LocalSlot(const LocalSlot& other) = delete;
+        ~LocalSlot() noexcept;
+
+    public:
+        Slot& get();
+        LocalSlot& operator=(const LocalSlot& other) = delete;
+    };
+
+private:
+    static Registry& registry();
+    static Slot& local();
+    static void increment(std::atomic<size_t>& counter, size_t value);
+    static void add_since_baseline(InstrumentationSnapshot& total, const Slot& slot);
+    static void move_baseline(Slot& slot);
+
+public:
+    static void record(InstrumentedOperation operation, size_t items, uint64_t nanoseconds);
+    static InstrumentationSnapshot snapshot();
+    static void reset();
+    static void write_json(std::ostream& ostream, const InstrumentationSnapshot& snapshot);
+    static void write_prometheus(std::ostream& ostream, const InstrumentationSnapshot& snapshot);
+};
+
+
+// Замеряет время от создания до разрушения и записывает операцию.
+class InstrumentationScope final
+{
+private:
+    InstrumentedOperation operation;
+    size_t items;
+    std::chrono::steady_clock::time_point start;
+
+public:
+    InstrumentationScope(InstrumentedOperation operation, size_t items);
+    InstrumentationScope(const InstrumentationScope& other) = delete;
+    ~InstrumentationScope() noexcept;
+
+public:
+    InstrumentationScope& operator=(const InstrumentationScope& other) = delete;
+};
+
+
+inline const OperationStatistics& InstrumentationSnapshot::operator[](InstrumentedOperation operation) const
+{
+    return operations[static_cast<size_t>(operation)];
+}
+
+
+inline Instrumentation::LocalSlot::LocalSlot()
+{
+    Registry& shared = registry();
+    std::lock_guard<std::mutex> lock(shared.mutex);
+    shared.slots.push_back(&slot);
+}
+
+
+inline Instrumentation::LocalSlot::~LocalSlot() noexcept
+{
+    Registry& shared = registry();
+    std::lock_guard<std::mutex> lock(shared.mutex);
+
+    add_since_baseline(shared.retired, slot);
+    shared.slots.erase(std::find(shared.slots.begin(), shared.slots.end(), &slot));
+}
+
+
+inline Instrumentation::Slot& Instrumentation::LocalSlot::get()
+{
+    return slot;
+}
+
+
+inline Instrumentation::Registry& Instrumentation::registry()
+{
+    static Registry registry;
+    return registry;
+}
+
+
+inline Instrumentation::Slot& Instrumentation::local()
+{
+    thread_local LocalSlot slot;
+    return slot.get();
+}
+
+
+// Слот пишет только его поток, поэтому хватает load + store без RMW.
+inline void Instrumentation::increment(std::atomic<size_t>& counter, size_t value)
+{
+    counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+}
+
+
+// Добавляет к total приращения слота после его точки отсчета.
+// Вызывается под мьютексом реестра.
+inline void Instrumentation::add_since_baseline(InstrumentationSnapshot& total, const Slot& slot)
+{
+    for (size_t i = 0; i < instrumented_operation_count; ++i)
+    {
+        const Counters& counters = slot.operations[i];
+        const OperationStatistics& baseline = slot.baseline.operations[i];
+        OperationStatistics& statistics = total.operations[i];
+
+        statistics.count += counters.count.load(std::memory_order_relaxed) - baseline.count;
+        statistics.items += counters.items.load(std::memory_order_relaxed) - baseline.items;
+        statistics.total_nanoseconds += counters.total_nanoseconds.load(std::memory_order_relaxed) - baseline.total_nanoseconds;
+        for (size_t bucket = 0; bucket < OperationStatistics::bucket_count; ++bucket)
+        {
+            statistics.latency_buckets[bucket] += counters.latency_buckets[bucket].load(std::memory_order_relaxed) - baseline.latency_buckets[bucket];
+        }
+    }
+}
+
+
+// Переносит точку отсчета слота на его текущие значения.
+// Вызывается под мьютексом реестра.
+inline void Instrumentation::move_baseline(Slot& slot)
+{
+    for (size_t i = 0; i < instrumented_operation_count; ++i)
+    {
+        const Counters& counters = slot.operations[i];
+        OperationStatistics& baseline = slot.baseline.operations[i];
+
+        baseline.count = counters.count.load(std::memory_order_relaxed);
+        baseline.items = counters.items.load(std::memory_order_relaxed);
+        baseline.total_nanoseconds = counters.total_nanoseconds.load(std::memory_order_relaxed);
+        for (size_t bucket = 0; bucket < OperationStatistics::bucket_count; ++bucket)
+        {
+            baseline.latency_buckets[bucket] = counters.latency_buckets[bucket].load(std::memory_order_relaxed);
+        }
+    }
+}
+
+
+inline void Instrumentation::record(InstrumentedOperation operation, size_t items, uint64_t nanoseconds)
+{
+    Counters& counters = local().operations[static_cast<size_t>(operation)];
+    const size_t bucket = std::min<size_t>(std::bit_width(nanoseconds | 1) - 1, OperationStatistics::bucket_count - 1);
+
+    increment(counters.count, 1);
+    increment(counters.items, items);
+    counters.total_nanoseconds.store(counters.total_nanoseconds.load(std::memory_order_relaxed) + nanoseconds, std::memory_order_relaxed);
+    increment(counters.latency_buckets[bucket], 1);
+}
+
+
+inline InstrumentationSnapshot Instrumentation::snapshot()
+{
+    Registry& shared = registry();
+    std::lock_guard<std::mutex> lock(shared.mutex);
+    InstrumentationSnapshot snapshot = shared.retired;
+
+    for (const Slot* slot : shared.slots)
+    {
+        add_since_baseline(snapshot, *slot);
+    }
+
+    return snapshot;
+}
+
+
+inline void Instrumentation::reset()
+{
+    Registry& shared = registry();
+    std::lock_guard<std::mutex> lock(shared.mutex);
+
+    shared.retired = InstrumentationSnapshot();
+    for (Slot* slot : shared.slots)
+    {
+        move_baseline(*slot);
+    }
+}
+
+
+// {"array_reallocation": {"count": 1, "items": 16, "total_ns": 250,
+//  "latency_buckets_ns": [0, ...]}, ...}
+inline void Instrumentation::write_json(std::ostream& ostream, const InstrumentationSnapshot& snapshot)
+{
+    ostream << '{';
+    for (size_t i = 0; i < instrumented_operation_count; ++i)
+    {
+        const OperationStatistics& statistics = snapshot.operations[i];
+
+        ostream << (i == 0 ? "" : ", ") << '"' << instrumented_operation_name(static_cast<InstrumentedOperation>(i)) << "\": {"
+                << "\"count\": " << statistics.count
+                << ", \"items\": " << statistics.items
+                << ", \"total_ns\": " << statistics.total_nanoseconds
+                << ", \"latency_buckets_ns\": [";
+        for (size_t bucket = 0; bucket < OperationStatistics::bucket_count; ++bucket)
+        {
+            ostream << (bucket == 0 ? "" : ", ") << statistics.latency_buckets[bucket];
+        }
+        ostream << "]}";
+    }
+    ostream << "}\n";
+}
+
+
+// Текстовый формат Prometheus: счетчики и гистограмма с
+// накопленными корзинами (le - включительная верхняя граница в
+// наносекундах, 2^(i + 1) - 1; последняя корзина входит только в +Inf).
+inline void Instrumentation::write_prometheus(std::ostream& ostream, const InstrumentationSnapshot& snapshot)
+{
+    ostream << "# TYPE geometry_operations_total counter\n";
+    for (size_t i = 0; i < instrumented_operation_count; ++i)
+    {
+        ostream << "geometry_operations_total{operation=\"" << instrumented_operation_name(static_cast<InstrumentedOperation>(i)) << "\"} "
+                << snapshot.operations[i].count << '\n';
+    }
+
+    ostream << "# TYPE geometry_operation_items_total counter\n";
+    for (size_t i = 0; i < instrumented_operation_count; ++i)
+    {
+        ostream << "geometry_operation_items_total{operation=\"" << instrumented_operation_name(static_cast<InstrumentedOperation>(i)) << "\"} "
+                << snapshot.operations[i].items << '\n';
+    }
+
+    ostream << "# TYPE geometry_operation_latency_nanoseconds histogram\n";
+    for (size_t i = 0; i < instrumented_operation_count; ++i)
+    {
+        const OperationStatistics& statistics = snapshot.operations[i];
+        const char* name = instrumented_operation_name(static_cast<InstrumentedOperation>(i));
+        size_t cumulative = 0;
+
+        for (size_t bucket = 0; bucket + 1 < OperationStatistics::bucket_count; ++bucket)
+        {
+            cumulative += statistics.latency_buckets[bucket];
+            ostream << "geometry_operation_latency_nanoseconds_bucket{operation=\"" << name << "\",le=\"" << (uint64_t(1) << (bucket + 1)) - 1 << "\"} "
+                    << cumulative << '\n';
+        }
+        ostream << "geometry_operation_latency_nanoseconds_bucket{operation=\"" << name << "\",le=\"+Inf\"} " << statistics.count << '\n'
+                << "geometry_operation_latency_nanoseconds_sum{operation=\"" << name << "\"} " << statistics.total_nanoseconds << '\n'
+                << "geometry_operation_latency_nanoseconds_count{operation=\"" << name << "\"} " << statistics.count << '\n';
+    }
+}
+
+
+inline InstrumentationScope::InstrumentationScope(InstrumentedOperation operation, size_t items):
+    operation(operation), items(items), start(std::chrono::steady_clock::now()) {}
+
+
+inline InstrumentationScope::~InstrumentationScope() noexcept
+{
+    const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+    Instrumentation::record(operation, items, static_cast<uint64_t>(elapsed.count()));
+}
+
+
+#endif // INSTRUMENTATION_H
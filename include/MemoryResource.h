@@ -0,0 +1,445 @@
+#ifndef MEMORY_RESOURCE_H
+#define MEMORY_RESOURCE_H
+
+
+#include "Point.h"
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <stdexcept>
+
+
+// Обертка над другим ресурсом, считающая выделения и освобождения.
+class CountingResource final : public std::pmr::memory_resource
+{
+private:
+    std::pmr::memory_resource* upstream;
+    std::atomic<size_t> allocations = 0;
+    std::atomic<size_t> deallocations = 0;
+    std::atomic<size_t> bytes = 0;
+
+public:
+    explicit CountingResource(std::pmr::memory_resource* upstream = std::pmr::new_delete_resource());
+    CountingResource(const CountingResource& other) = delete;
+    ~CountingResource() noexcept override = default;
+
+public:
+    size_t allocation_count() const;
+    size_t deallocation_count() const;
+    size_t allocated_bytes() const;
+    void reset_counters();
+
+public:
+    CountingResource& operator=(const CountingResource& other) = delete;
+
+protected:
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void* pointer, size_t bytes, size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+};
+
+
+// Монотонная арена для одного кадра: освобождение отдельных блоков ничего
+// не делает, reset() за O(1) возвращает арену в начало, сохраняя уже
+// полученную у upstream память для следующего кадра. Деструкторы объектов,
+// размещенных в арене, reset() не вызывает.
+class FrameArena final : public std::pmr::memory_resource
+{
+private:
+    struct Chunk
+    {
+        Chunk* next;
+        size_t capacity;
+    };
+
+private:
+    std::pmr::memory_resource* upstream;
+    size_t chunk_size;
+    Chunk* chunks = nullptr;
+    Chunk* current = nullptr;
+    std::byte* cursor = nullptr;
+    std::byte* end = nullptr;
+    size_t used = 0;
+
+private:
+    static std::byte* chunk_begin(Chunk* chunk);
+    void activate(Chunk* chunk);
+    Chunk* make_chunk(size_t capacity);
+
+public:
+    explicit FrameArena(size_t chunk_size = 64 * 1024, std::pmr::memory_resource* upstream = std::pmr::new_delete_resource());
+    FrameArena(const FrameArena& other) = delete;
+    ~FrameArena() noexcept override;
+
+public:
+    void reset() noexcept;
+    void release() noexcept;
+    size_t bytes_used() const;
+    size_t bytes_reserved() const;
+
+public:
+    FrameArena& operator=(const FrameArena& other) = delete;
+
+protected:
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void* pointer, size_t bytes, size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+};
+
+
+// Пул блоков одного размера со списком свободных блоков. Запросы, которые
+// не помещаются в блок, передаются upstream.
+class FixedBlockPool final : public std::pmr::memory_resource
+{
+private:
+    struct FreeBlock
+    {
+        FreeBlock* next;
+    };
+
+    struct Chunk
+    {
+        Chunk* next;
+        size_t bytes;
+    };
+
+private:
+    std::pmr::memory_resource* upstream;
+    size_t block_size;
+    size_t block_alignment;
+    size_t blocks_per_chunk;
+    FreeBlock* free_list = nullptr;
+    Chunk* chunks = nullptr;
+
+private:
+    void refill();
+
+public:
+    FixedBlockPool(size_t block_size, size_t block_alignment = alignof(std::max_align_t), size_t blocks_per_chunk = 1024,
+                   std::pmr::memory_resource* upstream = std::pmr::new_delete_resource());
+    FixedBlockPool(const FixedBlockPool& other) = delete;
+    ~FixedBlockPool() noexcept override;
+
+public:
+    void release() noexcept;
+    size_t get_block_size() const;
+
+public:
+    FixedBlockPool& operator=(const FixedBlockPool& other) = delete;
+
+protected:
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void* pointer, size_t bytes, size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+};
+
+
+template<Scalar T>
+FixedBlockPool make_point_pool(size_t vertices_per_block = 8, size_t blocks_per_chunk = 1024,
+                               std::pmr::memory_resource* upstream = std::pmr::new_delete_resource())
+{
+    return FixedBlockPool(vertices_per_block * sizeof(Point<T>), alignof(Point<T>), blocks_per_chunk, upstream);
+}
+
+
+inline size_t align_up(size_t value, size_t alignment)
+{
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+
+inline CountingResource::CountingResource(std::pmr::memory_resource* upstream): upstream(upstream) {}
+
+
+inline size_t CountingResource::allocation_count() const
+{
+    return allocations.load(std::memory_order_relaxed);
+}
+
+
+inline size_t CountingResource::deallocation_count() const
+{
+    return deallocations.load(std::memory_order_relaxed);
+}
+
+
+inline size_t CountingResource::allocated_bytes() const
+{
+    return bytes.load(std::memory_order_relaxed);
+}
+
+
+inline void CountingResource::reset_counters()
+{
+    allocations.store(0, std::memory_order_relaxed);
+    deallocations.store(0, std::memory_order_relaxed);
+    bytes.store(0, std::memory_order_relaxed);
+}
+
+
+inline void* CountingResource::do_allocate(size_t size, size_t alignment)
+{
+    void* pointer = upstream->allocate(size, alignment);
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    bytes.fetch_add(size, std::memory_order_relaxed);
+    return pointer;
+}
+
+
+inline void CountingResource::do_deallocate(void* pointer, size_t size, size_t alignment)
+{
+    upstream->deallocate(pointer, size, alignment);
+    deallocations.fetch_add(1, std::memory_order_relaxed);
+}
+
+
+inline bool CountingResource::do_is_equal(const std::pmr::memory_resource& other) const noexcept
+{
+    return this == &other;
+}
+
+
+inline FrameArena::FrameArena(size_t chunk_size, std::pmr::memory_resource* upstream): upstream(upstream), chunk_size(chunk_size)
+{
+    if (chunk_size == 0)
+    {
+        throw std::invalid_argument("Error: Chunk size should be greater than 0.");
+    }
+}
+
+
+inline FrameArena::~FrameArena() noexcept
+{
+    release();
+}
+
+
+inline std::byte* FrameArena::chunk_begin(Chunk* chunk)
+{
+    return reinterpret_cast<std::byte*>(chunk) + align_up(sizeof(Chunk), alignof(std::max_align_t));
+}
+
+
+inline void FrameArena::activate(Chunk* chunk)
+{
+    current = chunk;
+    cursor = chunk_begin(chunk);
+    end = cursor + chunk->capacity;
+}
+
+
+inline FrameArena::Chunk* FrameArena::make_chunk(size_t capacity)
+{
+    const size_t header = align_up(sizeof(Chunk), alignof(std::max_align_t));
+    void* memory = upstream->allocate(header + capacity, alignof(std::max_align_t));
+
+    Chunk* chunk = static_cast<Chunk*>(memory);
+    chunk->next = nullptr;
+    chunk->capacity = capacity;
+    return chunk;
+}
+
+
+inline void FrameArena::reset() noexcept
+{
+    used = 0;
+
+    if (chunks == nullptr)
+    {
+        current = nullptr;
+        cursor = end = nullptr;
+        return;
+    }
+
+    activate(chunks);
+}
+
+
+inline void FrameArena::release() noexcept
+{
+    const size_t header = align_up(sizeof(Chunk), alignof(std::max_align_t));
+
+    while (chunks != nullptr)
+    {
+        Chunk* next = chunks->next;
+        upstream->deallocate(chunks, header + chunks->capacity, alignof(std::max_align_t));
+        chunks = next;
+    }
+
+    current = nullptr;
+    cursor = end = nullptr;
+    used = 0;
+}
+
+
+inline size_t FrameArena::bytes_used() const
+{
+    return used;
+}
+
+
+inline size_t FrameArena::bytes_reserved() const
+{
+    size_t reserved = 0;
+
+    for (Chunk* chunk = chunks; chunk != nullptr; chunk = chunk->next)
+    {
+        reserved += chunk->capacity;
+    }
+
+    return reserved;
+}
+
+
+inline void* FrameArena::do_allocate(size_t size, size_t alignment)
+{
+    while (true)
+    {
+        if (current != nullptr)
+        {
+            const size_t address = reinterpret_cast<std::uintptr_t>(cursor);
+            std::byte* aligned = cursor + (align_up(address, alignment) - address);
+
+            if (aligned + size <= end)
+            {
+                cursor = aligned + size;
+                used += size;
+                return aligned;
+            }
+
+            if (current->next != nullptr && current->next->capacity >= size + alignment)
+            {
+                activate(current->next);
+                continue;
+            }
+        }
+
+        Chunk* chunk = make_chunk(std::max(chunk_size, size + alignment));
+
+        if (current == nullptr)
+        {
+            chunk->next = chunks;
+            chunks = chunk;
+        }
+        else
+        {
+            chunk->next = current->next;
+            current->next = chunk;
+        }
+
+        activate(chunk);
+    }
+}
+
+
+inline void FrameArena::do_deallocate(void*, size_t, size_t) {}
+
+
+inline bool FrameArena::do_is_equal(const std::pmr::memory_resource& other) const noexcept
+{
+    return this == &other;
+}
+
+
+inline FixedBlockPool::FixedBlockPool(size_t block_size, size_t block_alignment, size_t blocks_per_chunk, std::pmr::memory_resource* upstream)
+    : upstream(upstream), block_alignment(std::max(block_alignment, alignof(FreeBlock))), blocks_per_chunk(blocks_per_chunk)
+{
+    if (block_size == 0 || blocks_per_chunk == 0)
+    {
+        throw std::invalid_argument("Error: Block size and blocks per chunk should be greater than 0.");
+    }
+    if (block_alignment == 0 || (block_alignment & (block_alignment - 1)) != 0)
+    {
+        throw std::invalid_argument("Error: Block alignment should be a power of two.");
+    }
+
+    this->block_size = align_up(std::max(block_size, sizeof(FreeBlock)), this->block_alignment);
+}
+
+
+inline FixedBlockPool::~FixedBlockPool() noexcept
+{
+    release();
+}
+
+
+inline void FixedBlockPool::refill()
+{
+    const size_t header = align_up(sizeof(Chunk), block_alignment);
+    const size_t bytes = header + block_size * blocks_per_chunk;
+
+    Chunk* chunk = static_cast<Chunk*>(upstream->allocate(bytes, std::max(block_alignment, alignof(Chunk))));
+    chunk->next = chunks;
+    chunk->bytes = bytes;
+    chunks = chunk;
+
+    std::byte* first = reinterpret_cast<std::byte*>(chunk) + header;
+    for (size_t i = blocks_per_chunk; i > 0; --i)
+    {
+        FreeBlock* block = reinterpret_cast<FreeBlock*>(first + (i - 1) * block_size);
+        block->next = free_list;
+        free_list = block;
+    }
+}
+
+
+inline void FixedBlockPool::release() noexcept
+{
+    while (chunks != nullptr)
+    {
+        Chunk* next = chunks->next;
+        upstream->deallocate(chunks, chunks->bytes, std::max(block_alignment, alignof(Chunk)));
+        chunks = next;
+    }
+
+    free_list = nullptr;
+}
+
+
+inline size_t FixedBlockPool::get_block_size() const
+{
+    return block_size;
+}
+
+
+inline void* FixedBlockPool::do_allocate(size_t size, size_t alignment)
+{
+    if (size > block_size || alignment > block_alignment)
+    {
+        return upstream->allocate(size, alignment);
+    }
+
+    if (free_list == nullptr)
+    {
+        refill();
+    }
+
+    FreeBlock* block = free_list;
+    free_list = block->next;
+    return block;
+}
+
+
+inline void FixedBlockPool::do_deallocate(void* pointer, size_t size, size_t alignment)
+{
+    if (size > block_size || alignment > block_alignment)
+    {
+        upstream->deallocate(pointer, size, alignment);
+        return;
+    }
+
+    FreeBlock* block = static_cast<FreeBlock*>(pointer);
+    block->next = free_list;
+    free_list = block;
+}
+
+
+inline bool FixedBlockPool::do_is_equal(const std::pmr::memory_resource& other) const noexcept
+{
+    return this == &other;
+}
+
+
+#endif // MEMORY_RESOURCE_H
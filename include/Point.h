@@ -1,6 +1,9 @@
 #ifndef POINT_H
 #define POINT_H
 
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
 #include <iostream>
 #include <ostream>
 #include <type_traits>
@@ -8,25 +11,31 @@
 template<class T>
 concept Scalar = std::is_scalar_v<T>;
 
+// Допуск operator== для вещественных координат: относительный для
+// больших значений и абсолютный на [-1, 1]. Целые сравниваются точно.
+template<Scalar T>
+constexpr double point_tolerance = sizeof(T) < sizeof(double) ? 1e-5 : 1e-6;
+
+
+// Копирование и перемещение - тривиальные (по умолчанию), поэтому Point
+// годится для constexpr-вычислений и копируется как простые байты.
+// Выравнивание по размеру пары координат (не больше 16): Point<float>
+// и Point<int> ложатся в одно 8-байтовое слово, Point<double> - в одну
+// 16-байтовую загрузку SSE.
 template <Scalar T>
-class Point final
+class alignas(std::min<size_t>(2 * sizeof(T), 16)) Point final
 {
 public:
     T x;
     T y;
 
 public:
-    Point();
-    Point(T x, T y);
-    Point(const Point& other);
-    Point(Point&& other) noexcept;
-    ~Point() = default;
+    constexpr Point();
+    constexpr Point(T x, T y);
 
 public:
-    Point& operator=(const Point& other);
-    Point& operator=(Point&& other) noexcept; 
-    bool operator==(const Point& other) const;
-    bool operator!=(const Point& other) const;
+    constexpr bool operator==(const Point& other) const;
+    constexpr bool operator!=(const Point& other) const;
 
 public:
     template<Scalar S>
@@ -34,54 +43,36 @@ public:
 };
 
 template<Scalar T>
-Point<T>::Point(): x(0.0), y(0.0) {}
+constexpr Point<T>::Point(): x(0.0), y(0.0) {}
 
 template<Scalar T>
-Point<T>::Point(T x, T y): x(x), y(y) {}
+constexpr Point<T>::Point(T x, T y): x(x), y(y) {}
 
-template<Scalar T>
-Point<T>::Point(Point&& other) noexcept: x(std::move(other.x)), y(std::move(other.y)) {}
-
-template<Scalar T>
-Point<T>::Point(const Point& other): x(other.x), y(other.y) {}
-
-template<Scalar T>
-Point<T>& Point<T>::operator=(const Point& other)
-{
-    x = other.x;
-    y = other.y;
-
-    return *this;
-}
 
 template<Scalar T>
-Point<T>& Point<T>::operator=(Point&& other) noexcept
+constexpr bool Point<T>::operator==(const Point& other) const
 {
-    x = std::move(other.x);
-    y = std::move(other.y);
-
-    other.x = 0.0;
-    other.y = 0.0;
-
-    return *this;
-}
-
-
-template<Scalar T>
-bool Point<T>::operator==(const Point& other) const
-{
-    const double EPS = 1e-6;
-    if (std::abs(x - other.x) <= EPS && std::abs(y - other.y) <= EPS)
+    if constexpr (std::is_floating_point_v<T>)
     {
-        return true;
+        // std::abs для double не constexpr до C++23.
+        auto magnitude = [](double value) { return value < 0.0 ? -value : value; };
+        auto close = [&](T first, T second)
+        {
+            const double scale = std::max({1.0, magnitude(static_cast<double>(first)), magnitude(static_cast<double>(second))});
+            return magnitude(static_cast<double>(first) - static_cast<double>(second)) <= point_tolerance<T> * scale;
+        };
+
+        return close(x, other.x) && close(y, other.y);
+    }
+    else
+    {
+        return x == other.x && y == other.y;
     }
-
-    return false;
 }
 
 
 template<Scalar T>
-bool Point<T>::operator!=(const Point& other) const
+constexpr bool Point<T>::operator!=(const Point& other) const
 {
     return !(this->operator==(other));
 }
@@ -2,28 +2,82 @@
 #define POLYGON_H
 
 
+#include "BoundingBox.h"
+#include "CacheStatistics.h"
 #include "Figure.h"
+#include "Instrumentation.h"
+#include "Arithmetic.h"
 #include "Point.h"
+#include "Predicates.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
 #include <cstddef>
+#include <cstring>
 #include <memory>
+#include <memory_resource>
+#include <span>
 #include <stdexcept>
 
 
-template<Scalar T>
-class Polygon: public Figure<T> 
+// Policy задает арифметику площади, центра и предикатов (Arithmetic.h).
+template<Scalar T, ArithmeticPolicy Policy = FastArithmetic>
+class Polygon: public Figure<T>
 {
+public:
+    using allocator_type = std::pmr::polymorphic_allocator<Point<T>>;
+    constexpr static size_t inline_capacity = 4;
+
 private:
-    size_t size;
-    std::unique_ptr<Point<T>[]> vertices;
+    size_t size = 0;
+    Point<T>* vertices = local_vertices;
+    allocator_type allocator;
+    union
+    {
+        Point<T> local_vertices[inline_capacity];
+    };
+
+private:
+    struct Properties
+    {
+        double area = 0.0;
+        Point<double> center;
+        BoundingBox<T> box;
+    };
+
+    constexpr static unsigned char cache_dirty = 0;
+    constexpr static unsigned char cache_filling = 1;
+    constexpr static unsigned char cache_valid = 2;
+
+    mutable std::atomic<unsigned char> cache_state = cache_dirty;
+    mutable Properties cache;
+
+private:
+    Properties compute_properties() const;
+    Properties properties() const;
+    void invalidate() noexcept;
+    void copy_cache(const Polygon& other) noexcept;
+    bool is_inline() const;
+    void allocate(size_t new_size);
+    void deallocate() noexcept;
+    void steal(Polygon& other) noexcept;
+    static void copy_vertices(const Point<T>* source, size_t count, Point<T>* destination) noexcept;
 
 public:
-    Polygon() = default;
+    Polygon();
+    explicit Polygon(const allocator_type& allocator);
     Polygon(size_t size);
+    Polygon(size_t size, const allocator_type& allocator);
+    explicit Polygon(std::span<const Point<T>> vertices, const allocator_type& allocator = allocator_type());
+    explicit Polygon(std::span<const T> coordinates, const allocator_type& allocator = allocator_type());
     Polygon(const Polygon& other);
+    Polygon(const Polygon& other, const allocator_type& allocator);
     Polygon(Polygon&& other) noexcept;
-    ~Polygon() noexcept = default;
+    Polygon(Polygon&& other, const allocator_type& allocator);
+    ~Polygon() noexcept;
 
 protected: 
+    const Point<T>* vertex_data() const;
     Point<double> calculate_center() const override;
     std::ostream& write_to_stream(std::ostream& ostream) const override;
     std::istream& read_from_stream(std::istream& istream) override;
@@ -34,88 +88,321 @@ public:
     Point<double> get_center() const override;
     size_t vertex_count() const;
     Point<T> get_vertex(size_t index) const;
+    BoundingBox<T> bounding_box() const;
+    bool contains(const Point<T>& point) const;
+    int winding_number(const Point<T>& point) const;
+    bool is_convex() const;
+    double perimeter() const;
+    bool intersects(const Polygon& other) const;
+    static CacheStatistics cache_statistics();
+    static void reset_cache_statistics();
     explicit operator double() const override;
+    allocator_type get_allocator() const;
     Polygon& operator=(const Polygon& other);
-    Polygon& operator=(Polygon&& other) noexcept;
+    Polygon& operator=(Polygon&& other);
 };
 
-template <Scalar T>
-Polygon<T>::Polygon(size_t size): size(size)
+template<Scalar T, ArithmeticPolicy Policy>
+typename Polygon<T, Policy>::Properties Polygon<T, Policy>::compute_properties() const
 {
-    if (size < 3)
+    GEOMETRY_INSTRUMENT(InstrumentedOperation::PolygonArea, size);
+    Properties properties;
+    properties.box = BoundingBox<T>(vertices[0], vertices[0]);
+
+    typename Policy::template AreaSum<T> area;
+    typename Policy::Sum x_center;
+    typename Policy::Sum y_center;
+
+    for (size_t i = 0; i < size; ++i)
     {
-        throw std::invalid_argument("The number of vertices of a polygon is not less than 3.");
+        const Point<T>& current = vertices[i];
+
+        if (i + 1 < size)
+        {
+            area.add(current, vertices[i + 1]);
+        }
+
+        x_center.add(static_cast<double>(current.x));
+        y_center.add(static_cast<double>(current.y));
+        properties.box.expand(current);
     }
 
-    vertices = std::make_unique<Point<T>[]>(size);
+    area.add(vertices[size - 1], vertices[0]);
+
+    properties.area = std::abs(area.value()) / 2.0;
+    properties.center = Point<double>(x_center.value() / size, y_center.value() / size);
+    return properties;
 }
 
 
-template <Scalar T>
-Polygon<T>::Polygon(const Polygon& other)
+// Кэш заполняет только тот поток, которому удалось перевести его из
+// cache_dirty в cache_filling, остальные в это время считают сами.
+template<Scalar T, ArithmeticPolicy Policy>
+typename Polygon<T, Policy>::Properties Polygon<T, Policy>::properties() const
 {
-    size = other.size;
-    vertices = std::make_unique<Point<T>[]>(size);
+    if (cache_state.load(std::memory_order_acquire) == cache_valid)
+    {
+        if constexpr (instrumentation_enabled)
+        {
+            PolygonCacheCounters::hit();
+        }
+        return cache;
+    }
 
-    for (size_t i = 0; i < size; ++i)
+    if constexpr (instrumentation_enabled)
     {
-        vertices[i] = other.vertices[i];
+        PolygonCacheCounters::miss();
     }
+    Properties computed = compute_properties();
+
+    unsigned char expected = cache_dirty;
+    if (cache_state.compare_exchange_strong(expected, cache_filling, std::memory_order_acquire, std::memory_order_relaxed))
+    {
+        cache = computed;
+        cache_state.store(cache_valid, std::memory_order_release);
+    }
+
+    return computed;
+}
+
+
+template<Scalar T, ArithmeticPolicy Policy>
+void Polygon<T, Policy>::invalidate() noexcept
+{
+    cache_state.store(cache_dirty, std::memory_order_relaxed);
+}
+
+
+template<Scalar T, ArithmeticPolicy Policy>
+void Polygon<T, Policy>::copy_cache(const Polygon& other) noexcept
+{
+    if (other.cache_state.load(std::memory_order_acquire) == cache_valid)
+    {
+        cache = other.cache;
+        cache_state.store(cache_valid, std::memory_order_release);
+    }
+    else
+    {
+        invalidate();
+    }
+}
+
+
+template<Scalar T, ArithmeticPolicy Policy>
+bool Polygon<T, Policy>::is_inline() const
+{
+    return vertices == local_vertices;
+}
+
+
+// Новая память берется до освобождения старой, поэтому при исключении
+// ресурса многоугольник остается прежним.
+template<Scalar T, ArithmeticPolicy Policy>
+void Polygon<T, Policy>::allocate(size_t new_size)
+{
+    Point<T>* fresh = new_size > inline_capacity ? allocator.allocate(new_size) : local_vertices;
+
+    invalidate();
+    deallocate();
+
+    vertices = fresh;
+    size = new_size;
 }
 
 
-template <Scalar T>
-Polygon<T>::Polygon(Polygon&& other) noexcept
+template<Scalar T, ArithmeticPolicy Policy>
+void Polygon<T, Policy>::deallocate() noexcept
 {
+    if (!is_inline())
+    {
+        allocator.deallocate(vertices, size);
+        vertices = local_vertices;
+    }
+
+    size = 0;
+}
+
+
+template<Scalar T, ArithmeticPolicy Policy>
+void Polygon<T, Policy>::steal(Polygon& other) noexcept
+{
+    copy_cache(other);
     size = other.size;
-    vertices = std::move(other.vertices);
+
+    if (other.is_inline())
+    {
+        copy_vertices(other.local_vertices, size, local_vertices);
+    }
+    else
+    {
+        vertices = other.vertices;
+    }
 
     other.size = 0;
-    other.vertices = nullptr;
+    other.vertices = other.local_vertices;
+    other.invalidate();
+}
+
+
+// Point тривиально копируется, поэтому вершины копируются одним memcpy.
+template<Scalar T, ArithmeticPolicy Policy>
+void Polygon<T, Policy>::copy_vertices(const Point<T>* source, size_t count, Point<T>* destination) noexcept
+{
+    static_assert(std::is_trivially_copyable_v<Point<T>>);
+
+    if (count > 0)
+    {
+        std::memcpy(destination, source, count * sizeof(Point<T>));
+    }
+}
+
+
+template<Scalar T, ArithmeticPolicy Policy>
+Polygon<T, Policy>::Polygon() {}
+
+
+template<Scalar T, ArithmeticPolicy Policy>
+Polygon<T, Policy>::Polygon(const allocator_type& allocator): allocator(allocator) {}
+
+
+template<Scalar T, ArithmeticPolicy Policy>
+Polygon<T, Policy>::Polygon(size_t size): Polygon(size, allocator_type()) {}
+
+
+template<Scalar T, ArithmeticPolicy Policy>
+Polygon<T, Policy>::Polygon(size_t size, const allocator_type& allocator): allocator(allocator)
+{
+    if (size < 3)
+    {
+        throw std::invalid_argument("The number of vertices of a polygon is not less than 3.");
+    }
+
+    allocate(size);
+    std::uninitialized_value_construct_n(vertices, size);
 }
 
 
-template <Scalar T>
-Point<double> Polygon<T>::calculate_center() const
+// Вершины копируются одним проходом, без нулевой инициализации и
+// проверок индекса set_vertex.
+template<Scalar T, ArithmeticPolicy Policy>
+Polygon<T, Policy>::Polygon(std::span<const Point<T>> vertices, const allocator_type& allocator): allocator(allocator)
 {
-    if (vertices == nullptr)
+    if (vertices.size() < 3)
     {
-        throw std::runtime_error("The pointer to the vertices is equal to nullptr.");
+        throw std::invalid_argument("The number of vertices of a polygon is not less than 3.");
     }
 
-    double x_center = 0.0;
-    double y_center = 0.0;
+    allocate(vertices.size());
+    copy_vertices(vertices.data(), size, this->vertices);
+}
+
+
+// coordinates - x0, y0, x1, y1, ...
+template<Scalar T, ArithmeticPolicy Policy>
+Polygon<T, Policy>::Polygon(std::span<const T> coordinates, const allocator_type& allocator): allocator(allocator)
+{
+    if (coordinates.size() % 2 != 0)
+    {
+        throw std::invalid_argument("The number of coordinates of a polygon must be even.");
+    }
+    if (coordinates.size() < 6)
+    {
+        throw std::invalid_argument("The number of vertices of a polygon is not less than 3.");
+    }
 
+    allocate(coordinates.size() / 2);
     for (size_t i = 0; i < size; ++i)
     {
-        x_center += static_cast<double>(vertices[i].x);
-        y_center += static_cast<double>(vertices[i].y);
+        std::construct_at(vertices + i, coordinates[2 * i], coordinates[2 * i + 1]);
     }
-    
-    return Point<double>(x_center / size, y_center / size);
 }
 
 
-template<Scalar T>
-std::ostream& Polygon<T>::write_to_stream(std::ostream& ostream) const
+template<Scalar T, ArithmeticPolicy Policy>
+Polygon<T, Policy>::Polygon(const Polygon& other): Polygon(other, allocator_type()) {}
+
+
+template<Scalar T, ArithmeticPolicy Policy>
+Polygon<T, Policy>::Polygon(const Polygon& other, const allocator_type& allocator): allocator(allocator)
+{
+    GEOMETRY_INSTRUMENT(InstrumentedOperation::PolygonCopy, other.size);
+    allocate(other.size);
+    copy_vertices(other.vertices, size, vertices);
+    copy_cache(other);
+}
+
+
+template<Scalar T, ArithmeticPolicy Policy>
+Polygon<T, Policy>::Polygon(Polygon&& other) noexcept: allocator(other.allocator)
+{
+    steal(other);
+}
+
+
+template<Scalar T, ArithmeticPolicy Policy>
+Polygon<T, Policy>::Polygon(Polygon&& other, const allocator_type& allocator): allocator(allocator)
+{
+    if (other.is_inline() || allocator == other.allocator)
+    {
+        steal(other);
+        return;
+    }
+
+    GEOMETRY_INSTRUMENT(InstrumentedOperation::PolygonCopy, other.size);
+    allocate(other.size);
+    copy_vertices(other.vertices, size, vertices);
+    copy_cache(other);
+}
+
+
+template<Scalar T, ArithmeticPolicy Policy>
+Polygon<T, Policy>::~Polygon() noexcept
+{
+    deallocate();
+}
+
+
+template<Scalar T, ArithmeticPolicy Policy>
+const Point<T>* Polygon<T, Policy>::vertex_data() const
+{
+    return vertices;
+}
+
+
+template<Scalar T, ArithmeticPolicy Policy>
+Point<double> Polygon<T, Policy>::calculate_center() const
+{
+    if (size == 0)
+    {
+        throw std::runtime_error("The polygon has no vertices.");
+    }
+
+    return properties().center;
+}
+
+
+template<Scalar T, ArithmeticPolicy Policy>
+std::ostream& Polygon<T, Policy>::write_to_stream(std::ostream& ostream) const
 {
     if (size == 0)
     {
         return ostream << "Empty";
     }
 
-    for (int i = 0; i < size; ++i)
+    for (size_t i = 0; i < size; ++i)
     {
-        ostream << "(" << this->vertices[i].x << ", " << this->vertices[i].y << ")" << std::endl; 
+        ostream << "(" << this->vertices[i].x << ", " << this->vertices[i].y << ")\n";
     }
 
     return ostream;
 }
 
 
-template<Scalar T>
-std::istream& Polygon<T>::read_from_stream(std::istream& istream)
+template<Scalar T, ArithmeticPolicy Policy>
+std::istream& Polygon<T, Policy>::read_from_stream(std::istream& istream)
 {
+    invalidate();
+
     for (size_t i = 0; i < size; ++i)
     {
         T x, y;
@@ -127,8 +414,8 @@ std::istream& Polygon<T>::read_from_stream(std::istream& istream)
 }
 
 
-template<Scalar T>
-void Polygon<T>::set_vertex(size_t index, Point<T> point)
+template<Scalar T, ArithmeticPolicy Policy>
+void Polygon<T, Policy>::set_vertex(size_t index, Point<T> point)
 {
     if (index < 0 || index >= size)
     {
@@ -136,40 +423,38 @@ void Polygon<T>::set_vertex(size_t index, Point<T> point)
     }
 
     vertices[index] = point;
+    invalidate();
 }
 
 
-template<Scalar T>
-double Polygon<T>::area() const
+template<Scalar T, ArithmeticPolicy Policy>
+double Polygon<T, Policy>::area() const
 {
-    double area = 0;
-
-    for (int i = 0; i < size; ++i) {
-        const Point<T>& current = vertices[i];
-        const Point<T>& next = vertices[(i + 1) % size];
-        area += (current.x * next.y - next.x * current.y);
+    if (size == 0)
+    {
+        return 0.0;
     }
 
-    return std::abs(area) / 2.0;
+    return properties().area;
 }
 
 
-template<Scalar T>
-Point<double> Polygon<T>::get_center() const
+template<Scalar T, ArithmeticPolicy Policy>
+Point<double> Polygon<T, Policy>::get_center() const
 {
     return this->calculate_center();
 }
 
 
-template<Scalar T>
-size_t Polygon<T>::vertex_count() const
+template<Scalar T, ArithmeticPolicy Policy>
+size_t Polygon<T, Policy>::vertex_count() const
 {
     return size;
 }
 
 
-template<Scalar T>
-Point<T> Polygon<T>::get_vertex(size_t index) const
+template<Scalar T, ArithmeticPolicy Policy>
+Point<T> Polygon<T, Policy>::get_vertex(size_t index) const
 {
     if (index < 0 || index >= size)
     {
@@ -180,48 +465,145 @@ Point<T> Polygon<T>::get_vertex(size_t index) const
 }
 
 
-template<Scalar T>
-Polygon<T>::operator double() const
+template<Scalar T, ArithmeticPolicy Policy>
+BoundingBox<T> Polygon<T, Policy>::bounding_box() const
+{
+    if (size == 0)
+    {
+        throw std::runtime_error("The polygon has no vertices.");
+    }
+
+    return properties().box;
+}
+
+
+// Правило ненулевого числа оборотов; точки на границе считаются
+// принадлежащими многоугольнику. Сначала отсекаем по габариту из кэша.
+template<Scalar T, ArithmeticPolicy Policy>
+bool Polygon<T, Policy>::contains(const Point<T>& point) const
+{
+    if (size == 0 || !bounding_box().contains(point))
+    {
+        return false;
+    }
+
+    bool on_boundary = false;
+    const int winding = polygon_winding_number<Policy>(vertices, size, point, on_boundary);
+    return on_boundary || winding != 0;
+}
+
+
+// Сколько раз контур обходит точку против часовой стрелки
+// (по часовой - со знаком минус).
+template<Scalar T, ArithmeticPolicy Policy>
+int Polygon<T, Policy>::winding_number(const Point<T>& point) const
+{
+    bool on_boundary = false;
+    return polygon_winding_number<Policy>(vertices, size, point, on_boundary);
+}
+
+
+template<Scalar T, ArithmeticPolicy Policy>
+bool Polygon<T, Policy>::is_convex() const
+{
+    return polygon_is_convex<Policy>(vertices, size);
+}
+
+
+template<Scalar T, ArithmeticPolicy Policy>
+double Polygon<T, Policy>::perimeter() const
+{
+    return polygon_perimeter<Policy>(vertices, size);
+}
+
+
+// Касание границами считается пересечением. Для двух выпуклых
+// многоугольников - разделяющие оси, иначе (и всегда при точной
+// политике) перебор пар ребер.
+template<Scalar T, ArithmeticPolicy Policy>
+bool Polygon<T, Policy>::intersects(const Polygon& other) const
+{
+    if (size == 0 || other.size == 0 || !bounding_box().intersects(other.bounding_box()))
+    {
+        return false;
+    }
+
+    if (!Policy::exact && is_convex() && other.is_convex())
+    {
+        return convex_polygons_intersect(vertices, size, other.vertices, other.size);
+    }
+
+    return polygons_intersect<Policy>(vertices, size, other.vertices, other.size);
+}
+
+
+template<Scalar T, ArithmeticPolicy Policy>
+CacheStatistics Polygon<T, Policy>::cache_statistics()
+{
+    return PolygonCacheCounters::snapshot();
+}
+
+
+template<Scalar T, ArithmeticPolicy Policy>
+void Polygon<T, Policy>::reset_cache_statistics()
+{
+    PolygonCacheCounters::reset();
+}
+
+
+template<Scalar T, ArithmeticPolicy Policy>
+Polygon<T, Policy>::operator double() const
 {
     return this->area();
 }
 
 
-template<Scalar T>
-Polygon<T>& Polygon<T>::operator=(const Polygon& other)
+template<Scalar T, ArithmeticPolicy Policy>
+typename Polygon<T, Policy>::allocator_type Polygon<T, Policy>::get_allocator() const
+{
+    return allocator;
+}
+
+
+template<Scalar T, ArithmeticPolicy Policy>
+Polygon<T, Policy>& Polygon<T, Policy>::operator=(const Polygon& other)
 {
     if (this == &other)
     {
         return *this;
     }
 
-    size = other.size;
-    vertices = std::make_unique<Point<T>[]>(size);
-
-    for (size_t i = 0; i < size; ++i)
+    GEOMETRY_INSTRUMENT(InstrumentedOperation::PolygonCopy, other.size);
+    if (size != other.size)
     {
-        vertices[i] = other.vertices[i];
+        allocate(other.size);
     }
 
+    copy_vertices(other.vertices, size, vertices);
+    copy_cache(other);
+
     return *this;
 }  
 
 
-template<Scalar T>
-Polygon<T>& Polygon<T>::operator=(Polygon&& other) noexcept
+// С другим ресурсом памяти вершины копируются, а это выделение памяти
+// и возможное исключение, поэтому оператор не noexcept.
+template<Scalar T, ArithmeticPolicy Policy>
+Polygon<T, Policy>& Polygon<T, Policy>::operator=(Polygon&& other)
 {
     if (this == &other)
     {
         return *this;
     }
 
-    size = other.size;
-    vertices = std::move(other.vertices);
-
-    other.size = 0;
-    other.vertices = nullptr;
+    if (other.is_inline() || allocator == other.allocator)
+    {
+        deallocate();
+        steal(other);
+        return *this;
+    }
 
-    return *this;
+    return *this = other;
 }
 
 
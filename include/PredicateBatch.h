@@ -0,0 +1,253 @@
+#ifndef PREDICATE_BATCH_H
+#define PREDICATE_BATCH_H
+
+
+#include "AreaBatch.h"
+#include "BoundingBox.h"
+#include "Point.h"
+#include "Polygon.h"
+#include "Predicates.h"
+#include <algorithm>
+#include <cstddef>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+
+// Пакетная проверка принадлежности точек одному многоугольнику.
+//
+// Вершины один раз переводятся в double и раскладываются по осям, после
+// чего векторные ядра проверяют несколько точек одновременно (по точке на
+// линию), проходя по ребрам с теми же операциями, что и winding_step.
+// Поэтому out[i] совпадает с polygon.contains(points[i]) для любого уровня
+// SIMD. Уровень выбирается так же, как в area_batch: set_simd_level.
+// Многоугольники с RobustArithmetic пакетно не проверяются.
+
+
+// Вклад ребра (a, b) в число оборотов вокруг точки (x, y) - то же, что
+// шаг polygon_winding_number с FastArithmetic, но над координатами,
+// заранее приведенными к double. Векторные ядра повторяют эти операции
+// дословно.
+inline int winding_step(double a_x, double a_y, double b_x, double b_y, double x, double y, bool& on_edge)
+{
+    const double cross = (b_x - a_x) * (y - a_y) - (x - a_x) * (b_y - a_y);
+
+    if (cross == 0.0 && std::min(a_x, b_x) <= x && x <= std::max(a_x, b_x) && std::min(a_y, b_y) <= y && y <= std::max(a_y, b_y))
+    {
+        on_edge = true;
+    }
+
+    if (a_y <= y)
+    {
+        return (b_y > y && cross > 0.0) ? 1 : 0;
+    }
+
+    return (b_y <= y && cross < 0.0) ? -1 : 0;
+}
+
+
+struct ContainsBatchShape
+{
+    const double* xs;
+    const double* ys;
+    size_t size;
+    double min_x;
+    double min_y;
+    double max_x;
+    double max_y;
+};
+
+
+template<Scalar T>
+void contains_batch_scalar(const ContainsBatchShape& shape, const Point<T>* points, size_t count, unsigned char* out)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        const double x = static_cast<double>(points[i].x);
+        const double y = static_cast<double>(points[i].y);
+
+        if (!(shape.min_x <= x && x <= shape.max_x && shape.min_y <= y && y <= shape.max_y))
+        {
+            out[i] = 0;
+            continue;
+        }
+
+        bool on_boundary = false;
+        int winding = 0;
+        for (size_t k = 0; k < shape.size; ++k)
+        {
+            const size_t next = (k + 1 == shape.size) ? 0 : k + 1;
+            winding += winding_step(shape.xs[k], shape.ys[k], shape.xs[next], shape.ys[next], x, y, on_boundary);
+        }
+
+        out[i] = (on_boundary || winding != 0) ? 1 : 0;
+    }
+}
+
+
+#ifdef AREA_BATCH_X86
+
+template<Scalar T>
+__attribute__((target("sse4.1")))
+void contains_batch_sse4(const ContainsBatchShape& shape, const Point<T>* points, size_t count, unsigned char* out)
+{
+    const __m128d zero = _mm_setzero_pd();
+    const __m128d one = _mm_set1_pd(1.0);
+    size_t i = 0;
+
+    for (; i + 2 <= count; i += 2)
+    {
+        const __m128d x = _mm_set_pd(static_cast<double>(points[i + 1].x), static_cast<double>(points[i].x));
+        const __m128d y = _mm_set_pd(static_cast<double>(points[i + 1].y), static_cast<double>(points[i].y));
+        const __m128d in_box = _mm_and_pd(_mm_and_pd(_mm_cmple_pd(_mm_set1_pd(shape.min_x), x), _mm_cmple_pd(x, _mm_set1_pd(shape.max_x))),
+                                          _mm_and_pd(_mm_cmple_pd(_mm_set1_pd(shape.min_y), y), _mm_cmple_pd(y, _mm_set1_pd(shape.max_y))));
+        if (_mm_movemask_pd(in_box) == 0)
+        {
+            out[i] = out[i + 1] = 0;
+            continue;
+        }
+
+        __m128d winding = zero;
+        __m128d on_edge = zero;
+
+        for (size_t k = 0; k < shape.size; ++k)
+        {
+            const size_t next = (k + 1 == shape.size) ? 0 : k + 1;
+            const __m128d a_x = _mm_set1_pd(shape.xs[k]);
+            const __m128d a_y = _mm_set1_pd(shape.ys[k]);
+            const __m128d b_x = _mm_set1_pd(shape.xs[next]);
+            const __m128d b_y = _mm_set1_pd(shape.ys[next]);
+            const __m128d cross = _mm_sub_pd(_mm_mul_pd(_mm_sub_pd(b_x, a_x), _mm_sub_pd(y, a_y)),
+                                             _mm_mul_pd(_mm_sub_pd(x, a_x), _mm_sub_pd(b_y, a_y)));
+
+            const __m128d within_x = _mm_and_pd(_mm_cmple_pd(_mm_min_pd(a_x, b_x), x), _mm_cmple_pd(x, _mm_max_pd(a_x, b_x)));
+            const __m128d within_y = _mm_and_pd(_mm_cmple_pd(_mm_min_pd(a_y, b_y), y), _mm_cmple_pd(y, _mm_max_pd(a_y, b_y)));
+            on_edge = _mm_or_pd(on_edge, _mm_and_pd(_mm_cmpeq_pd(cross, zero), _mm_and_pd(within_x, within_y)));
+
+            const __m128d a_below = _mm_cmple_pd(a_y, y);
+            const __m128d b_above = _mm_cmpgt_pd(b_y, y);
+            const __m128d up = _mm_and_pd(_mm_and_pd(a_below, b_above), _mm_cmpgt_pd(cross, zero));
+            const __m128d down = _mm_andnot_pd(_mm_or_pd(a_below, b_above), _mm_cmplt_pd(cross, zero));
+            winding = _mm_sub_pd(_mm_add_pd(winding, _mm_and_pd(up, one)), _mm_and_pd(down, one));
+        }
+
+        const __m128d inside = _mm_and_pd(in_box, _mm_or_pd(on_edge, _mm_cmpneq_pd(winding, zero)));
+        const int mask = _mm_movemask_pd(inside);
+        out[i] = mask & 1;
+        out[i + 1] = (mask >> 1) & 1;
+    }
+
+    contains_batch_scalar(shape, points + i, count - i, out + i);
+}
+
+
+template<Scalar T>
+__attribute__((target("avx2")))
+void contains_batch_avx2(const ContainsBatchShape& shape, const Point<T>* points, size_t count, unsigned char* out)
+{
+    const __m256d zero = _mm256_setzero_pd();
+    const __m256d one = _mm256_set1_pd(1.0);
+    size_t i = 0;
+
+    for (; i + 4 <= count; i += 4)
+    {
+        const __m256d x = _mm256_set_pd(static_cast<double>(points[i + 3].x), static_cast<double>(points[i + 2].x),
+                                        static_cast<double>(points[i + 1].x), static_cast<double>(points[i].x));
+        const __m256d y = _mm256_set_pd(static_cast<double>(points[i + 3].y), static_cast<double>(points[i + 2].y),
+                                        static_cast<double>(points[i + 1].y), static_cast<double>(points[i].y));
+        const __m256d in_box = _mm256_and_pd(
+            _mm256_and_pd(_mm256_cmp_pd(_mm256_set1_pd(shape.min_x), x, _CMP_LE_OQ), _mm256_cmp_pd(x, _mm256_set1_pd(shape.max_x), _CMP_LE_OQ)),
+            _mm256_and_pd(_mm256_cmp_pd(_mm256_set1_pd(shape.min_y), y, _CMP_LE_OQ), _mm256_cmp_pd(y, _mm256_set1_pd(shape.max_y), _CMP_LE_OQ)));
+        if (_mm256_movemask_pd(in_box) == 0)
+        {
+            out[i] = out[i + 1] = out[i + 2] = out[i + 3] = 0;
+            continue;
+        }
+
+        __m256d winding = zero;
+        __m256d on_edge = zero;
+
+        for (size_t k = 0; k < shape.size; ++k)
+        {
+            const size_t next = (k + 1 == shape.size) ? 0 : k + 1;
+            const __m256d a_x = _mm256_set1_pd(shape.xs[k]);
+            const __m256d a_y = _mm256_set1_pd(shape.ys[k]);
+            const __m256d b_x = _mm256_set1_pd(shape.xs[next]);
+            const __m256d b_y = _mm256_set1_pd(shape.ys[next]);
+            const __m256d cross = _mm256_sub_pd(_mm256_mul_pd(_mm256_sub_pd(b_x, a_x), _mm256_sub_pd(y, a_y)),
+                                                _mm256_mul_pd(_mm256_sub_pd(x, a_x), _mm256_sub_pd(b_y, a_y)));
+
+            const __m256d within_x = _mm256_and_pd(_mm256_cmp_pd(_mm256_min_pd(a_x, b_x), x, _CMP_LE_OQ), _mm256_cmp_pd(x, _mm256_max_pd(a_x, b_x), _CMP_LE_OQ));
+            const __m256d within_y = _mm256_and_pd(_mm256_cmp_pd(_mm256_min_pd(a_y, b_y), y, _CMP_LE_OQ), _mm256_cmp_pd(y, _mm256_max_pd(a_y, b_y), _CMP_LE_OQ));
+            on_edge = _mm256_or_pd(on_edge, _mm256_and_pd(_mm256_cmp_pd(cross, zero, _CMP_EQ_OQ), _mm256_and_pd(within_x, within_y)));
+
+            const __m256d a_below = _mm256_cmp_pd(a_y, y, _CMP_LE_OQ);
+            const __m256d b_above = _mm256_cmp_pd(b_y, y, _CMP_GT_OQ);
+            const __m256d up = _mm256_and_pd(_mm256_and_pd(a_below, b_above), _mm256_cmp_pd(cross, zero, _CMP_GT_OQ));
+            const __m256d down = _mm256_andnot_pd(_mm256_or_pd(a_below, b_above), _mm256_cmp_pd(cross, zero, _CMP_LT_OQ));
+            winding = _mm256_sub_pd(_mm256_add_pd(winding, _mm256_and_pd(up, one)), _mm256_and_pd(down, one));
+        }
+
+        const __m256d inside = _mm256_and_pd(in_box, _mm256_or_pd(on_edge, _mm256_cmp_pd(winding, zero, _CMP_NEQ_OQ)));
+        const int mask = _mm256_movemask_pd(inside);
+        for (size_t lane = 0; lane < 4; ++lane)
+        {
+            out[i + lane] = (mask >> lane) & 1;
+        }
+    }
+
+    contains_batch_scalar(shape, points + i, count - i, out + i);
+}
+
+#endif // AREA_BATCH_X86
+
+
+// out[i] = 1, если polygon.contains(points[i]), иначе 0.
+template<Scalar T>
+void contains_batch(const Polygon<T>& polygon, std::span<const Point<T>> points, std::span<unsigned char> out)
+{
+    if (out.size() < points.size())
+    {
+        throw std::invalid_argument("Error: Output span is smaller than the number of points.");
+    }
+
+    const size_t size = polygon.vertex_count();
+    if (size == 0)
+    {
+        std::fill_n(out.begin(), points.size(), 0);
+        return;
+    }
+
+    std::vector<double> xs(size);
+    std::vector<double> ys(size);
+    for (size_t k = 0; k < size; ++k)
+    {
+        const Point<T> vertex = polygon.get_vertex(k);
+        xs[k] = static_cast<double>(vertex.x);
+        ys[k] = static_cast<double>(vertex.y);
+    }
+
+    const BoundingBox<T> box = polygon.bounding_box();
+    const ContainsBatchShape shape{xs.data(), ys.data(), size,
+                                   static_cast<double>(box.min.x), static_cast<double>(box.min.y),
+                                   static_cast<double>(box.max.x), static_cast<double>(box.max.y)};
+
+#ifdef AREA_BATCH_X86
+    switch (get_simd_level())
+    {
+    case SimdLevel::AVX2:
+        contains_batch_avx2(shape, points.data(), points.size(), out.data());
+        return;
+    case SimdLevel::SSE4:
+        contains_batch_sse4(shape, points.data(), points.size(), out.data());
+        return;
+    case SimdLevel::Scalar:
+        break;
+    }
+#endif
+
+    contains_batch_scalar(shape, points.data(), points.size(), out.data());
+}
+
+
+#endif // PREDICATE_BATCH_H
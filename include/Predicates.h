@@ -0,0 +1,225 @@
+#ifndef PREDICATES_H
+#define PREDICATES_H
+
+
+#include "Arithmetic.h"
+#include "Point.h"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+
+// Геометрические предикаты над массивом вершин многоугольника.
+// Знаки векторных произведений и суммы берутся из политики арифметики
+// (Arithmetic.h); с FastArithmetic все считается в double.
+
+
+template<Scalar T>
+bool within_segment_box(const Point<T>& a, const Point<T>& b, const Point<T>& point)
+{
+    return std::min(a.x, b.x) <= point.x && point.x <= std::max(a.x, b.x) && std::min(a.y, b.y) <= point.y && point.y <= std::max(a.y, b.y);
+}
+
+
+// Число оборотов контура вокруг точки: +1 за ребро, идущее вверх через
+// горизонталь точки, когда точка слева от него, и -1 за ребро вниз,
+// когда справа. Точка на самом ребре отмечается в on_boundary.
+template<ArithmeticPolicy Policy = FastArithmetic, Scalar T>
+int polygon_winding_number(const Point<T>* vertices, size_t size, const Point<T>& point, bool& on_boundary)
+{
+    int winding = 0;
+
+    on_boundary = false;
+    for (size_t i = 0; i < size; ++i)
+    {
+        const Point<T>& a = vertices[i];
+        const Point<T>& b = vertices[i + 1 == size ? 0 : i + 1];
+        const int side = Policy::orientation(a, b, point);
+
+        if (side == 0 && within_segment_box(a, b, point))
+        {
+            on_boundary = true;
+        }
+
+        if (a.y <= point.y)
+        {
+            winding += (b.y > point.y && side > 0) ? 1 : 0;
+        }
+        else
+        {
+            winding -= (b.y <= point.y && side < 0) ? 1 : 0;
+        }
+    }
+
+    return winding;
+}
+
+
+// Выпуклость: повороты всех соседних ребер одного знака (нулевые
+// допускаются), а направление по x меняется не больше двух раз -
+// это отсекает самопересекающиеся звезды. Вырожденный многоугольник,
+// у которого все вершины на одной прямой, выпуклым не считается.
+template<ArithmeticPolicy Policy = FastArithmetic, Scalar T>
+bool polygon_is_convex(const Point<T>* vertices, size_t size)
+{
+    if (size < 3)
+    {
+        return false;
+    }
+
+    int turn = 0;
+    int direction = 0;
+    int first_direction = 0;
+    size_t flips = 0;
+
+    for (size_t i = 0; i < size; ++i)
+    {
+        const Point<T>& a = vertices[i];
+        const Point<T>& b = vertices[(i + 1) % size];
+        const Point<T>& c = vertices[(i + 2) % size];
+        const int side = Policy::orientation(a, b, c);
+
+        if (side != 0)
+        {
+            if (turn != 0 && side != turn)
+            {
+                return false;
+            }
+            turn = side;
+        }
+
+        if (a.x != b.x)
+        {
+            const int sign = a.x < b.x ? 1 : -1;
+            if (direction == 0)
+            {
+                first_direction = sign;
+            }
+            else if (sign != direction)
+            {
+                ++flips;
+            }
+            direction = sign;
+        }
+    }
+
+    if (direction != 0 && direction != first_direction)
+    {
+        ++flips;
+    }
+
+    return turn != 0 && flips <= 2;
+}
+
+
+template<ArithmeticPolicy Policy = FastArithmetic, Scalar T>
+double polygon_perimeter(const Point<T>* vertices, size_t size)
+{
+    if (size < 2)
+    {
+        return 0.0;
+    }
+
+    typename Policy::Sum perimeter;
+
+    for (size_t i = 0; i < size; ++i)
+    {
+        const Point<T>& a = vertices[i];
+        const Point<T>& b = vertices[i + 1 == size ? 0 : i + 1];
+        const double dx = static_cast<double>(b.x) - static_cast<double>(a.x);
+        const double dy = static_cast<double>(b.y) - static_cast<double>(a.y);
+        perimeter.add(std::sqrt(dx * dx + dy * dy));
+    }
+
+    return perimeter.value();
+}
+
+
+// Теорема о разделяющей оси для двух выпуклых многоугольников: они
+// не пересекаются, только если проекции на нормаль какого-то ребра
+// не перекрываются. Касание считается пересечением. Проекции
+// считаются в double, поэтому точная политика этим не пользуется.
+template<Scalar T>
+bool convex_polygons_intersect(const Point<T>* first, size_t first_size, const Point<T>* second, size_t second_size)
+{
+    auto project = [](const Point<T>* vertices, size_t size, double axis_x, double axis_y, double& low, double& high)
+    {
+        low = high = axis_x * static_cast<double>(vertices[0].x) + axis_y * static_cast<double>(vertices[0].y);
+        for (size_t i = 1; i < size; ++i)
+        {
+            const double value = axis_x * static_cast<double>(vertices[i].x) + axis_y * static_cast<double>(vertices[i].y);
+            low = std::min(low, value);
+            high = std::max(high, value);
+        }
+    };
+
+    auto separated = [&](const Point<T>* edges, size_t size)
+    {
+        for (size_t i = 0; i < size; ++i)
+        {
+            const Point<T>& a = edges[i];
+            const Point<T>& b = edges[i + 1 == size ? 0 : i + 1];
+            const double axis_x = static_cast<double>(a.y) - static_cast<double>(b.y);
+            const double axis_y = static_cast<double>(b.x) - static_cast<double>(a.x);
+            double first_low, first_high, second_low, second_high;
+
+            project(first, first_size, axis_x, axis_y, first_low, first_high);
+            project(second, second_size, axis_x, axis_y, second_low, second_high);
+            if (first_high < second_low || second_high < first_low)
+            {
+                return true;
+            }
+        }
+        return false;
+    };
+
+    return !separated(first, first_size) && !separated(second, second_size);
+}
+
+
+// Пересечение отрезков [a, b] и [c, d], включая касание концами
+// и наложение на одной прямой.
+template<ArithmeticPolicy Policy = FastArithmetic, Scalar T>
+bool segments_intersect(const Point<T>& a, const Point<T>& b, const Point<T>& c, const Point<T>& d)
+{
+    const int abc = Policy::orientation(a, b, c);
+    const int abd = Policy::orientation(a, b, d);
+    const int cda = Policy::orientation(c, d, a);
+    const int cdb = Policy::orientation(c, d, b);
+
+    if (abc * abd < 0 && cda * cdb < 0)
+    {
+        return true;
+    }
+
+    return (abc == 0 && within_segment_box(a, b, c)) || (abd == 0 && within_segment_box(a, b, d))
+        || (cda == 0 && within_segment_box(c, d, a)) || (cdb == 0 && within_segment_box(c, d, b));
+}
+
+
+// Общий случай: пересекаются ребра или один многоугольник целиком
+// лежит внутри другого. O(n * m) - для выпуклых быстрее
+// convex_polygons_intersect.
+template<ArithmeticPolicy Policy = FastArithmetic, Scalar T>
+bool polygons_intersect(const Point<T>* first, size_t first_size, const Point<T>* second, size_t second_size)
+{
+    for (size_t i = 0; i < first_size; ++i)
+    {
+        const Point<T>& a = first[i];
+        const Point<T>& b = first[i + 1 == first_size ? 0 : i + 1];
+        for (size_t j = 0; j < second_size; ++j)
+        {
+            if (segments_intersect<Policy>(a, b, second[j], second[j + 1 == second_size ? 0 : j + 1]))
+            {
+                return true;
+            }
+        }
+    }
+
+    bool on_boundary = false;
+    return polygon_winding_number<Policy>(second, second_size, first[0], on_boundary) != 0
+        || polygon_winding_number<Policy>(first, first_size, second[0], on_boundary) != 0;
+}
+
+
+#endif // PREDICATES_H
@@ -0,0 +1,83 @@
+#ifndef QUADRILATERAL_H
+#define QUADRILATERAL_H
+
+
+#include "Point.h"
+#include <array>
+#include <cstddef>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+
+
+// Развернутые ядра для четырехугольников. Площадь считается через
+// диагонали: |d1 x d2| / 2. Для любого простого четырехугольника это
+// то же самое, что формула шнурования, но без цикла и в double, поэтому
+// для целочисленных координат не переполняется. Для прямоугольника
+// формула вырождается в ширину на высоту, для ромба - в половину
+// произведения диагоналей, для трапеции - в полусумму оснований на высоту.
+template<Scalar T>
+constexpr double quad_area(const Point<T>* vertices)
+{
+    const double d1_x = static_cast<double>(vertices[2].x) - static_cast<double>(vertices[0].x);
+    const double d1_y = static_cast<double>(vertices[2].y) - static_cast<double>(vertices[0].y);
+    const double d2_x = static_cast<double>(vertices[3].x) - static_cast<double>(vertices[1].x);
+    const double d2_y = static_cast<double>(vertices[3].y) - static_cast<double>(vertices[1].y);
+    const double cross = d1_x * d2_y - d2_x * d1_y;
+
+    return (cross < 0.0 ? -cross : cross) / 2.0;
+}
+
+
+// Среднее вершин; порядок суммирования тот же, что в Polygon,
+// поэтому результат совпадает с общим путем до бита.
+template<Scalar T>
+constexpr Point<double> quad_center(const Point<T>* vertices)
+{
+    double x_center = 0.0;
+    double y_center = 0.0;
+
+    x_center += static_cast<double>(vertices[0].x);
+    x_center += static_cast<double>(vertices[1].x);
+    x_center += static_cast<double>(vertices[2].x);
+    x_center += static_cast<double>(vertices[3].x);
+    y_center += static_cast<double>(vertices[0].y);
+    y_center += static_cast<double>(vertices[1].y);
+    y_center += static_cast<double>(vertices[2].y);
+    y_center += static_cast<double>(vertices[3].y);
+
+    return Point<double>(x_center / 4, y_center / 4);
+}
+
+
+template<Scalar T>
+constexpr double quad_area(const std::array<Point<T>, 4>& vertices)
+{
+    return quad_area(vertices.data());
+}
+
+
+template<Scalar T>
+constexpr Point<double> quad_center(const std::array<Point<T>, 4>& vertices)
+{
+    return quad_center(vertices.data());
+}
+
+
+// Проверяет буфер для конструкторов четырехугольников: ровно четыре
+// вершины или восемь чередующихся координат.
+template<class U>
+std::span<const U> quad_buffer(std::span<const U> buffer)
+{
+    constexpr size_t expected = std::is_scalar_v<U> ? 8 : 4;
+
+    if (buffer.size() != expected)
+    {
+        throw std::invalid_argument("Error: A quadrilateral has exactly 4 vertices.");
+    }
+
+    return buffer;
+}
+
+
+#endif // QUADRILATERAL_H
@@ -0,0 +1,512 @@
+#ifndef R_TREE_H
+#define R_TREE_H
+
+
+#include "BoundingBox.h"
+#include "Point.h"
+#include "SpatialEntry.h"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+
+// R-дерево по габаритам фигур. Начальное построение пакетное (STR:
+// сортировка центров по x, нарезка на вертикальные полосы, сортировка
+// полос по y), после него дерево поддерживается вставками с разбиением
+// переполненного узла пополам и удалениями, при которых опустевшие
+// узлы отсоединяются, а габариты предков пересчитываются.
+template<Scalar T>
+class RTree final
+{
+public:
+    constexpr static size_t node_capacity = 16;
+    constexpr static size_t npos = std::numeric_limits<size_t>::max();
+
+private:
+    struct Node
+    {
+        BoundingBox<T> box;
+        size_t parent = npos;
+        bool leaf = true;
+        std::vector<size_t> children;
+        std::vector<SpatialEntry<T>> entries;
+    };
+
+private:
+    std::vector<Node> nodes;
+    std::vector<size_t> free_nodes;
+    std::vector<size_t> leaf_of;
+    size_t root = npos;
+    size_t size = 0;
+
+private:
+    template<class Item, class Center>
+    static void sort_tiles(std::vector<Item>& items, Center center);
+    template<class Item, class Center>
+    static std::vector<Item> split_items(std::vector<Item>& items, Center center);
+    size_t make_node(bool leaf);
+    size_t item_count(size_t node) const;
+    void compute_box(size_t node);
+    void refit(size_t node);
+    void attach(size_t parent, size_t child);
+    void set_leaf(size_t id, size_t leaf);
+    size_t choose_leaf(const BoundingBox<T>& box) const;
+    void split(size_t node);
+
+public:
+    RTree() = default;
+    explicit RTree(std::vector<SpatialEntry<T>> entries);
+
+public:
+    void insert(const SpatialEntry<T>& entry);
+    bool remove(size_t id);
+    bool contains(size_t id) const;
+    size_t get_size() const;
+    template<class Visitor>
+    void visit_range(const BoundingBox<T>& box, Visitor visitor) const;
+    std::vector<size_t> nearest(const Point<double>& point, size_t k) const;
+};
+
+
+template<Scalar T>
+template<class Item, class Center>
+void RTree<T>::sort_tiles(std::vector<Item>& items, Center center)
+{
+    const size_t groups = (items.size() + node_capacity - 1) / node_capacity;
+    const size_t slices = static_cast<size_t>(std::ceil(std::sqrt(static_cast<double>(groups))));
+    const size_t slice_size = std::max<size_t>(slices, 1) * node_capacity;
+
+    std::sort(items.begin(), items.end(), [&](const Item& left, const Item& right)
+    {
+        return center(left).x < center(right).x;
+    });
+
+    for (size_t first = 0; first < items.size(); first += slice_size)
+    {
+        const size_t last = std::min(first + slice_size, items.size());
+        std::sort(items.begin() + first, items.begin() + last, [&](const Item& left, const Item& right)
+        {
+            return center(left).y < center(right).y;
+        });
+    }
+}
+
+
+// Делит узел пополам вдоль оси, по которой центры разбросаны сильнее.
+// Возвращает вторую половину, первая остается в items.
+template<Scalar T>
+template<class Item, class Center>
+std::vector<Item> RTree<T>::split_items(std::vector<Item>& items, Center center)
+{
+    BoundingBox<double> spread(center(items.front()), center(items.front()));
+    for (const Item& item : items)
+    {
+        spread.expand(center(item));
+    }
+
+    const bool by_x = spread.width() >= spread.height();
+    std::sort(items.begin(), items.end(), [&](const Item& left, const Item& right)
+    {
+        return by_x ? center(left).x < center(right).x : center(left).y < center(right).y;
+    });
+
+    const size_t half = items.size() / 2;
+    std::vector<Item> second(std::make_move_iterator(items.begin() + half), std::make_move_iterator(items.end()));
+    items.erase(items.begin() + half, items.end());
+    return second;
+}
+
+
+template<Scalar T>
+size_t RTree<T>::make_node(bool leaf)
+{
+    size_t node = nodes.size();
+
+    if (free_nodes.empty())
+    {
+        nodes.emplace_back();
+    }
+    else
+    {
+        node = free_nodes.back();
+        free_nodes.pop_back();
+        nodes[node] = Node();
+    }
+
+    nodes[node].leaf = leaf;
+    return node;
+}
+
+
+template<Scalar T>
+size_t RTree<T>::item_count(size_t node) const
+{
+    return nodes[node].leaf ? nodes[node].entries.size() : nodes[node].children.size();
+}
+
+
+template<Scalar T>
+void RTree<T>::compute_box(size_t node)
+{
+    Node& current = nodes[node];
+
+    if (current.leaf)
+    {
+        current.box = current.entries.front().box;
+        for (const auto& entry : current.entries)
+        {
+            current.box.expand(entry.box);
+        }
+    }
+    else
+    {
+        current.box = nodes[current.children.front()].box;
+        for (size_t child : current.children)
+        {
+            current.box.expand(nodes[child].box);
+        }
+    }
+}
+
+
+template<Scalar T>
+void RTree<T>::refit(size_t node)
+{
+    for (; node != npos; node = nodes[node].parent)
+    {
+        compute_box(node);
+    }
+}
+
+
+template<Scalar T>
+void RTree<T>::attach(size_t parent, size_t child)
+{
+    nodes[parent].children.push_back(child);
+    nodes[child].parent = parent;
+}
+
+
+template<Scalar T>
+void RTree<T>::set_leaf(size_t id, size_t leaf)
+{
+    if (id >= leaf_of.size())
+    {
+        leaf_of.resize(std::max(id + 1, leaf_of.size() * 2), npos);
+    }
+
+    leaf_of[id] = leaf;
+}
+
+
+// Спуск к листу, габарит которого меньше всего вырастет от вставки.
+template<Scalar T>
+size_t RTree<T>::choose_leaf(const BoundingBox<T>& box) const
+{
+    size_t node = root;
+
+    while (!nodes[node].leaf)
+    {
+        size_t best = nodes[node].children.front();
+        double best_growth = std::numeric_limits<double>::infinity();
+        double best_area = std::numeric_limits<double>::infinity();
+
+        for (size_t child : nodes[node].children)
+        {
+            const BoundingBox<T>& current = nodes[child].box;
+            BoundingBox<T> grown = current;
+            grown.expand(box);
+
+            const double area = current.width() * current.height();
+            const double growth = grown.width() * grown.height() - area;
+            if (growth < best_growth || (growth == best_growth && area < best_area))
+            {
+                best = child;
+                best_growth = growth;
+                best_area = area;
+            }
+        }
+
+        node = best;
+    }
+
+    return node;
+}
+
+
+template<Scalar T>
+void RTree<T>::split(size_t node)
+{
+    const size_t sibling = make_node(nodes[node].leaf);
+
+    if (nodes[node].leaf)
+    {
+        nodes[sibling].entries = split_items(nodes[node].entries, [](const SpatialEntry<T>& entry) { return entry.center; });
+        for (const auto& entry : nodes[sibling].entries)
+        {
+            leaf_of[entry.id] = sibling;
+        }
+    }
+    else
+    {
+        nodes[sibling].children = split_items(nodes[node].children, [this](size_t child) { return nodes[child].box.center(); });
+        for (size_t child : nodes[sibling].children)
+        {
+            nodes[child].parent = sibling;
+        }
+    }
+
+    compute_box(node);
+    compute_box(sibling);
+
+    if (node == root)
+    {
+        root = make_node(false);
+        attach(root, node);
+        attach(root, sibling);
+        compute_box(root);
+        return;
+    }
+
+    const size_t parent = nodes[node].parent;
+    attach(parent, sibling);
+    if (item_count(parent) > node_capacity)
+    {
+        split(parent);
+    }
+}
+
+
+template<Scalar T>
+RTree<T>::RTree(std::vector<SpatialEntry<T>> entries)
+{
+    if (entries.empty())
+    {
+        return;
+    }
+
+    sort_tiles(entries, [](const SpatialEntry<T>& entry) { return entry.center; });
+
+    std::vector<size_t> level;
+    for (size_t first = 0; first < entries.size(); first += node_capacity)
+    {
+        const size_t leaf = make_node(true);
+        const size_t last = std::min(first + node_capacity, entries.size());
+        nodes[leaf].entries.assign(entries.begin() + first, entries.begin() + last);
+
+        for (const auto& entry : nodes[leaf].entries)
+        {
+            if (contains(entry.id))
+            {
+                throw std::invalid_argument("Error: Duplicate id in the R-tree.");
+            }
+            set_leaf(entry.id, leaf);
+        }
+
+        compute_box(leaf);
+        level.push_back(leaf);
+    }
+
+    while (level.size() > 1)
+    {
+        sort_tiles(level, [this](size_t node) { return nodes[node].box.center(); });
+
+        std::vector<size_t> parents;
+        for (size_t first = 0; first < level.size(); first += node_capacity)
+        {
+            const size_t parent = make_node(false);
+            const size_t last = std::min(first + node_capacity, level.size());
+            for (size_t i = first; i < last; ++i)
+            {
+                attach(parent, level[i]);
+            }
+
+            compute_box(parent);
+            parents.push_back(parent);
+        }
+
+        level.swap(parents);
+    }
+
+    root = level.front();
+    size = entries.size();
+}
+
+
+template<Scalar T>
+void RTree<T>::insert(const SpatialEntry<T>& entry)
+{
+    if (contains(entry.id))
+    {
+        throw std::invalid_argument("Error: Duplicate id in the R-tree.");
+    }
+
+    if (root == npos)
+    {
+        root = make_node(true);
+        nodes[root].box = entry.box;
+    }
+
+    const size_t leaf = choose_leaf(entry.box);
+    nodes[leaf].entries.push_back(entry);
+    set_leaf(entry.id, leaf);
+    ++size;
+
+    for (size_t node = leaf; node != npos; node = nodes[node].parent)
+    {
+        nodes[node].box.expand(entry.box);
+    }
+
+    if (item_count(leaf) > node_capacity)
+    {
+        split(leaf);
+    }
+}
+
+
+template<Scalar T>
+bool RTree<T>::remove(size_t id)
+{
+    if (!contains(id))
+    {
+        return false;
+    }
+
+    size_t node = leaf_of[id];
+    std::vector<SpatialEntry<T>>& entries = nodes[node].entries;
+    auto position = std::find_if(entries.begin(), entries.end(), [id](const SpatialEntry<T>& entry) { return entry.id == id; });
+    *position = entries.back();
+    entries.pop_back();
+    leaf_of[id] = npos;
+
+    if (--size == 0)
+    {
+        nodes.clear();
+        free_nodes.clear();
+        root = npos;
+        return true;
+    }
+
+    while (node != root && item_count(node) == 0)
+    {
+        const size_t parent = nodes[node].parent;
+        std::vector<size_t>& siblings = nodes[parent].children;
+        siblings.erase(std::find(siblings.begin(), siblings.end(), node));
+        free_nodes.push_back(node);
+        node = parent;
+    }
+
+    refit(node);
+    return true;
+}
+
+
+template<Scalar T>
+bool RTree<T>::contains(size_t id) const
+{
+    return id < leaf_of.size() && leaf_of[id] != npos;
+}
+
+
+template<Scalar T>
+size_t RTree<T>::get_size() const
+{
+    return size;
+}
+
+
+// Вызывает visitor для каждой записи, габарит которой пересекает box.
+template<Scalar T>
+template<class Visitor>
+void RTree<T>::visit_range(const BoundingBox<T>& box, Visitor visitor) const
+{
+    if (root == npos)
+    {
+        return;
+    }
+
+    std::vector<size_t> stack(1, root);
+    while (!stack.empty())
+    {
+        const Node& node = nodes[stack.back()];
+        stack.pop_back();
+
+        if (!node.box.intersects(box))
+        {
+            continue;
+        }
+
+        if (node.leaf)
+        {
+            for (const auto& entry : node.entries)
+            {
+                if (entry.box.intersects(box))
+                {
+                    visitor(entry);
+                }
+            }
+        }
+        else
+        {
+            stack.insert(stack.end(), node.children.begin(), node.children.end());
+        }
+    }
+}
+
+
+// Поиск "сначала лучший": центр фигуры лежит внутри ее габарита, поэтому
+// расстояние до габарита узла - нижняя оценка для всех центров под ним.
+template<Scalar T>
+std::vector<size_t> RTree<T>::nearest(const Point<double>& point, size_t k) const
+{
+    NearestCollector collector(k);
+    if (root == npos || k == 0)
+    {
+        return collector.result();
+    }
+
+    using Candidate = std::pair<double, size_t>;
+    std::priority_queue<Candidate, std::vector<Candidate>, std::greater<Candidate>> queue;
+    queue.emplace(nodes[root].box.distance_squared(point), root);
+
+    while (!queue.empty())
+    {
+        const auto [distance, index] = queue.top();
+        queue.pop();
+
+        if (distance > collector.bound())
+        {
+            break;
+        }
+
+        const Node& node = nodes[index];
+        if (node.leaf)
+        {
+            for (const auto& entry : node.entries)
+            {
+                collector.offer(distance_squared(entry.center, point), entry.id);
+            }
+            continue;
+        }
+
+        for (size_t child : node.children)
+        {
+            const double child_distance = nodes[child].box.distance_squared(point);
+            if (child_distance <= collector.bound())
+            {
+                queue.emplace(child_distance, child);
+            }
+        }
+    }
+
+    return collector.result();
+}
+
+
+#endif // R_TREE_H
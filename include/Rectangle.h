@@ -3,33 +3,109 @@
 
 #include "Point.h"
 #include "Polygon.h"
+#include "Quadrilateral.h"
+#include <array>
+#include <span>
+
+
+// Прямоугольник со сторонами вдоль осей: левый нижний угол и размеры.
+template<Scalar T>
+struct RectangleParameters
+{
+    Point<T> origin;
+    T width = 0;
+    T height = 0;
+
+    constexpr std::array<Point<T>, 4> vertices() const;
+    constexpr double area() const;
+    constexpr Point<double> center() const;
+};
 
 template<Scalar T>
 class Rectangle final : public Polygon<T>
 {
+public:
+    using allocator_type = typename Polygon<T>::allocator_type;
+
+private:
     constexpr static size_t _amount_of_vertices = 4;
 
 public:
     Rectangle();
+    explicit Rectangle(const allocator_type& allocator);
+    explicit Rectangle(const RectangleParameters<T>& parameters, const allocator_type& allocator = allocator_type());
+    explicit Rectangle(std::span<const Point<T>> vertices, const allocator_type& allocator = allocator_type());
+    explicit Rectangle(std::span<const T> coordinates, const allocator_type& allocator = allocator_type());
     Rectangle(const Rectangle& other);
+    Rectangle(const Rectangle& other, const allocator_type& allocator);
     Rectangle(Rectangle&& other) noexcept;
+    Rectangle(Rectangle&& other, const allocator_type& allocator);
     ~Rectangle() noexcept override = default;
 
+protected:
+    Point<double> calculate_center() const override;
+
 public:
-    Rectangle& operator=(Rectangle&& other) noexcept; 
+    double area() const override;
+    Point<double> get_center() const override;
+    Rectangle& operator=(Rectangle&& other); 
     Rectangle& operator=(const Rectangle& other);
 };
 
 
+template<Scalar T>
+constexpr std::array<Point<T>, 4> RectangleParameters<T>::vertices() const
+{
+    return {
+        origin,
+        Point<T>(origin.x + width, origin.y),
+        Point<T>(origin.x + width, origin.y + height),
+        Point<T>(origin.x, origin.y + height)
+    };
+}
+
+template<Scalar T>
+constexpr double RectangleParameters<T>::area() const
+{
+    const double result = static_cast<double>(width) * static_cast<double>(height);
+    return result < 0.0 ? -result : result;
+}
+
+template<Scalar T>
+constexpr Point<double> RectangleParameters<T>::center() const
+{
+    return Point<double>(static_cast<double>(origin.x) + static_cast<double>(width) / 2.0,
+                         static_cast<double>(origin.y) + static_cast<double>(height) / 2.0);
+}
+
 template<Scalar T>
 Rectangle<T>::Rectangle(): Polygon<T>(_amount_of_vertices) {}
 
+template<Scalar T>
+Rectangle<T>::Rectangle(const allocator_type& allocator): Polygon<T>(_amount_of_vertices, allocator) {}
+
+template<Scalar T>
+Rectangle<T>::Rectangle(const RectangleParameters<T>& parameters, const allocator_type& allocator):
+    Polygon<T>(std::span<const Point<T>>(parameters.vertices()), allocator) {}
+
+template<Scalar T>
+Rectangle<T>::Rectangle(std::span<const Point<T>> vertices, const allocator_type& allocator): Polygon<T>(quad_buffer(vertices), allocator) {}
+
+template<Scalar T>
+Rectangle<T>::Rectangle(std::span<const T> coordinates, const allocator_type& allocator): Polygon<T>(quad_buffer(coordinates), allocator) {}
+
 template<Scalar T>
 Rectangle<T>::Rectangle(const Rectangle& other): Polygon<T>(other) {}
 
+template<Scalar T>
+Rectangle<T>::Rectangle(const Rectangle& other, const allocator_type& allocator): Polygon<T>(other, allocator) {}
+
 template<Scalar T>
 Rectangle<T>::Rectangle(Rectangle&& other) noexcept: Polygon<T>(std::move(other)) {}
 
+template<Scalar T>
+Rectangle<T>::Rectangle(Rectangle&& other, const allocator_type& allocator): Polygon<T>(std::move(other), allocator) {}
+
 template<Scalar T>
 Rectangle<T>& Rectangle<T>::operator=(const Rectangle& other)
 {
@@ -42,7 +118,7 @@ Rectangle<T>& Rectangle<T>::operator=(const Rectangle& other)
 }  
 
 template<Scalar T>
-Rectangle<T>& Rectangle<T>::operator=(Rectangle&& other) noexcept
+Rectangle<T>& Rectangle<T>::operator=(Rectangle&& other)
 {
     if (this != &other)
     {
@@ -52,5 +128,35 @@ Rectangle<T>& Rectangle<T>::operator=(Rectangle&& other) noexcept
     return *this;
 }
 
+// Площадь и центр считаются напрямую, мимо кэша Polygon: развернутое
+// ядро дешевле проверки кэша. Перемещенный объект вершин не имеет.
+template<Scalar T>
+double Rectangle<T>::area() const
+{
+    if (this->vertex_count() != _amount_of_vertices)
+    {
+        return Polygon<T>::area();
+    }
+
+    return quad_area(this->vertex_data());
+}
+
+template<Scalar T>
+Point<double> Rectangle<T>::get_center() const
+{
+    return calculate_center();
+}
+
+template<Scalar T>
+Point<double> Rectangle<T>::calculate_center() const
+{
+    if (this->vertex_count() != _amount_of_vertices)
+    {
+        return Polygon<T>::calculate_center();
+    }
+
+    return quad_center(this->vertex_data());
+}
+
 
 #endif // RECTANGLE_H
\ No newline at end of file
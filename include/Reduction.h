@@ -0,0 +1,215 @@
+#ifndef REDUCTION_H
+#define REDUCTION_H
+
+
+#include "Arithmetic.h"
+#include "Point.h"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+
+struct AreaStatistics
+{
+    size_t count = 0;
+    double total_area = 0.0;
+    double min_area = 0.0;
+    double max_area = 0.0;
+    Point<double> centroid;
+};
+
+
+// Частичный результат для Array::area_statistics.
+class AreaAccumulator final
+{
+private:
+    size_t count = 0;
+    CompensatedSum area;
+    double min_area = std::numeric_limits<double>::infinity();
+    double max_area = -std::numeric_limits<double>::infinity();
+    CompensatedSum x_center;
+    CompensatedSum y_center;
+
+public:
+    void add(double figure_area, const Point<double>& center);
+    void merge(const AreaAccumulator& other);
+    AreaStatistics result() const;
+};
+
+
+// Гистограмма площадей с равными корзинами на [low, high). Значения вне
+// диапазона считаются отдельно, память не зависит от числа фигур.
+class AreaHistogram final
+{
+private:
+    double low;
+    double high;
+    std::vector<size_t> bins;
+    size_t underflow = 0;
+    size_t overflow = 0;
+
+public:
+    AreaHistogram(double low, double high, size_t bin_count);
+
+public:
+    void add(double figure_area);
+    void merge(const AreaHistogram& other);
+    size_t bin_count() const;
+    size_t count(size_t bin) const;
+    double bin_low(size_t bin) const;
+    size_t get_underflow() const;
+    size_t get_overflow() const;
+    size_t total() const;
+};
+
+
+// Элементы Array бывают как фигурами, так и указателями на них.
+template<class T>
+const auto& figure_reference(const T& element)
+{
+    if constexpr (requires { element.area(); })
+    {
+        return element;
+    }
+    else
+    {
+        return *element;
+    }
+}
+
+
+inline void AreaAccumulator::add(double figure_area, const Point<double>& center)
+{
+    ++count;
+    area.add(figure_area);
+    min_area = std::min(min_area, figure_area);
+    max_area = std::max(max_area, figure_area);
+    x_center.add(center.x);
+    y_center.add(center.y);
+}
+
+
+inline void AreaAccumulator::merge(const AreaAccumulator& other)
+{
+    count += other.count;
+    area.merge(other.area);
+    min_area = std::min(min_area, other.min_area);
+    max_area = std::max(max_area, other.max_area);
+    x_center.merge(other.x_center);
+    y_center.merge(other.y_center);
+}
+
+
+inline AreaStatistics AreaAccumulator::result() const
+{
+    AreaStatistics statistics;
+
+    if (count == 0)
+    {
+        return statistics;
+    }
+
+    statistics.count = count;
+    statistics.total_area = area.value();
+    statistics.min_area = min_area;
+    statistics.max_area = max_area;
+    statistics.centroid = Point<double>(x_center.value() / count, y_center.value() / count);
+    return statistics;
+}
+
+
+
+inline AreaHistogram::AreaHistogram(double low, double high, size_t bin_count): low(low), high(high), bins(bin_count, 0)
+{
+    if (!(low < high) || bin_count == 0)
+    {
+        throw std::invalid_argument("Error: Histogram needs low < high and at least one bin.");
+    }
+}
+
+
+inline void AreaHistogram::add(double figure_area)
+{
+    if (figure_area < low)
+    {
+        ++underflow;
+        return;
+    }
+    if (!(figure_area < high))
+    {
+        ++overflow;
+        return;
+    }
+
+    const size_t bin = static_cast<size_t>((figure_area - low) / (high - low) * bins.size());
+    ++bins[std::min(bin, bins.size() - 1)];
+}
+
+
+inline void AreaHistogram::merge(const AreaHistogram& other)
+{
+    if (low != other.low || high != other.high || bins.size() != other.bins.size())
+    {
+        throw std::invalid_argument("Error: Histograms have different bins.");
+    }
+
+    for (size_t i = 0; i < bins.size(); ++i)
+    {
+        bins[i] += other.bins[i];
+    }
+    underflow += other.underflow;
+    overflow += other.overflow;
+}
+
+
+inline size_t AreaHistogram::bin_count() const
+{
+    return bins.size();
+}
+
+
+inline size_t AreaHistogram::count(size_t bin) const
+{
+    if (bin >= bins.size())
+    {
+        throw std::out_of_range("Error: index out of range.");
+    }
+
+    return bins[bin];
+}
+
+
+inline double AreaHistogram::bin_low(size_t bin) const
+{
+    return low + (high - low) * bin / bins.size();
+}
+
+
+inline size_t AreaHistogram::get_underflow() const
+{
+    return underflow;
+}
+
+
+inline size_t AreaHistogram::get_overflow() const
+{
+    return overflow;
+}
+
+
+inline size_t AreaHistogram::total() const
+{
+    size_t result = underflow + overflow;
+    for (size_t bin : bins)
+    {
+        result += bin;
+    }
+
+    return result;
+}
+
+
+#endif // REDUCTION_H
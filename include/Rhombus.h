@@ -1,34 +1,116 @@
 #ifndef RHOMBUS_H
 #define RHOMBUS_H
 
+#include "Point.h"
 #include "Polygon.h"
+#include "Quadrilateral.h"
+#include <array>
+#include <cstddef>
+#include <span>
+
+
+// Ромб с диагоналями вдоль осей: центр (origin) и длины диагоналей.
+// Для целых координат диагонали делятся пополам нацело, площадь
+// считается по фактически получившимся вершинам.
+template<Scalar T>
+struct RhombusParameters
+{
+    Point<T> origin;
+    T horizontal_diagonal = 0;
+    T vertical_diagonal = 0;
+
+    constexpr std::array<Point<T>, 4> vertices() const;
+    constexpr double area() const;
+    constexpr Point<double> center() const;
+};
 
 template<Scalar T>
 class Rhombus final : public Polygon<T>
 {
+public:
+    using allocator_type = typename Polygon<T>::allocator_type;
+
+private:
     constexpr static size_t _amount_of_vertices = 4;
 
 public:
     Rhombus();
+    explicit Rhombus(const allocator_type& allocator);
+    explicit Rhombus(const RhombusParameters<T>& parameters, const allocator_type& allocator = allocator_type());
+    explicit Rhombus(std::span<const Point<T>> vertices, const allocator_type& allocator = allocator_type());
+    explicit Rhombus(std::span<const T> coordinates, const allocator_type& allocator = allocator_type());
     Rhombus(const Rhombus& other);
+    Rhombus(const Rhombus& other, const allocator_type& allocator);
     Rhombus(Rhombus&& other) noexcept;
+    Rhombus(Rhombus&& other, const allocator_type& allocator);
     ~Rhombus() noexcept override = default;
 
+protected:
+    Point<double> calculate_center() const override;
+
 public:
-    Rhombus& operator=(Rhombus&& other) noexcept; 
+    double area() const override;
+    Point<double> get_center() const override;
+    Rhombus& operator=(Rhombus&& other); 
     Rhombus& operator=(const Rhombus& other);
 };
 
 
+template<Scalar T>
+constexpr std::array<Point<T>, 4> RhombusParameters<T>::vertices() const
+{
+    const T half_horizontal = horizontal_diagonal / 2;
+    const T half_vertical = vertical_diagonal / 2;
+
+    return {
+        Point<T>(origin.x - half_horizontal, origin.y),
+        Point<T>(origin.x, origin.y - half_vertical),
+        Point<T>(origin.x + half_horizontal, origin.y),
+        Point<T>(origin.x, origin.y + half_vertical)
+    };
+}
+
+template<Scalar T>
+constexpr double RhombusParameters<T>::area() const
+{
+    const double result = 2.0 * static_cast<double>(horizontal_diagonal / 2) * static_cast<double>(vertical_diagonal / 2);
+    return result < 0.0 ? -result : result;
+}
+
+template<Scalar T>
+constexpr Point<double> RhombusParameters<T>::center() const
+{
+    return Point<double>(static_cast<double>(origin.x), static_cast<double>(origin.y));
+}
+
 template<Scalar T>
 Rhombus<T>::Rhombus(): Polygon<T>(_amount_of_vertices) {}
 
+template<Scalar T>
+Rhombus<T>::Rhombus(const allocator_type& allocator): Polygon<T>(_amount_of_vertices, allocator) {}
+
+template<Scalar T>
+Rhombus<T>::Rhombus(const RhombusParameters<T>& parameters, const allocator_type& allocator):
+    Polygon<T>(std::span<const Point<T>>(parameters.vertices()), allocator) {}
+
+template<Scalar T>
+Rhombus<T>::Rhombus(std::span<const Point<T>> vertices, const allocator_type& allocator): Polygon<T>(quad_buffer(vertices), allocator) {}
+
+template<Scalar T>
+Rhombus<T>::Rhombus(std::span<const T> coordinates, const allocator_type& allocator): Polygon<T>(quad_buffer(coordinates), allocator) {}
+
 template<Scalar T>
 Rhombus<T>::Rhombus(const Rhombus& other): Polygon<T>(other) {}
 
+template<Scalar T>
+Rhombus<T>::Rhombus(const Rhombus& other, const allocator_type& allocator): Polygon<T>(other, allocator) {}
+
 template<Scalar T>
 Rhombus<T>::Rhombus(Rhombus&& other) noexcept: Polygon<T>(std::move(other)) {}
 
+template<Scalar T>
+Rhombus<T>::Rhombus(Rhombus&& other, const allocator_type& allocator): Polygon<T>(std::move(other), allocator) {}
+
 template<Scalar T>
 Rhombus<T>& Rhombus<T>::operator=(const Rhombus& other)
 {
@@ -41,7 +123,7 @@ Rhombus<T>& Rhombus<T>::operator=(const Rhombus& other)
 }  
 
 template<Scalar T>
-Rhombus<T>& Rhombus<T>::operator=(Rhombus&& other) noexcept
+Rhombus<T>& Rhombus<T>::operator=(Rhombus&& other)
 {
     if (this != &other)
     {
@@ -51,4 +133,34 @@ Rhombus<T>& Rhombus<T>::operator=(Rhombus&& other) noexcept
     return *this;
 }
 
+// Площадь ромба - половина произведения диагоналей, quad_area
+// считает ее через векторное произведение без обращения к кэшу.
+template<Scalar T>
+double Rhombus<T>::area() const
+{
+    if (this->vertex_count() != _amount_of_vertices)
+    {
+        return Polygon<T>::area();
+    }
+
+    return quad_area(this->vertex_data());
+}
+
+template<Scalar T>
+Point<double> Rhombus<T>::get_center() const
+{
+    return calculate_center();
+}
+
+template<Scalar T>
+Point<double> Rhombus<T>::calculate_center() const
+{
+    if (this->vertex_count() != _amount_of_vertices)
+    {
+        return Polygon<T>::calculate_center();
+    }
+
+    return quad_center(this->vertex_data());
+}
+
 #endif // RHOUMUS_H
\ No newline at end of file
@@ -0,0 +1,714 @@
+#ifndef SCENE_FILE_H
+#define SCENE_FILE_H
+
+
+#include "AreaBatch.h"
+#include "FigureStore.h"
+#include "Point.h"
+#include "TextCodec.h"
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <istream>
+#include <limits>
+#include <optional>
+#include <ostream>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define SCENE_FILE_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+
+// Двоичный формат сцены (little-endian, версия 1):
+//   SceneHeader
+//   kinds   - uint8[figure_count]
+//   offsets - uint64[figure_count], индекс первой вершины фигуры
+//   counts  - uint64[figure_count], число вершин фигуры
+//   xs, ys  - T[vertex_count]
+// Каждая секция выровнена на 8 байт, смещения секций записаны в заголовке.
+// Раскладка совпадает с FigureStore, поэтому файл читается без копирования.
+static_assert(std::endian::native == std::endian::little, "Scene files are read in place and require a little-endian host.");
+static_assert(sizeof(size_t) == sizeof(uint64_t), "Scene files store offsets as 64-bit size_t.");
+
+
+enum class SceneScalarType : uint8_t
+{
+    Int32 = 1,
+    Float32 = 2,
+    Float64 = 3
+};
+
+
+template<class T>
+concept SceneScalar = std::is_same_v<T, int32_t> || std::is_same_v<T, float> || std::is_same_v<T, double>;
+
+
+struct SceneHeader
+{
+    char magic[8];
+    uint32_t version;
+    SceneScalarType scalar_type;
+    uint8_t reserved[3];
+    uint64_t figure_count;
+    uint64_t vertex_count;
+    uint64_t kinds_offset;
+    uint64_t offsets_offset;
+    uint64_t counts_offset;
+    uint64_t xs_offset;
+    uint64_t ys_offset;
+};
+static_assert(sizeof(SceneHeader) == 72);
+
+
+constexpr char scene_magic[8] = {'F', 'I', 'G', 'S', 'C', 'E', 'N', 'E'};
+constexpr uint32_t scene_version = 1;
+constexpr size_t scene_alignment = 8;
+
+
+template<SceneScalar T>
+constexpr SceneScalarType scene_scalar_type()
+{
+    if constexpr (std::is_same_v<T, int32_t>)
+    {
+        return SceneScalarType::Int32;
+    }
+    else if constexpr (std::is_same_v<T, float>)
+    {
+        return SceneScalarType::Float32;
+    }
+    else
+    {
+        return SceneScalarType::Float64;
+    }
+}
+
+
+// Тип координат двоичной сцены или nullopt, если данные не начинаются с заголовка сцены.
+inline std::optional<SceneScalarType> peek_scene_scalar_type(const std::byte* data, size_t size)
+{
+    SceneHeader header;
+
+    if (data == nullptr || size < sizeof(SceneHeader))
+    {
+        return std::nullopt;
+    }
+
+    std::memcpy(&header, data, sizeof(SceneHeader));
+    if (std::memcmp(header.magic, scene_magic, sizeof(scene_magic)) != 0)
+    {
+        return std::nullopt;
+    }
+
+    return header.scalar_type;
+}
+
+
+// Файл, отображенный в память только для чтения. Там, где mmap нет,
+// файл целиком читается в буфер.
+class MappedFile final
+{
+private:
+    const std::byte* data = nullptr;
+    size_t size = 0;
+#ifndef SCENE_FILE_MMAP
+    std::vector<std::byte> buffer;
+#endif
+
+private:
+    void unmap() noexcept;
+
+public:
+    MappedFile() = default;
+    explicit MappedFile(const std::string& path);
+    MappedFile(const MappedFile& other) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    ~MappedFile() noexcept;
+
+public:
+    const std::byte* get_data() const;
+    size_t get_size() const;
+
+public:
+    MappedFile& operator=(const MappedFile& other) = delete;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+};
+
+
+// Невладеющее представление двоичной сцены. Конструктор проверяет заголовок,
+// границы секций и каждую фигуру, после чего все обращения безопасны.
+template<SceneScalar T>
+class SceneView final
+{
+private:
+    std::span<const uint8_t> kinds;
+    std::span<const size_t> offsets;
+    std::span<const size_t> counts;
+    std::span<const T> xs;
+    std::span<const T> ys;
+
+private:
+    template<class U>
+    static std::span<const U> section(const std::byte* data, size_t size, uint64_t offset, uint64_t count);
+
+public:
+    SceneView() = default;
+    SceneView(const std::byte* data, size_t size);
+
+public:
+    size_t get_size() const;
+    size_t total_vertices() const;
+    FigureKind get_kind(size_t index) const;
+    double area(size_t index) const;
+    double total_area() const;
+    void areas(std::span<double> out) const;
+    void centers(std::span<Point<double>> out) const;
+    FigureStore<T> to_store() const;
+
+public:
+    std::span<const T> x_coordinates() const;
+    std::span<const T> y_coordinates() const;
+    std::span<const size_t> vertex_offsets() const;
+    std::span<const size_t> vertex_counts() const;
+
+public:
+    PolygonView<T> operator[](size_t index) const;
+};
+
+
+// Сцена, загруженная из файла: владеет отображением и представлением над ним.
+template<SceneScalar T>
+class SceneFile final
+{
+private:
+    MappedFile file;
+    SceneView<T> scene;
+
+public:
+    explicit SceneFile(const std::string& path);
+    SceneFile(const SceneFile& other) = delete;
+    SceneFile(SceneFile&& other) noexcept = default;
+    ~SceneFile() noexcept = default;
+
+public:
+    const SceneView<T>& view() const;
+
+public:
+    SceneFile& operator=(const SceneFile& other) = delete;
+    SceneFile& operator=(SceneFile&& other) noexcept = default;
+};
+
+
+inline size_t scene_align(size_t value)
+{
+    return (value + scene_alignment - 1) / scene_alignment * scene_alignment;
+}
+
+
+// record - номер фигуры для сообщения об ошибке.
+inline void check_scene_vertex_count(FigureKind kind, uint64_t count, size_t record)
+{
+    if (is_valid_vertex_count(kind, count))
+    {
+        return;
+    }
+
+    const char* requirement = kind == FigureKind::Polygon ? "Polygon should have at least 3 vertices" : "Quadrilateral should have 4 vertices";
+    throw std::runtime_error(std::string("Error: ") + requirement + " in figure record " + std::to_string(record) + ".");
+}
+
+
+#ifdef SCENE_FILE_MMAP
+
+inline MappedFile::MappedFile(const std::string& path)
+{
+    const int descriptor = ::open(path.c_str(), O_RDONLY);
+    if (descriptor < 0)
+    {
+        throw std::runtime_error("Error: Cannot open file " + path + ".");
+    }
+
+    struct stat status;
+    if (::fstat(descriptor, &status) != 0)
+    {
+        ::close(descriptor);
+        throw std::runtime_error("Error: Cannot read size of file " + path + ".");
+    }
+
+    size = static_cast<size_t>(status.st_size);
+    if (size > 0)
+    {
+        void* mapping = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+        if (mapping == MAP_FAILED)
+        {
+            ::close(descriptor);
+            throw std::runtime_error("Error: Cannot map file " + path + ".");
+        }
+        data = static_cast<const std::byte*>(mapping);
+    }
+
+    ::close(descriptor);
+}
+
+
+inline void MappedFile::unmap() noexcept
+{
+    if (data != nullptr)
+    {
+        ::munmap(const_cast<std::byte*>(data), size);
+    }
+
+    data = nullptr;
+    size = 0;
+}
+
+#else
+
+inline MappedFile::MappedFile(const std::string& path)
+{
+    std::ifstream stream(path, std::ios::binary | std::ios::ate);
+    if (!stream)
+    {
+        throw std::runtime_error("Error: Cannot open file " + path + ".");
+    }
+
+    buffer.resize(static_cast<size_t>(stream.tellg()));
+    stream.seekg(0);
+    stream.read(reinterpret_cast<char*>(buffer.data()), buffer.size());
+
+    data = buffer.empty() ? nullptr : buffer.data();
+    size = buffer.size();
+}
+
+
+inline void MappedFile::unmap() noexcept
+{
+    buffer.clear();
+    data = nullptr;
+    size = 0;
+}
+
+#endif
+
+
+inline MappedFile::MappedFile(MappedFile&& other) noexcept
+    : data(other.data), size(other.size)
+#ifndef SCENE_FILE_MMAP
+    , buffer(std::move(other.buffer))
+#endif
+{
+    other.data = nullptr;
+    other.size = 0;
+}
+
+
+inline MappedFile::~MappedFile() noexcept
+{
+    unmap();
+}
+
+
+inline const std::byte* MappedFile::get_data() const
+{
+    return data;
+}
+
+
+inline size_t MappedFile::get_size() const
+{
+    return size;
+}
+
+
+inline MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+{
+    if (this == &other)
+    {
+        return *this;
+    }
+
+    unmap();
+
+    data = other.data;
+    size = other.size;
+#ifndef SCENE_FILE_MMAP
+    buffer = std::move(other.buffer);
+#endif
+
+    other.data = nullptr;
+    other.size = 0;
+
+    return *this;
+}
+
+
+template<SceneScalar T>
+template<class U>
+std::span<const U> SceneView<T>::section(const std::byte* data, size_t size, uint64_t offset, uint64_t count)
+{
+    if (offset % alignof(U) != 0 || offset > size || count > (size - offset) / sizeof(U))
+    {
+        throw std::runtime_error("Error: Scene section is out of bounds.");
+    }
+
+    return std::span<const U>(reinterpret_cast<const U*>(data + offset), count);
+}
+
+
+template<SceneScalar T>
+SceneView<T>::SceneView(const std::byte* data, size_t size)
+{
+    if (!peek_scene_scalar_type(data, size))
+    {
+        throw std::runtime_error("Error: Data is not a scene file.");
+    }
+    if (reinterpret_cast<uintptr_t>(data) % scene_alignment != 0)
+    {
+        throw std::runtime_error("Error: Scene data should be 8-byte aligned.");
+    }
+
+    SceneHeader header;
+    std::memcpy(&header, data, sizeof(SceneHeader));
+
+    if (header.version != scene_version)
+    {
+        throw std::runtime_error("Error: Unsupported scene file version.");
+    }
+    if (header.scalar_type != scene_scalar_type<T>())
+    {
+        throw std::runtime_error("Error: Scene coordinate type does not match.");
+    }
+
+    kinds = section<uint8_t>(data, size, header.kinds_offset, header.figure_count);
+    offsets = section<size_t>(data, size, header.offsets_offset, header.figure_count);
+    counts = section<size_t>(data, size, header.counts_offset, header.figure_count);
+    xs = section<T>(data, size, header.xs_offset, header.vertex_count);
+    ys = section<T>(data, size, header.ys_offset, header.vertex_count);
+
+    // Фигуры идут по возрастанию смещений и не перекрываются
+    for (size_t i = 0; i < kinds.size(); ++i)
+    {
+        if (kinds[i] >= figure_kind_count)
+        {
+            throw std::runtime_error("Error: Unknown figure kind in scene.");
+        }
+        if (counts[i] == 0 || offsets[i] > xs.size() || counts[i] > xs.size() - offsets[i])
+        {
+            throw std::runtime_error("Error: Figure vertices are out of bounds.");
+        }
+        if (i > 0 && offsets[i] < offsets[i - 1] + counts[i - 1])
+        {
+            throw std::runtime_error("Error: Figure vertices overlap.");
+        }
+        check_scene_vertex_count(static_cast<FigureKind>(kinds[i]), counts[i], i);
+    }
+}
+
+
+template<SceneScalar T>
+size_t SceneView<T>::get_size() const
+{
+    return kinds.size();
+}
+
+
+template<SceneScalar T>
+size_t SceneView<T>::total_vertices() const
+{
+    return xs.size();
+}
+
+
+template<SceneScalar T>
+FigureKind SceneView<T>::get_kind(size_t index) const
+{
+    if (index >= kinds.size())
+    {
+        throw std::out_of_range("Error: index out of range.");
+    }
+
+    return static_cast<FigureKind>(kinds[index]);
+}
+
+
+template<SceneScalar T>
+double SceneView<T>::area(size_t index) const
+{
+    return (*this)[index].area();
+}
+
+
+template<SceneScalar T>
+double SceneView<T>::total_area() const
+{
+    constexpr size_t chunk = 256;
+    double buffer[chunk];
+    double total_area = 0.0;
+
+    for (size_t first = 0; first < offsets.size(); first += chunk)
+    {
+        const size_t count = std::min(chunk, offsets.size() - first);
+        ::area_batch(xs.data(), ys.data(), offsets.subspan(first, count), counts.subspan(first, count), std::span<double>(buffer, count));
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            total_area += buffer[i];
+        }
+    }
+
+    return total_area;
+}
+
+
+template<SceneScalar T>
+void SceneView<T>::areas(std::span<double> out) const
+{
+    ::area_batch(xs.data(), ys.data(), offsets, counts, out);
+}
+
+
+template<SceneScalar T>
+void SceneView<T>::centers(std::span<Point<double>> out) const
+{
+    if (out.size() < offsets.size())
+    {
+        throw std::invalid_argument("Error: Output span is smaller than the number of figures.");
+    }
+
+    for (size_t i = 0; i < offsets.size(); ++i)
+    {
+        out[i] = PolygonView<T>(xs.data() + offsets[i], ys.data() + offsets[i], counts[i], static_cast<FigureKind>(kinds[i])).get_center();
+    }
+}
+
+
+template<SceneScalar T>
+FigureStore<T> SceneView<T>::to_store() const
+{
+    FigureStore<T> store;
+    store.reserve(get_size(), total_vertices());
+
+    for (size_t i = 0; i < offsets.size(); ++i)
+    {
+        store.append(static_cast<FigureKind>(kinds[i]), xs.subspan(offsets[i], counts[i]), ys.subspan(offsets[i], counts[i]));
+    }
+
+    return store;
+}
+
+
+template<SceneScalar T>
+std::span<const T> SceneView<T>::x_coordinates() const
+{
+    return xs;
+}
+
+
+template<SceneScalar T>
+std::span<const T> SceneView<T>::y_coordinates() const
+{
+    return ys;
+}
+
+
+template<SceneScalar T>
+std::span<const size_t> SceneView<T>::vertex_offsets() const
+{
+    return offsets;
+}
+
+
+template<SceneScalar T>
+std::span<const size_t> SceneView<T>::vertex_counts() const
+{
+    return counts;
+}
+
+
+template<SceneScalar T>
+PolygonView<T> SceneView<T>::operator[](size_t index) const
+{
+    if (index >= kinds.size())
+    {
+        throw std::out_of_range("Error: index out of range.");
+    }
+
+    return PolygonView<T>(xs.data() + offsets[index], ys.data() + offsets[index], counts[index], static_cast<FigureKind>(kinds[index]));
+}
+
+
+template<SceneScalar T>
+SceneFile<T>::SceneFile(const std::string& path): file(path), scene(file.get_data(), file.get_size()) {}
+
+
+template<SceneScalar T>
+const SceneView<T>& SceneFile<T>::view() const
+{
+    return scene;
+}
+
+
+// Запись FigureStore в двоичном формате. Смещения вершин в файле
+// пересчитываются, поэтому хранилище может быть любым.
+template<SceneScalar T>
+void write_scene(const FigureStore<T>& store, std::ostream& ostream)
+{
+    const size_t figures = store.get_size();
+    const size_t vertices = store.total_vertices();
+
+    SceneHeader header{};
+    std::memcpy(header.magic, scene_magic, sizeof(scene_magic));
+    header.version = scene_version;
+    header.scalar_type = scene_scalar_type<T>();
+    header.figure_count = figures;
+    header.vertex_count = vertices;
+    header.kinds_offset = scene_align(sizeof(SceneHeader));
+    header.offsets_offset = scene_align(header.kinds_offset + figures);
+    header.counts_offset = header.offsets_offset + figures * sizeof(uint64_t);
+    header.xs_offset = header.counts_offset + figures * sizeof(uint64_t);
+    header.ys_offset = scene_align(header.xs_offset + vertices * sizeof(T));
+
+    const char padding[scene_alignment] = {};
+    size_t written = 0;
+
+    auto write_bytes = [&](const void* bytes, size_t count)
+    {
+        ostream.write(static_cast<const char*>(bytes), count);
+        written += count;
+    };
+
+    auto pad_to = [&](size_t offset)
+    {
+        write_bytes(padding, offset - written);
+    };
+
+    write_bytes(&header, sizeof(SceneHeader));
+
+    pad_to(header.kinds_offset);
+    write_bytes(store.figure_kinds().data(), figures);
+
+    pad_to(header.offsets_offset);
+    std::vector<uint64_t> offsets(figures);
+    uint64_t next = 0;
+    for (size_t i = 0; i < figures; ++i)
+    {
+        offsets[i] = next;
+        next += store.vertex_counts()[i];
+    }
+    write_bytes(offsets.data(), figures * sizeof(uint64_t));
+    write_bytes(store.vertex_counts().data(), figures * sizeof(uint64_t));
+
+    auto write_coordinates = [&](std::span<const T> coordinates)
+    {
+        for (size_t i = 0; i < figures; ++i)
+        {
+            write_bytes(coordinates.data() + store.vertex_offsets()[i], store.vertex_counts()[i] * sizeof(T));
+        }
+    };
+
+    write_coordinates(store.x_coordinates());
+    pad_to(header.ys_offset);
+    write_coordinates(store.y_coordinates());
+
+    if (!ostream)
+    {
+        throw std::runtime_error("Error: Failed to write scene.");
+    }
+}
+
+
+template<SceneScalar T>
+void save_scene(const FigureStore<T>& store, const std::string& path)
+{
+    std::ofstream ostream(path, std::ios::binary | std::ios::trunc);
+    if (!ostream)
+    {
+        throw std::runtime_error("Error: Cannot open file " + path + ".");
+    }
+
+    write_scene(store, ostream);
+}
+
+
+// Текстовый формат сцены: по одной фигуре на строку,
+//   <тип> <число вершин> x0 y0 x1 y1 ...
+// где тип - polygon, rectangle, rhombus или trapezoid.
+template<SceneScalar T>
+void write_scene_text(const FigureStore<T>& store, std::ostream& ostream)
+{
+    TextWriter writer(ostream);
+
+    for (size_t i = 0; i < store.get_size(); ++i)
+    {
+        const PolygonView<T> figure = store[i];
+        writer.write(figure_kind_name(figure.get_kind()));
+        writer.put(' ');
+        writer.write_number(figure.vertex_count());
+
+        for (size_t j = 0; j < figure.vertex_count(); ++j)
+        {
+            const Point<T> vertex = figure.get_vertex(j);
+            writer.put(' ');
+            writer.write_number(vertex.x);
+            writer.put(' ');
+            writer.write_number(vertex.y);
+        }
+        writer.put('\n');
+    }
+}
+
+
+template<SceneScalar T>
+FigureStore<T> read_scene_text(std::istream& istream)
+{
+    FigureStore<T> store;
+    TextScanner scanner(istream);
+    std::vector<T> xs;
+    std::vector<T> ys;
+    std::string name;
+
+    while (scanner.read_word(name))
+    {
+        const std::optional<FigureKind> kind = parse_figure_kind(name);
+        size_t count = 0;
+
+        if (!kind || !scanner.read(count) || count == 0)
+        {
+            throw std::runtime_error("Error: Malformed figure record " + std::to_string(store.get_size()) + ".");
+        }
+        check_scene_vertex_count(*kind, count, store.get_size());
+
+        // Число вершин из записи не используется для выделения памяти:
+        // вектора растут по мере чтения координат
+        xs.clear();
+        ys.clear();
+        for (size_t i = 0; i < count; ++i)
+        {
+            T x;
+            T y;
+            if (!scanner.read(x) || !scanner.read(y))
+            {
+                throw std::runtime_error("Error: Malformed figure record " + std::to_string(store.get_size()) + ".");
+            }
+            xs.push_back(x);
+            ys.push_back(y);
+        }
+
+        store.append(*kind, xs, ys);
+    }
+
+    return store;
+}
+
+
+#endif // SCENE_FILE_H
@@ -0,0 +1,455 @@
+#ifndef SIMPLIFICATION_H
+#define SIMPLIFICATION_H
+
+
+#include "Arithmetic.h"
+#include "Array.h"
+#include "Point.h"
+#include "Polygon.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+// Упрощение многоугольников и уровни детализации (LOD).
+//
+// Каждый метод один раз считает важность всех вершин - в единицах
+// длины, - после чего упрощение с допуском tolerance оставляет вершины
+// с важностью больше допуска. Важность вершины не больше важности
+// вершин, без которых она не была бы выбрана, поэтому любой допуск дает
+// тот же результат, что и отдельный запуск алгоритма, а уровни LOD
+// строятся за O(n) каждый.
+//
+// DouglasPeucker - важность - расстояние до отрезка, который вершина
+// разбивает (кольцо режется по вершине 0 и самой далекой от нее).
+// VisvalingamWhyatt - корень из эффективной площади треугольника с
+// соседями, то есть допуск t удаляет треугольники площадью до t^2.
+// AreaPreserving - вершины как у VisvalingamWhyatt, затем контур
+// масштабируется от среднего вершин так, чтобы площадь совпала с
+// исходной.
+//
+// Три самые важные вершины остаются всегда.
+enum class SimplificationMethod : unsigned char
+{
+    DouglasPeucker,
+    VisvalingamWhyatt,
+    AreaPreserving
+};
+
+
+// deviation - наибольшее расстояние от исходной вершины до ребра
+// упрощенного контура, которое ее заменило; area_error - относительная
+// ошибка площади.
+template<Scalar T>
+struct LevelOfDetail
+{
+    Polygon<T> polygon;
+    double tolerance = 0.0;
+    double deviation = 0.0;
+    double area_error = 0.0;
+};
+
+
+// Уровни одной фигуры: нулевой - копия исходного многоугольника, дальше
+// все меньше вершин. Уровни с тем же числом вершин, что у предыдущего,
+// не хранятся. Все копии берут ресурс памяти исходной фигуры.
+template<Scalar T>
+class PolygonLevels final
+{
+private:
+    std::vector<LevelOfDetail<T>> levels;
+
+public:
+    PolygonLevels() = default;
+    PolygonLevels(const Polygon<T>& polygon, SimplificationMethod method, std::span<const double> tolerances);
+
+public:
+    size_t level_count() const;
+    const LevelOfDetail<T>& get_level(size_t index) const;
+    const Polygon<T>& select(double tolerance) const;
+};
+
+
+constexpr size_t simplification_block_size = 16;
+
+
+template<Scalar T>
+double point_segment_distance(const Point<T>& point, const Point<T>& a, const Point<T>& b)
+{
+    const double a_x = static_cast<double>(a.x);
+    const double a_y = static_cast<double>(a.y);
+    const double dx = static_cast<double>(b.x) - a_x;
+    const double dy = static_cast<double>(b.y) - a_y;
+    const double p_x = static_cast<double>(point.x) - a_x;
+    const double p_y = static_cast<double>(point.y) - a_y;
+    const double length = dx * dx + dy * dy;
+    const double t = length > 0.0 ? std::clamp((p_x * dx + p_y * dy) / length, 0.0, 1.0) : 0.0;
+
+    return std::hypot(p_x - t * dx, p_y - t * dy);
+}
+
+
+template<Scalar T>
+void douglas_peucker_importance(const Point<T>* vertices, size_t size, double* importance)
+{
+    struct Chain
+    {
+        size_t first;
+        size_t last;
+        double limit;
+    };
+
+    constexpr double infinity = std::numeric_limits<double>::infinity();
+    std::fill_n(importance, size, 0.0);
+
+    size_t split = 1;
+    double farthest = -1.0;
+    for (size_t i = 1; i < size; ++i)
+    {
+        const double dx = static_cast<double>(vertices[i].x) - static_cast<double>(vertices[0].x);
+        const double dy = static_cast<double>(vertices[i].y) - static_cast<double>(vertices[0].y);
+        if (dx * dx + dy * dy > farthest)
+        {
+            farthest = dx * dx + dy * dy;
+            split = i;
+        }
+    }
+    importance[0] = infinity;
+    importance[split] = infinity;
+
+    // Индекс size - это снова вершина 0, кольцо замыкается.
+    std::vector<Chain> chains{{0, split, infinity}, {split, size, infinity}};
+    while (!chains.empty())
+    {
+        const Chain chain = chains.back();
+        chains.pop_back();
+        if (chain.last - chain.first < 2)
+        {
+            continue;
+        }
+
+        const Point<T>& a = vertices[chain.first];
+        const Point<T>& b = vertices[chain.last % size];
+        size_t best = chain.first + 1;
+        double distance = -1.0;
+        for (size_t i = chain.first + 1; i < chain.last; ++i)
+        {
+            const double current = point_segment_distance(vertices[i], a, b);
+            if (current > distance)
+            {
+                distance = current;
+                best = i;
+            }
+        }
+
+        importance[best] = std::min(distance, chain.limit);
+        chains.push_back({chain.first, best, importance[best]});
+        chains.push_back({best, chain.last, importance[best]});
+    }
+
+    size_t third = 0;
+    for (size_t i = 0; i < size; ++i)
+    {
+        if (importance[i] != infinity && (importance[third] == infinity || importance[i] > importance[third]))
+        {
+            third = i;
+        }
+    }
+    importance[third] = infinity;
+}
+
+
+// Вершины удаляются по возрастанию площади треугольника с текущими
+// соседями; устаревшие записи очереди пропускаются. Эффективная площадь
+// не убывает в порядке удаления (берется максимум с уже удаленными).
+template<Scalar T>
+void visvalingam_whyatt_importance(const Point<T>* vertices, size_t size, double* importance)
+{
+    using Entry = std::pair<double, size_t>;
+
+    std::vector<size_t> previous(size);
+    std::vector<size_t> next(size);
+    std::vector<double> area(size);
+    std::vector<bool> removed(size, false);
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> queue;
+
+    auto triangle_area = [&](size_t i)
+    {
+        const Point<T>& a = vertices[previous[i]];
+        const Point<T>& b = vertices[i];
+        const Point<T>& c = vertices[next[i]];
+        const double cross = (static_cast<double>(b.x) - static_cast<double>(a.x)) * (static_cast<double>(c.y) - static_cast<double>(a.y))
+                           - (static_cast<double>(c.x) - static_cast<double>(a.x)) * (static_cast<double>(b.y) - static_cast<double>(a.y));
+        return std::abs(cross) / 2.0;
+    };
+
+    for (size_t i = 0; i < size; ++i)
+    {
+        previous[i] = i == 0 ? size - 1 : i - 1;
+        next[i] = i + 1 == size ? 0 : i + 1;
+    }
+    for (size_t i = 0; i < size; ++i)
+    {
+        area[i] = triangle_area(i);
+        queue.push({area[i], i});
+    }
+
+    size_t remaining = size;
+    double floor = 0.0;
+    while (remaining > 3)
+    {
+        const auto [value, i] = queue.top();
+        queue.pop();
+        if (removed[i] || value != area[i])
+        {
+            continue;
+        }
+
+        floor = std::max(floor, value);
+        importance[i] = std::sqrt(floor);
+        removed[i] = true;
+        --remaining;
+
+        next[previous[i]] = next[i];
+        previous[next[i]] = previous[i];
+        for (const size_t neighbour : {previous[i], next[i]})
+        {
+            area[neighbour] = triangle_area(neighbour);
+            queue.push({area[neighbour], neighbour});
+        }
+    }
+
+    for (size_t i = 0; i < size; ++i)
+    {
+        if (!removed[i])
+        {
+            importance[i] = std::numeric_limits<double>::infinity();
+        }
+    }
+}
+
+
+template<Scalar T>
+void simplification_importance(const Point<T>* vertices, size_t size, SimplificationMethod method, double* importance)
+{
+    if (method == SimplificationMethod::DouglasPeucker)
+    {
+        douglas_peucker_importance(vertices, size, importance);
+    }
+    else
+    {
+        visvalingam_whyatt_importance(vertices, size, importance);
+    }
+}
+
+
+// Строит уровень по готовой важности вершин и измеряет его ошибку.
+template<Scalar T>
+LevelOfDetail<T> simplify_by_importance(const Polygon<T>& polygon, const std::vector<Point<T>>& vertices, const std::vector<double>& importance,
+                                        SimplificationMethod method, double tolerance)
+{
+    std::vector<size_t> kept;
+    std::vector<Point<T>> points;
+    for (size_t i = 0; i < vertices.size(); ++i)
+    {
+        if (importance[i] > tolerance)
+        {
+            kept.push_back(i);
+            points.push_back(vertices[i]);
+        }
+    }
+
+    const double original_area = polygon.area();
+    if (method == SimplificationMethod::AreaPreserving)
+    {
+        FastArithmetic::AreaSum<T> doubled;
+        PlainSum x_center;
+        PlainSum y_center;
+        for (size_t i = 0; i < points.size(); ++i)
+        {
+            doubled.add(points[i], points[i + 1 == points.size() ? 0 : i + 1]);
+            x_center.add(static_cast<double>(points[i].x));
+            y_center.add(static_cast<double>(points[i].y));
+        }
+
+        const double simplified_area = std::abs(doubled.value()) / 2.0;
+        if (simplified_area > 0.0)
+        {
+            const double scale = std::sqrt(original_area / simplified_area);
+            const double c_x = x_center.value() / points.size();
+            const double c_y = y_center.value() / points.size();
+            auto coordinate = [](double value)
+            {
+                if constexpr (std::is_integral_v<T>)
+                {
+                    return static_cast<T>(std::llround(value));
+                }
+                else
+                {
+                    return static_cast<T>(value);
+                }
+            };
+
+            for (Point<T>& point : points)
+            {
+                point = Point<T>(coordinate(c_x + (static_cast<double>(point.x) - c_x) * scale),
+                                 coordinate(c_y + (static_cast<double>(point.y) - c_y) * scale));
+            }
+        }
+    }
+
+    LevelOfDetail<T> level{Polygon<T>(std::span<const Point<T>>(points), polygon.get_allocator()), tolerance};
+
+    for (size_t k = 0; k < kept.size(); ++k)
+    {
+        const size_t last = k + 1 == kept.size() ? kept[0] + vertices.size() : kept[k + 1];
+        const Point<T>& a = points[k];
+        const Point<T>& b = points[k + 1 == kept.size() ? 0 : k + 1];
+        for (size_t i = kept[k]; i <= last; ++i)
+        {
+            level.deviation = std::max(level.deviation, point_segment_distance(vertices[i % vertices.size()], a, b));
+        }
+    }
+    level.area_error = original_area > 0.0 ? std::abs(level.polygon.area() - original_area) / original_area : 0.0;
+
+    return level;
+}
+
+
+template<Scalar T>
+std::vector<Point<T>> polygon_vertices(const Polygon<T>& polygon)
+{
+    std::vector<Point<T>> vertices(polygon.vertex_count());
+    for (size_t i = 0; i < vertices.size(); ++i)
+    {
+        vertices[i] = polygon.get_vertex(i);
+    }
+
+    return vertices;
+}
+
+
+// Многоугольник из трех вершин (и пустой) возвращается как есть.
+template<Scalar T>
+LevelOfDetail<T> simplify_polygon(const Polygon<T>& polygon, SimplificationMethod method, double tolerance)
+{
+    if (polygon.vertex_count() <= 3)
+    {
+        return LevelOfDetail<T>{Polygon<T>(polygon, polygon.get_allocator()), tolerance};
+    }
+
+    const std::vector<Point<T>> vertices = polygon_vertices(polygon);
+    std::vector<double> importance(vertices.size());
+    simplification_importance(vertices.data(), vertices.size(), method, importance.data());
+
+    return simplify_by_importance(polygon, vertices, importance, method, tolerance);
+}
+
+
+template<Scalar T>
+PolygonLevels<T>::PolygonLevels(const Polygon<T>& polygon, SimplificationMethod method, std::span<const double> tolerances)
+{
+    levels.push_back(LevelOfDetail<T>{Polygon<T>(polygon, polygon.get_allocator())});
+    if (polygon.vertex_count() <= 3)
+    {
+        return;
+    }
+
+    const std::vector<Point<T>> vertices = polygon_vertices(polygon);
+    std::vector<double> importance(vertices.size());
+    simplification_importance(vertices.data(), vertices.size(), method, importance.data());
+
+    std::vector<double> sorted(tolerances.begin(), tolerances.end());
+    std::sort(sorted.begin(), sorted.end());
+    for (const double tolerance : sorted)
+    {
+        const size_t count = std::count_if(importance.begin(), importance.end(), [tolerance](double value) { return value > tolerance; });
+        if (count < levels.back().polygon.vertex_count())
+        {
+            levels.push_back(simplify_by_importance(polygon, vertices, importance, method, tolerance));
+        }
+    }
+}
+
+
+template<Scalar T>
+size_t PolygonLevels<T>::level_count() const
+{
+    return levels.size();
+}
+
+
+template<Scalar T>
+const LevelOfDetail<T>& PolygonLevels<T>::get_level(size_t index) const
+{
+    if (index >= levels.size())
+    {
+        throw std::out_of_range("Error: index out of range.");
+    }
+
+    return levels[index];
+}
+
+
+// Самый грубый уровень, чье отклонение не больше tolerance.
+template<Scalar T>
+const Polygon<T>& PolygonLevels<T>::select(double tolerance) const
+{
+    if (levels.empty())
+    {
+        throw std::runtime_error("Error: No levels of detail were built.");
+    }
+
+    for (size_t i = levels.size(); i > 1; --i)
+    {
+        if (levels[i - 1].deviation <= tolerance)
+        {
+            return levels[i - 1].polygon;
+        }
+    }
+
+    return levels[0].polygon;
+}
+
+
+// Фигуры раздаются пулу блоками по simplification_block_size; результат
+// i-й фигуры лежит в i-м элементе.
+template<Scalar T>
+std::vector<PolygonLevels<T>> build_levels_of_detail(const Array<Polygon<T>>& polygons, ThreadPool& pool, SimplificationMethod method,
+                                                     std::span<const double> tolerances)
+{
+    std::vector<PolygonLevels<T>> levels(polygons.get_size());
+    const size_t blocks = (levels.size() + simplification_block_size - 1) / simplification_block_size;
+
+    pool.parallel_for(blocks, [&](size_t block)
+    {
+        const size_t first = block * simplification_block_size;
+        const size_t last = std::min(levels.size(), first + simplification_block_size);
+
+        for (size_t i = first; i < last; ++i)
+        {
+            levels[i] = PolygonLevels<T>(polygons[i], method, tolerances);
+        }
+    });
+
+    return levels;
+}
+
+
+template<Scalar T>
+std::vector<PolygonLevels<T>> build_levels_of_detail(const Array<Polygon<T>>& polygons, SimplificationMethod method, std::span<const double> tolerances)
+{
+    return build_levels_of_detail(polygons, default_thread_pool(), method, tolerances);
+}
+
+
+#endif // SIMPLIFICATION_H
@@ -0,0 +1,112 @@
+#ifndef SPATIAL_ENTRY_H
+#define SPATIAL_ENTRY_H
+
+
+#include "BoundingBox.h"
+#include "Point.h"
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <utility>
+#include <vector>
+
+
+// Запись пространственного индекса: габарит фигуры, ее центр
+// и номер фигуры в Array.
+template<Scalar T>
+struct SpatialEntry
+{
+    BoundingBox<T> box;
+    Point<double> center;
+    size_t id = 0;
+};
+
+
+// k лучших кандидатов для поиска ближайших соседей. Хранится как
+// max-куча по паре (квадрат расстояния, номер), так что при равных
+// расстояниях побеждает меньший номер и результат детерминирован.
+class NearestCollector final
+{
+private:
+    size_t k;
+    std::vector<std::pair<double, size_t>> heap;
+
+public:
+    explicit NearestCollector(size_t k);
+
+public:
+    void offer(double distance_squared, size_t id);
+    bool is_full() const;
+    double bound() const;
+    std::vector<size_t> result();
+};
+
+
+inline double distance_squared(const Point<double>& first, const Point<double>& second)
+{
+    const double dx = first.x - second.x;
+    const double dy = first.y - second.y;
+
+    return dx * dx + dy * dy;
+}
+
+
+inline NearestCollector::NearestCollector(size_t k): k(k)
+{
+    heap.reserve(k);
+}
+
+
+inline void NearestCollector::offer(double distance_squared, size_t id)
+{
+    const std::pair<double, size_t> candidate(distance_squared, id);
+
+    if (heap.size() < k)
+    {
+        heap.push_back(candidate);
+        std::push_heap(heap.begin(), heap.end());
+    }
+    else if (k > 0 && candidate < heap.front())
+    {
+        std::pop_heap(heap.begin(), heap.end());
+        heap.back() = candidate;
+        std::push_heap(heap.begin(), heap.end());
+    }
+}
+
+
+inline bool NearestCollector::is_full() const
+{
+    return heap.size() >= k;
+}
+
+
+// Кандидаты дальше этой границы результат уже не изменят.
+inline double NearestCollector::bound() const
+{
+    if (k == 0)
+    {
+        return -1.0;
+    }
+
+    return is_full() ? heap.front().first : std::numeric_limits<double>::infinity();
+}
+
+
+inline std::vector<size_t> NearestCollector::result()
+{
+    std::sort_heap(heap.begin(), heap.end());
+
+    std::vector<size_t> ids;
+    ids.reserve(heap.size());
+    for (const auto& candidate : heap)
+    {
+        ids.push_back(candidate.second);
+    }
+
+    heap.clear();
+    return ids;
+}
+
+
+#endif // SPATIAL_ENTRY_H
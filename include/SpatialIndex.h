@@ -0,0 +1,214 @@
+#ifndef SPATIAL_INDEX_H
+#define SPATIAL_INDEX_H
+
+
+#include "Array.h"
+#include "BoundingBox.h"
+#include "Point.h"
+#include "Polygon.h"
+#include "RTree.h"
+#include "Reduction.h"
+#include "SpatialEntry.h"
+#include "UniformGrid.h"
+#include <cstddef>
+#include <stdexcept>
+#include <variant>
+#include <vector>
+
+
+// Порядок совпадает с альтернативами SpatialIndex::index_type.
+enum class SpatialIndexKind : unsigned char
+{
+    RTree,
+    Grid
+};
+
+
+// Пространственный индекс над Array фигур (многоугольников или указателей
+// на них). Номер фигуры в индексе - ее позиция в Array, поэтому после
+// изменения массива индекс нужно уведомить: insert после append,
+// swap_remove после Array::swap_remove, update после set_vertex.
+// Удаления со сдвигом (remove, remove_range, erase_if) меняют номера
+// всех следующих фигур - после них проще вызвать rebuild.
+template<Scalar T, class E = Polygon<T>>
+class SpatialIndex final
+{
+public:
+    using index_type = std::variant<RTree<T>, UniformGrid<T>>;
+
+private:
+    const Array<E>* figures;
+    index_type index;
+
+private:
+    SpatialEntry<T> make_entry(size_t id) const;
+    std::vector<SpatialEntry<T>> make_entries() const;
+
+public:
+    explicit SpatialIndex(const Array<E>& figures, SpatialIndexKind kind = SpatialIndexKind::RTree);
+
+public:
+    SpatialIndexKind get_kind() const;
+    size_t get_size() const;
+    void rebuild();
+    void insert(size_t id);
+    void remove(size_t id);
+    void update(size_t id);
+    void swap_remove(size_t id);
+    std::vector<size_t> query_range(const BoundingBox<T>& box) const;
+    std::vector<size_t> query_point(const Point<T>& point) const;
+    std::vector<size_t> nearest(const Point<double>& point, size_t k) const;
+};
+
+
+template<Scalar T, class E>
+SpatialEntry<T> SpatialIndex<T, E>::make_entry(size_t id) const
+{
+    if (id >= figures->get_size())
+    {
+        throw std::out_of_range("Error: index out of range.");
+    }
+
+    const auto& element = (*figures)[id];
+    const auto& figure = figure_reference(element);
+    return SpatialEntry<T>{figure.bounding_box(), figure.get_center(), id};
+}
+
+
+template<Scalar T, class E>
+std::vector<SpatialEntry<T>> SpatialIndex<T, E>::make_entries() const
+{
+    std::vector<SpatialEntry<T>> entries;
+    entries.reserve(figures->get_size());
+
+    for (size_t id = 0; id < figures->get_size(); ++id)
+    {
+        entries.push_back(make_entry(id));
+    }
+
+    return entries;
+}
+
+
+template<Scalar T, class E>
+SpatialIndex<T, E>::SpatialIndex(const Array<E>& figures, SpatialIndexKind kind): figures(&figures)
+{
+    if (kind == SpatialIndexKind::Grid)
+    {
+        index.template emplace<UniformGrid<T>>(make_entries());
+    }
+    else
+    {
+        index.template emplace<RTree<T>>(make_entries());
+    }
+}
+
+
+template<Scalar T, class E>
+SpatialIndexKind SpatialIndex<T, E>::get_kind() const
+{
+    return static_cast<SpatialIndexKind>(index.index());
+}
+
+
+template<Scalar T, class E>
+size_t SpatialIndex<T, E>::get_size() const
+{
+    return std::visit([](const auto& backend) { return backend.get_size(); }, index);
+}
+
+
+// Пакетное построение заново по текущему содержимому Array.
+template<Scalar T, class E>
+void SpatialIndex<T, E>::rebuild()
+{
+    *this = SpatialIndex(*figures, get_kind());
+}
+
+
+template<Scalar T, class E>
+void SpatialIndex<T, E>::insert(size_t id)
+{
+    const SpatialEntry<T> entry = make_entry(id);
+    std::visit([&entry](auto& backend) { backend.insert(entry); }, index);
+}
+
+
+template<Scalar T, class E>
+void SpatialIndex<T, E>::remove(size_t id)
+{
+    if (!std::visit([id](auto& backend) { return backend.remove(id); }, index))
+    {
+        throw std::out_of_range("Error: Figure is not in the spatial index.");
+    }
+}
+
+
+template<Scalar T, class E>
+void SpatialIndex<T, E>::update(size_t id)
+{
+    remove(id);
+    insert(id);
+}
+
+
+// Вызывается после figures.swap_remove(id): последняя фигура переехала на место id.
+template<Scalar T, class E>
+void SpatialIndex<T, E>::swap_remove(size_t id)
+{
+    const size_t last = figures->get_size();
+
+    remove(id);
+    if (id != last)
+    {
+        remove(last);
+        insert(id);
+    }
+}
+
+
+// Фигуры, габарит которых пересекает box.
+template<Scalar T, class E>
+std::vector<size_t> SpatialIndex<T, E>::query_range(const BoundingBox<T>& box) const
+{
+    std::vector<size_t> ids;
+    std::visit([&](const auto& backend)
+    {
+        backend.visit_range(box, [&ids](const SpatialEntry<T>& entry) { ids.push_back(entry.id); });
+    }, index);
+
+    return ids;
+}
+
+
+// Фигуры, содержащие точку: индекс отбирает кандидатов по габариту,
+// затем каждый проверяется точно через contains.
+template<Scalar T, class E>
+std::vector<size_t> SpatialIndex<T, E>::query_point(const Point<T>& point) const
+{
+    std::vector<size_t> ids;
+    std::visit([&](const auto& backend)
+    {
+        backend.visit_range(BoundingBox<T>(point, point), [&](const SpatialEntry<T>& entry)
+        {
+            const auto& element = (*figures)[entry.id];
+            if (figure_reference(element).contains(point))
+            {
+                ids.push_back(entry.id);
+            }
+        });
+    }, index);
+
+    return ids;
+}
+
+
+// k фигур с ближайшими к точке центрами, по возрастанию расстояния.
+template<Scalar T, class E>
+std::vector<size_t> SpatialIndex<T, E>::nearest(const Point<double>& point, size_t k) const
+{
+    return std::visit([&](const auto& backend) { return backend.nearest(point, k); }, index);
+}
+
+
+#endif // SPATIAL_INDEX_H
@@ -0,0 +1,128 @@
+#ifndef STATIC_POLYGON_H
+#define STATIC_POLYGON_H
+
+
+#include "Arithmetic.h"
+#include "Point.h"
+#include "Polygon.h"
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <span>
+#include <stdexcept>
+
+
+// Многоугольник с числом вершин N, известным при компиляции. Вершины
+// хранятся в самом объекте, без кучи, поэтому шаблоны фигур (трафареты,
+// отпечатки) можно задавать как constexpr и получать площадь и центр
+// на этапе компиляции. Формулы те же, что у Polygon с FastArithmetic.
+template<Scalar T, size_t N>
+class StaticPolygon final
+{
+    static_assert(N >= 3, "The number of vertices of a polygon is not less than 3.");
+
+private:
+    std::array<Point<T>, N> vertices;
+
+public:
+    constexpr StaticPolygon() = default;
+    constexpr explicit StaticPolygon(const std::array<Point<T>, N>& vertices);
+    template<std::same_as<Point<T>>... Points>
+        requires (sizeof...(Points) == N)
+    constexpr explicit StaticPolygon(const Points&... points);
+
+public:
+    constexpr size_t vertex_count() const;
+    constexpr const Point<T>& get_vertex(size_t index) const;
+    constexpr void set_vertex(size_t index, const Point<T>& vertex);
+    constexpr double area() const;
+    constexpr Point<double> center() const;
+    Polygon<T> to_polygon() const;
+};
+
+
+template<Scalar T, class... Points>
+StaticPolygon(Point<T>, Points...) -> StaticPolygon<T, 1 + sizeof...(Points)>;
+
+
+template<Scalar T, size_t N>
+constexpr StaticPolygon<T, N>::StaticPolygon(const std::array<Point<T>, N>& vertices): vertices(vertices) {}
+
+
+template<Scalar T, size_t N>
+template<std::same_as<Point<T>>... Points>
+    requires (sizeof...(Points) == N)
+constexpr StaticPolygon<T, N>::StaticPolygon(const Points&... points): vertices{points...} {}
+
+
+template<Scalar T, size_t N>
+constexpr size_t StaticPolygon<T, N>::vertex_count() const
+{
+    return N;
+}
+
+
+template<Scalar T, size_t N>
+constexpr const Point<T>& StaticPolygon<T, N>::get_vertex(size_t index) const
+{
+    if (index >= N)
+    {
+        throw std::out_of_range("Error: Index out of range.");
+    }
+
+    return vertices[index];
+}
+
+
+template<Scalar T, size_t N>
+constexpr void StaticPolygon<T, N>::set_vertex(size_t index, const Point<T>& vertex)
+{
+    if (index >= N)
+    {
+        throw std::out_of_range("Error: Index out of range.");
+    }
+
+    vertices[index] = vertex;
+}
+
+
+template<Scalar T, size_t N>
+constexpr double StaticPolygon<T, N>::area() const
+{
+    FastArithmetic::AreaSum<T> area;
+
+    for (size_t i = 0; i + 1 < N; ++i)
+    {
+        area.add(vertices[i], vertices[i + 1]);
+    }
+    area.add(vertices[N - 1], vertices[0]);
+
+    const double doubled = area.value();
+    return (doubled < 0.0 ? -doubled : doubled) / 2.0;
+}
+
+
+template<Scalar T, size_t N>
+constexpr Point<double> StaticPolygon<T, N>::center() const
+{
+    PlainSum x_center;
+    PlainSum y_center;
+
+    for (const Point<T>& vertex : vertices)
+    {
+        x_center.add(static_cast<double>(vertex.x));
+        y_center.add(static_cast<double>(vertex.y));
+    }
+
+    return Point<double>(x_center.value() / N, y_center.value() / N);
+}
+
+
+template<Scalar T, size_t N>
+Polygon<T> StaticPolygon<T, N>::to_polygon() const
+{
+    return Polygon<T>(std::span<const Point<T>>(vertices));
+}
+
+
+#endif // STATIC_POLYGON_H
@@ -0,0 +1,366 @@
+#ifndef TEXT_CODEC_H
+#define TEXT_CODEC_H
+
+
+#include "Point.h"
+#include "Polygon.h"
+#include <charconv>
+#include <cstddef>
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+
+// Текстовый ввод-вывод чисел без iostream: std::to_chars пишет
+// кратчайшее представление, из которого std::from_chars восстанавливает
+// float и double бит в бит, и оба не зависят от локали.
+
+
+inline bool is_text_space(char symbol)
+{
+    return symbol == ' ' || symbol == '\n' || symbol == '\t' || symbol == '\r' || symbol == '\v' || symbol == '\f';
+}
+
+
+inline const char* skip_text_space(const char* first, const char* last)
+{
+    while (first != last && is_text_space(*first))
+    {
+        ++first;
+    }
+
+    return first;
+}
+
+
+// Читает одно число после пробелов. Возвращает позицию за ним
+// или nullptr, если там не число.
+template<class N>
+const char* scan_number(const char* first, const char* last, N& value)
+{
+    first = skip_text_space(first, last);
+    if (first != last && *first == '+')
+    {
+        ++first;
+    }
+
+    const auto [end, error] = std::from_chars(first, last, value);
+    if (error != std::errc() || (end != last && !is_text_space(*end)))
+    {
+        return nullptr;
+    }
+
+    return end;
+}
+
+
+// Вывод блоками: данные копятся в буфере и уходят в ostream одним
+// write, когда буфер заполнен, при flush() или в деструкторе.
+// Сам ostream не сбрасывается.
+class TextWriter final
+{
+public:
+    constexpr static size_t buffer_size = size_t(1) << 16;
+
+private:
+    constexpr static size_t max_number_size = 32;
+
+    std::ostream& ostream;
+    std::vector<char> buffer;
+    size_t used = 0;
+
+public:
+    explicit TextWriter(std::ostream& ostream);
+    TextWriter(const TextWriter& other) = delete;
+    ~TextWriter() noexcept;
+
+public:
+    void put(char symbol);
+    void write(std::string_view text);
+    template<class N>
+    void write_number(N value);
+    void flush();
+
+public:
+    TextWriter& operator=(const TextWriter& other) = delete;
+};
+
+
+// Чтение чисел и слов из istream блоками. Разделители - пробельные
+// символы, скобки и запятые, поэтому читается и вывод operator<<
+// вида "(x, y)". Сканер забирает из потока данные наперед, так что
+// после него позиция в istream не определена.
+class TextScanner final
+{
+public:
+    constexpr static size_t buffer_size = size_t(1) << 16;
+
+private:
+    std::istream& istream;
+    std::vector<char> buffer;
+    size_t position = 0;
+    size_t filled = 0;
+    bool at_end = false;
+
+private:
+    static bool is_separator(char symbol);
+    bool refill();
+    bool next_token(std::string_view& token);
+
+public:
+    explicit TextScanner(std::istream& istream);
+    TextScanner(const TextScanner& other) = delete;
+
+public:
+    template<class N>
+    bool read(N& value);
+    bool read_word(std::string& word);
+
+public:
+    TextScanner& operator=(const TextScanner& other) = delete;
+};
+
+
+inline TextWriter::TextWriter(std::ostream& ostream): ostream(ostream), buffer(buffer_size) {}
+
+
+inline TextWriter::~TextWriter() noexcept
+{
+    try
+    {
+        flush();
+    }
+    catch (...)
+    {
+    }
+}
+
+
+inline void TextWriter::put(char symbol)
+{
+    if (used == buffer.size())
+    {
+        flush();
+    }
+
+    buffer[used++] = symbol;
+}
+
+
+inline void TextWriter::write(std::string_view text)
+{
+    if (text.size() > buffer.size() - used)
+    {
+        flush();
+    }
+
+    if (text.size() > buffer.size())
+    {
+        ostream.write(text.data(), static_cast<std::streamsize>(text.size()));
+        return;
+    }
+
+    std::memcpy(buffer.data() + used, text.data(), text.size());
+    used += text.size();
+}
+
+
+template<class N>
+void TextWriter::write_number(N value)
+{
+    if (buffer.size() - used < max_number_size)
+    {
+        flush();
+    }
+
+    const auto [end, error] = std::to_chars(buffer.data() + used, buffer.data() + buffer.size(), value);
+    if (error != std::errc())
+    {
+        throw std::runtime_error("Error: Cannot format number.");
+    }
+
+    used = end - buffer.data();
+}
+
+
+inline void TextWriter::flush()
+{
+    if (used > 0)
+    {
+        ostream.write(buffer.data(), static_cast<std::streamsize>(used));
+        used = 0;
+    }
+}
+
+
+inline TextScanner::TextScanner(std::istream& istream): istream(istream), buffer(buffer_size) {}
+
+
+inline bool TextScanner::is_separator(char symbol)
+{
+    return is_text_space(symbol) || symbol == '(' || symbol == ')' || symbol == ',';
+}
+
+
+// Переносит непрочитанный остаток в начало буфера и дочитывает поток.
+// Если остаток занимает весь буфер (очень длинный токен), буфер растет.
+inline bool TextScanner::refill()
+{
+    if (at_end)
+    {
+        return false;
+    }
+
+    const size_t remaining = filled - position;
+    std::memmove(buffer.data(), buffer.data() + position, remaining);
+    if (remaining == buffer.size())
+    {
+        buffer.resize(buffer.size() * 2);
+    }
+
+    const size_t requested = buffer.size() - remaining;
+    istream.read(buffer.data() + remaining, static_cast<std::streamsize>(requested));
+    const size_t received = static_cast<size_t>(istream.gcount());
+
+    position = 0;
+    filled = remaining + received;
+    at_end = received < requested;
+    return received > 0;
+}
+
+
+inline bool TextScanner::next_token(std::string_view& token)
+{
+    for (;;)
+    {
+        while (position < filled && is_separator(buffer[position]))
+        {
+            ++position;
+        }
+        if (position < filled)
+        {
+            break;
+        }
+        if (!refill())
+        {
+            return false;
+        }
+    }
+
+    size_t end = position;
+    for (;;)
+    {
+        while (end < filled && !is_separator(buffer[end]))
+        {
+            ++end;
+        }
+        if (end < filled || at_end)
+        {
+            break;
+        }
+
+        const size_t scanned = end - position;
+        refill();
+        end = position + scanned;
+    }
+
+    token = std::string_view(buffer.data() + position, end - position);
+    return true;
+}
+
+
+// false - конец входа или не число; в последнем случае токен не съедается.
+template<class N>
+bool TextScanner::read(N& value)
+{
+    std::string_view token;
+    if (!next_token(token))
+    {
+        return false;
+    }
+
+    const char* first = token.data();
+    const char* last = token.data() + token.size();
+    if (*first == '+' && token.size() > 1)
+    {
+        ++first;
+    }
+
+    const auto [end, error] = std::from_chars(first, last, value);
+    if (error != std::errc() || end != last)
+    {
+        return false;
+    }
+
+    position += token.size();
+    return true;
+}
+
+
+inline bool TextScanner::read_word(std::string& word)
+{
+    std::string_view token;
+    if (!next_token(token))
+    {
+        return false;
+    }
+
+    word.assign(token);
+    position += token.size();
+    return true;
+}
+
+
+template<Scalar T>
+void write_text(TextWriter& writer, const Point<T>& point)
+{
+    writer.put('(');
+    writer.write_number(point.x);
+    writer.write(", ");
+    writer.write_number(point.y);
+    writer.put(')');
+}
+
+
+// Тот же вид, что у operator<< для Polygon, но числа в кратчайшей точной записи.
+template<Scalar T>
+void write_text(TextWriter& writer, const Polygon<T>& polygon)
+{
+    if (polygon.vertex_count() == 0)
+    {
+        writer.write("Empty");
+        return;
+    }
+
+    for (size_t i = 0; i < polygon.vertex_count(); ++i)
+    {
+        write_text(writer, polygon.get_vertex(i));
+        writer.put('\n');
+    }
+}
+
+
+// Читает vertex_count() вершин, как operator>>; принимает и "x y", и "(x, y)".
+template<Scalar T>
+void read_text(TextScanner& scanner, Polygon<T>& polygon)
+{
+    for (size_t i = 0; i < polygon.vertex_count(); ++i)
+    {
+        T x;
+        T y;
+        if (!scanner.read(x) || !scanner.read(y))
+        {
+            throw std::runtime_error("Error: Malformed polygon vertex " + std::to_string(i) + ".");
+        }
+
+        polygon.set_vertex(i, Point<T>(x, y));
+    }
+}
+
+
+#endif // TEXT_CODEC_H
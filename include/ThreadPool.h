@@ -0,0 +1,350 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+// Пул потоков с собственной очередью у каждого рабочего потока.
+// Поток берет задачи с конца своей очереди, а когда она пуста - крадет
+// с начала чужих. Поток, ожидающий parallel_for, тоже выполняет задачи,
+// поэтому вложенные parallel_for не блокируют пул. При нуле рабочих потоков
+// все задачи выполняет вызывающий поток.
+class ThreadPool final
+{
+private:
+    struct Queue
+    {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+private:
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::vector<std::thread> threads;
+    std::atomic<bool> stopping = false;
+    std::atomic<size_t> pending = 0;
+    std::atomic<size_t> next_queue = 0;
+    std::mutex sleep_mutex;
+    std::condition_variable wake;
+
+    constexpr static size_t tasks_per_worker = 4;
+
+private:
+    static ThreadPool*& current_pool();
+    static size_t& current_index();
+    bool try_pop(size_t index, std::function<void()>& task);
+    bool try_steal(size_t thief, std::function<void()>& task);
+    void worker_loop(size_t index);
+
+public:
+    explicit ThreadPool(size_t workers = std::max<size_t>(1, std::thread::hardware_concurrency()));
+    ThreadPool(const ThreadPool& other) = delete;
+    ~ThreadPool() noexcept;
+
+public:
+    size_t worker_count() const;
+    void submit(std::function<void()> task);
+    bool run_pending_task();
+    template<class F>
+    void parallel_for(size_t count, F&& body);
+
+public:
+    ThreadPool& operator=(const ThreadPool& other) = delete;
+};
+
+
+inline ThreadPool& default_thread_pool()
+{
+    static ThreadPool pool;
+    return pool;
+}
+
+
+// Пул без рабочих потоков: все задачи выполняет вызывающий поток.
+// Для работы меньше одного блока, чтобы не заводить общий пул.
+inline ThreadPool& inline_thread_pool()
+{
+    static ThreadPool pool(0);
+    return pool;
+}
+
+
+inline ThreadPool*& ThreadPool::current_pool()
+{
+    thread_local ThreadPool* pool = nullptr;
+    return pool;
+}
+
+
+inline size_t& ThreadPool::current_index()
+{
+    thread_local size_t index = 0;
+    return index;
+}
+
+
+inline ThreadPool::ThreadPool(size_t workers)
+{
+    queues.reserve(workers);
+    for (size_t i = 0; i < workers; ++i)
+    {
+        queues.push_back(std::make_unique<Queue>());
+    }
+
+    threads.reserve(workers);
+    for (size_t i = 0; i < workers; ++i)
+    {
+        threads.emplace_back(&ThreadPool::worker_loop, this, i);
+    }
+}
+
+
+inline ThreadPool::~ThreadPool() noexcept
+{
+    {
+        std::lock_guard<std::mutex> lock(sleep_mutex);
+        stopping.store(true);
+    }
+    wake.notify_all();
+
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+}
+
+
+inline size_t ThreadPool::worker_count() const
+{
+    return threads.size();
+}
+
+
+inline bool ThreadPool::try_pop(size_t index, std::function<void()>& task)
+{
+    Queue& queue = *queues[index];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+
+    if (queue.tasks.empty())
+    {
+        return false;
+    }
+
+    task = std::move(queue.tasks.back());
+    queue.tasks.pop_back();
+    pending.fetch_sub(1, std::memory_order_relaxed);
+    return true;
+}
+
+
+inline bool ThreadPool::try_steal(size_t thief, std::function<void()>& task)
+{
+    for (size_t offset = 1; offset <= queues.size(); ++offset)
+    {
+        Queue& queue = *queues[(thief + offset) % queues.size()];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+
+        if (!queue.tasks.empty())
+        {
+            task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+            pending.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+inline void ThreadPool::worker_loop(size_t index)
+{
+    current_pool() = this;
+    current_index() = index;
+
+    while (true)
+    {
+        std::function<void()> task;
+
+        if (try_pop(index, task) || try_steal(index, task))
+        {
+            task();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(sleep_mutex);
+        wake.wait(lock, [this] { return stopping.load() || pending.load() > 0; });
+
+        if (stopping.load() && pending.load() == 0)
+        {
+            return;
+        }
+    }
+}
+
+
+inline void ThreadPool::submit(std::function<void()> task)
+{
+    if (queues.empty())
+    {
+        task();
+        return;
+    }
+
+    const size_t index = current_pool() == this
+        ? current_index()
+        : next_queue.fetch_add(1, std::memory_order_relaxed) % queues.size();
+
+    {
+        Queue& queue = *queues[index];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.tasks.push_back(std::move(task));
+        pending.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(sleep_mutex);
+    }
+    wake.notify_one();
+}
+
+
+inline bool ThreadPool::run_pending_task()
+{
+    if (queues.empty() || pending.load(std::memory_order_relaxed) == 0)
+    {
+        return false;
+    }
+
+    std::function<void()> task;
+    const size_t index = current_pool() == this ? current_index() : 0;
+
+    if ((current_pool() == this && try_pop(index, task)) || try_steal(index, task))
+    {
+        task();
+        return true;
+    }
+
+    return false;
+}
+
+
+// Индексы раздаются непрерывными кусками, по tasks_per_worker задач на
+// поток (считая вызывающий), так что на каждый индекс не приходится
+// своя std::function. Кусков больше, чем потоков, чтобы неравные по
+// стоимости индексы выравнивались кражей задач. Если тело бросает
+// исключение, оставшиеся индексы того же куска пропускаются, а первое
+// исключение пробрасывается после завершения всех кусков.
+//
+// Задачи ссылаются на локальные переменные, поэтому выход из функции
+// возможен только после завершения всех поставленных кусков - в том
+// числе когда submit бросает исключение посреди раздачи. Пока есть
+// задачи, вызывающий поток выполняет их сам, а потом спит до
+// завершения последнего куска. Счетчик уменьшается под done_mutex, и
+// перед выходом мьютекс захватывается еще раз, чтобы последний кусок
+// успел его отпустить.
+template<class F>
+void ThreadPool::parallel_for(size_t count, F&& body)
+{
+    if (count == 0)
+    {
+        return;
+    }
+
+    if (queues.empty() || count == 1)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            body(i);
+        }
+        return;
+    }
+
+    const size_t tasks = std::min(count, (queues.size() + 1) * tasks_per_worker);
+    const size_t chunk = (count + tasks - 1) / tasks;
+    const size_t chunks = (count + chunk - 1) / chunk;
+
+    std::atomic<size_t> remaining = chunks;
+    std::mutex done_mutex;
+    std::condition_variable done;
+    std::exception_ptr error;
+    std::mutex error_mutex;
+
+    auto wait_for_chunks = [&]
+    {
+        while (remaining.load(std::memory_order_acquire) > 0)
+        {
+            if (run_pending_task())
+            {
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(done_mutex);
+            done.wait(lock, [&] { return remaining.load(std::memory_order_acquire) == 0; });
+        }
+
+        std::lock_guard<std::mutex> lock(done_mutex);
+    };
+
+    size_t submitted = 0;
+    try
+    {
+        for (size_t first = 0; first < count; first += chunk)
+        {
+            const size_t last = std::min(count, first + chunk);
+
+            submit([&, first, last]
+            {
+                try
+                {
+                    for (size_t i = first; i < last; ++i)
+                    {
+                        body(i);
+                    }
+                }
+                catch (...)
+                {
+                    std::lock_guard<std::mutex> lock(error_mutex);
+                    if (!error)
+                    {
+                        error = std::current_exception();
+                    }
+                }
+
+                std::lock_guard<std::mutex> lock(done_mutex);
+                if (remaining.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                {
+                    done.notify_all();
+                }
+            });
+            ++submitted;
+        }
+    }
+    catch (...)
+    {
+        // Непоставленные куски не выполнятся: дожидаемся только поставленных
+        remaining.fetch_sub(chunks - submitted, std::memory_order_acq_rel);
+        wait_for_chunks();
+        throw;
+    }
+
+    wait_for_chunks();
+
+    if (error)
+    {
+        std::rethrow_exception(error);
+    }
+}
+
+
+#endif // THREAD_POOL_H
@@ -1,33 +1,116 @@
 #ifndef TRAPEZOID_H
 #define TRAPEZOID_H
 
+#include "Point.h"
 #include "Polygon.h"
+#include "Quadrilateral.h"
+#include <array>
 #include <cstddef>
+#include <span>
+
+
+// Трапеция с основаниями вдоль оси x: левый конец нижнего основания,
+// длины оснований, высота и сдвиг верхнего основания относительно нижнего.
+template<Scalar T>
+struct TrapezoidParameters
+{
+    Point<T> origin;
+    T bottom = 0;
+    T top = 0;
+    T height = 0;
+    T top_offset = 0;
+
+    constexpr std::array<Point<T>, 4> vertices() const;
+    constexpr double area() const;
+    constexpr Point<double> center() const;
+};
 
 template<Scalar T>
 class Trapezoid final : public Polygon<T>
 {
+public:
+    using allocator_type = typename Polygon<T>::allocator_type;
+
+private:
     constexpr static size_t _amount_of_vertices = 4;
+
 public:
     Trapezoid();
+    explicit Trapezoid(const allocator_type& allocator);
+    explicit Trapezoid(const TrapezoidParameters<T>& parameters, const allocator_type& allocator = allocator_type());
+    explicit Trapezoid(std::span<const Point<T>> vertices, const allocator_type& allocator = allocator_type());
+    explicit Trapezoid(std::span<const T> coordinates, const allocator_type& allocator = allocator_type());
     Trapezoid(const Trapezoid& other);
+    Trapezoid(const Trapezoid& other, const allocator_type& allocator);
     Trapezoid(Trapezoid&& other) noexcept;
+    Trapezoid(Trapezoid&& other, const allocator_type& allocator);
     ~Trapezoid() noexcept override = default;
 
+protected:
+    Point<double> calculate_center() const override;
+
 public:
-    Trapezoid& operator=(Trapezoid&& other) noexcept; 
+    double area() const override;
+    Point<double> get_center() const override;
+    Trapezoid& operator=(Trapezoid&& other); 
     Trapezoid& operator=(const Trapezoid& other);
 };
 
+template<Scalar T>
+constexpr std::array<Point<T>, 4> TrapezoidParameters<T>::vertices() const
+{
+    return {
+        origin,
+        Point<T>(origin.x + bottom, origin.y),
+        Point<T>(origin.x + top_offset + top, origin.y + height),
+        Point<T>(origin.x + top_offset, origin.y + height)
+    };
+}
+
+template<Scalar T>
+constexpr double TrapezoidParameters<T>::area() const
+{
+    const double result = (static_cast<double>(bottom) + static_cast<double>(top)) / 2.0 * static_cast<double>(height);
+    return result < 0.0 ? -result : result;
+}
+
+// Среднее вершин, как у Polygon, а не центр масс трапеции.
+template<Scalar T>
+constexpr Point<double> TrapezoidParameters<T>::center() const
+{
+    const double x = static_cast<double>(bottom) + static_cast<double>(top) + 2.0 * static_cast<double>(top_offset);
+    return Point<double>(static_cast<double>(origin.x) + x / 4.0,
+                         static_cast<double>(origin.y) + static_cast<double>(height) / 2.0);
+}
+
 template<Scalar T>
 Trapezoid<T>::Trapezoid(): Polygon<T>(_amount_of_vertices) {}
 
+template<Scalar T>
+Trapezoid<T>::Trapezoid(const allocator_type& allocator): Polygon<T>(_amount_of_vertices, allocator) {}
+
+template<Scalar T>
+Trapezoid<T>::Trapezoid(const TrapezoidParameters<T>& parameters, const allocator_type& allocator):
+    Polygon<T>(std::span<const Point<T>>(parameters.vertices()), allocator) {}
+
+template<Scalar T>
+Trapezoid<T>::Trapezoid(std::span<const Point<T>> vertices, const allocator_type& allocator): Polygon<T>(quad_buffer(vertices), allocator) {}
+
+template<Scalar T>
+Trapezoid<T>::Trapezoid(std::span<const T> coordinates, const allocator_type& allocator): Polygon<T>(quad_buffer(coordinates), allocator) {}
+
 template<Scalar T>
 Trapezoid<T>::Trapezoid(const Trapezoid& other): Polygon<T>(other) {}
 
+template<Scalar T>
+Trapezoid<T>::Trapezoid(const Trapezoid& other, const allocator_type& allocator): Polygon<T>(other, allocator) {}
+
 template<Scalar T>
 Trapezoid<T>::Trapezoid(Trapezoid&& other) noexcept: Polygon<T>(std::move(other)) {}
 
+template<Scalar T>
+Trapezoid<T>::Trapezoid(Trapezoid&& other, const allocator_type& allocator): Polygon<T>(std::move(other), allocator) {}
+
 template<Scalar T>
 Trapezoid<T>& Trapezoid<T>::operator=(const Trapezoid& other)
 {
@@ -40,7 +123,7 @@ Trapezoid<T>& Trapezoid<T>::operator=(const Trapezoid& other)
 }  
 
 template<Scalar T>
-Trapezoid<T>& Trapezoid<T>::operator=(Trapezoid&& other) noexcept
+Trapezoid<T>& Trapezoid<T>::operator=(Trapezoid&& other)
 {
     if (this != &other)
     {
@@ -50,4 +133,34 @@ Trapezoid<T>& Trapezoid<T>::operator=(Trapezoid&& other) noexcept
     return *this;
 }
 
+// Для трапеции quad_area дает полусумму оснований на высоту
+// при любой ориентации оснований.
+template<Scalar T>
+double Trapezoid<T>::area() const
+{
+    if (this->vertex_count() != _amount_of_vertices)
+    {
+        return Polygon<T>::area();
+    }
+
+    return quad_area(this->vertex_data());
+}
+
+template<Scalar T>
+Point<double> Trapezoid<T>::get_center() const
+{
+    return calculate_center();
+}
+
+template<Scalar T>
+Point<double> Trapezoid<T>::calculate_center() const
+{
+    if (this->vertex_count() != _amount_of_vertices)
+    {
+        return Polygon<T>::calculate_center();
+    }
+
+    return quad_center(this->vertex_data());
+}
+
 #endif // TRAPEZOID_H
\ No newline at end of file
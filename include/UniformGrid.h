@@ -0,0 +1,361 @@
+#ifndef UNIFORM_GRID_H
+#define UNIFORM_GRID_H
+
+
+#include "BoundingBox.h"
+#include "Point.h"
+#include "SpatialEntry.h"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+
+// Равномерная сетка по габаритам фигур. Запись хранится в каждой
+// ячейке, которую задевает ее габарит; размер ячейки подбирается при
+// построении так, чтобы на ячейку приходилось около entries_per_cell
+// фигур. Фигуры за пределами сетки попадают в крайние ячейки, а когда
+// число записей заметно уходит от расчетного, сетка перестраивается.
+template<Scalar T>
+class UniformGrid final
+{
+public:
+    constexpr static size_t entries_per_cell = 4;
+    constexpr static size_t max_cells_per_axis = size_t(1) << 16;
+
+private:
+    double origin_x = 0.0;
+    double origin_y = 0.0;
+    double cell_size = 1.0;
+    size_t columns = 1;
+    size_t rows = 1;
+    size_t size = 0;
+    size_t planned_size = 0;
+    std::vector<std::vector<SpatialEntry<T>>> cells;
+    std::vector<BoundingBox<T>> boxes;
+    std::vector<unsigned char> present;
+
+private:
+    size_t column(double x) const;
+    size_t row(double y) const;
+    void layout(const std::vector<SpatialEntry<T>>& entries);
+    void place(const SpatialEntry<T>& entry);
+    void rebuild();
+
+public:
+    UniformGrid();
+    explicit UniformGrid(const std::vector<SpatialEntry<T>>& entries);
+
+public:
+    void insert(const SpatialEntry<T>& entry);
+    bool remove(size_t id);
+    bool contains(size_t id) const;
+    size_t get_size() const;
+    template<class Visitor>
+    void visit_range(const BoundingBox<T>& box, Visitor visitor) const;
+    std::vector<size_t> nearest(const Point<double>& point, size_t k) const;
+};
+
+
+template<Scalar T>
+size_t UniformGrid<T>::column(double x) const
+{
+    const double offset = (x - origin_x) / cell_size;
+    if (!(offset > 0.0))
+    {
+        return 0;
+    }
+
+    return offset >= static_cast<double>(columns) ? columns - 1 : static_cast<size_t>(offset);
+}
+
+
+template<Scalar T>
+size_t UniformGrid<T>::row(double y) const
+{
+    const double offset = (y - origin_y) / cell_size;
+    if (!(offset > 0.0))
+    {
+        return 0;
+    }
+
+    return offset >= static_cast<double>(rows) ? rows - 1 : static_cast<size_t>(offset);
+}
+
+
+template<Scalar T>
+void UniformGrid<T>::layout(const std::vector<SpatialEntry<T>>& entries)
+{
+    planned_size = entries.size();
+    origin_x = 0.0;
+    origin_y = 0.0;
+    cell_size = 1.0;
+    columns = 1;
+    rows = 1;
+
+    if (!entries.empty())
+    {
+        BoundingBox<T> bounds = entries.front().box;
+        double extent = 0.0;
+        for (const auto& entry : entries)
+        {
+            bounds.expand(entry.box);
+            extent += std::max(entry.box.width(), entry.box.height());
+        }
+
+        const double count = static_cast<double>(entries.size());
+        const double width = bounds.width();
+        const double height = bounds.height();
+
+        cell_size = std::max(std::sqrt(width * height * entries_per_cell / count), extent / count);
+        if (!(cell_size > 0.0))
+        {
+            cell_size = std::max(width, height) * entries_per_cell / count;
+        }
+        if (!(cell_size > 0.0))
+        {
+            cell_size = 1.0;
+        }
+
+        origin_x = static_cast<double>(bounds.min.x);
+        origin_y = static_cast<double>(bounds.min.y);
+        columns = std::clamp<size_t>(static_cast<size_t>(std::ceil(width / cell_size)), 1, max_cells_per_axis);
+        rows = std::clamp<size_t>(static_cast<size_t>(std::ceil(height / cell_size)), 1, max_cells_per_axis);
+    }
+
+    cells.assign(columns * rows, {});
+}
+
+
+template<Scalar T>
+void UniformGrid<T>::place(const SpatialEntry<T>& entry)
+{
+    const size_t first_column = column(static_cast<double>(entry.box.min.x));
+    const size_t last_column = column(static_cast<double>(entry.box.max.x));
+    const size_t first_row = row(static_cast<double>(entry.box.min.y));
+    const size_t last_row = row(static_cast<double>(entry.box.max.y));
+
+    for (size_t r = first_row; r <= last_row; ++r)
+    {
+        for (size_t c = first_column; c <= last_column; ++c)
+        {
+            cells[r * columns + c].push_back(entry);
+        }
+    }
+
+    if (entry.id >= present.size())
+    {
+        present.resize(std::max(entry.id + 1, present.size() * 2), 0);
+        boxes.resize(present.size());
+    }
+
+    present[entry.id] = 1;
+    boxes[entry.id] = entry.box;
+}
+
+
+// Каждая запись забирается один раз - из ячейки с углом min ее габарита.
+template<Scalar T>
+void UniformGrid<T>::rebuild()
+{
+    std::vector<SpatialEntry<T>> entries;
+    entries.reserve(size);
+
+    for (size_t r = 0; r < rows; ++r)
+    {
+        for (size_t c = 0; c < columns; ++c)
+        {
+            for (const auto& entry : cells[r * columns + c])
+            {
+                if (column(static_cast<double>(entry.box.min.x)) == c && row(static_cast<double>(entry.box.min.y)) == r)
+                {
+                    entries.push_back(entry);
+                }
+            }
+        }
+    }
+
+    layout(entries);
+    for (const auto& entry : entries)
+    {
+        place(entry);
+    }
+}
+
+
+template<Scalar T>
+UniformGrid<T>::UniformGrid(): cells(1) {}
+
+
+template<Scalar T>
+UniformGrid<T>::UniformGrid(const std::vector<SpatialEntry<T>>& entries)
+{
+    layout(entries);
+
+    for (const auto& entry : entries)
+    {
+        if (contains(entry.id))
+        {
+            throw std::invalid_argument("Error: Duplicate id in the uniform grid.");
+        }
+        place(entry);
+    }
+
+    size = entries.size();
+}
+
+
+template<Scalar T>
+void UniformGrid<T>::insert(const SpatialEntry<T>& entry)
+{
+    if (contains(entry.id))
+    {
+        throw std::invalid_argument("Error: Duplicate id in the uniform grid.");
+    }
+
+    place(entry);
+    if (++size > 2 * planned_size + 64)
+    {
+        rebuild();
+    }
+}
+
+
+template<Scalar T>
+bool UniformGrid<T>::remove(size_t id)
+{
+    if (!contains(id))
+    {
+        return false;
+    }
+
+    const BoundingBox<T>& box = boxes[id];
+    const size_t first_column = column(static_cast<double>(box.min.x));
+    const size_t last_column = column(static_cast<double>(box.max.x));
+    const size_t first_row = row(static_cast<double>(box.min.y));
+    const size_t last_row = row(static_cast<double>(box.max.y));
+
+    for (size_t r = first_row; r <= last_row; ++r)
+    {
+        for (size_t c = first_column; c <= last_column; ++c)
+        {
+            std::vector<SpatialEntry<T>>& cell = cells[r * columns + c];
+            auto position = std::find_if(cell.begin(), cell.end(), [id](const SpatialEntry<T>& entry) { return entry.id == id; });
+            *position = cell.back();
+            cell.pop_back();
+        }
+    }
+
+    present[id] = 0;
+    if (--size < planned_size / 4 && planned_size > 64)
+    {
+        rebuild();
+    }
+
+    return true;
+}
+
+
+template<Scalar T>
+bool UniformGrid<T>::contains(size_t id) const
+{
+    return id < present.size() && present[id] != 0;
+}
+
+
+template<Scalar T>
+size_t UniformGrid<T>::get_size() const
+{
+    return size;
+}
+
+
+// Запись, задевающая несколько ячеек, сообщается только из той, где
+// лежит точка (max(box.min.x, entry.min.x), max(box.min.y, entry.min.y)).
+// Для первой строки и столбца запроса это условие выполняется всегда.
+template<Scalar T>
+template<class Visitor>
+void UniformGrid<T>::visit_range(const BoundingBox<T>& box, Visitor visitor) const
+{
+    const size_t first_column = column(static_cast<double>(box.min.x));
+    const size_t last_column = column(static_cast<double>(box.max.x));
+    const size_t first_row = row(static_cast<double>(box.min.y));
+    const size_t last_row = row(static_cast<double>(box.max.y));
+
+    for (size_t r = first_row; r <= last_row; ++r)
+    {
+        for (size_t c = first_column; c <= last_column; ++c)
+        {
+            for (const auto& entry : cells[r * columns + c])
+            {
+                if (entry.box.intersects(box)
+                    && (c == first_column || column(static_cast<double>(entry.box.min.x)) == c)
+                    && (r == first_row || row(static_cast<double>(entry.box.min.y)) == r))
+                {
+                    visitor(entry);
+                }
+            }
+        }
+    }
+}
+
+
+// Обход колец ячеек вокруг точки. Запись рассматривается только в ячейке
+// своего центра; центры в кольце r не ближе (r - 1) * cell_size, поэтому
+// обход останавливается, когда эта оценка превысит k-е расстояние.
+template<Scalar T>
+std::vector<size_t> UniformGrid<T>::nearest(const Point<double>& point, size_t k) const
+{
+    NearestCollector collector(k);
+    if (size == 0 || k == 0)
+    {
+        return collector.result();
+    }
+
+    const long long center_column = static_cast<long long>(column(point.x));
+    const long long center_row = static_cast<long long>(row(point.y));
+    const long long limit = static_cast<long long>(std::max(columns, rows));
+
+    auto scan = [&](long long c, long long r)
+    {
+        if (c < 0 || r < 0 || c >= static_cast<long long>(columns) || r >= static_cast<long long>(rows))
+        {
+            return;
+        }
+
+        for (const auto& entry : cells[r * columns + c])
+        {
+            if (column(entry.center.x) == static_cast<size_t>(c) && row(entry.center.y) == static_cast<size_t>(r))
+            {
+                collector.offer(distance_squared(entry.center, point), entry.id);
+            }
+        }
+    };
+
+    scan(center_column, center_row);
+    for (long long ring = 1; ring <= limit; ++ring)
+    {
+        const double reach = static_cast<double>(ring - 1) * cell_size;
+        if (reach * reach > collector.bound())
+        {
+            break;
+        }
+
+        for (long long c = center_column - ring; c <= center_column + ring; ++c)
+        {
+            scan(c, center_row - ring);
+            scan(c, center_row + ring);
+        }
+        for (long long r = center_row - ring + 1; r <= center_row + ring - 1; ++r)
+        {
+            scan(center_column - ring, r);
+            scan(center_column + ring, r);
+        }
+    }
+
+    return collector.result();
+}
+
+
+#endif // UNIFORM_GRID_H
@@ -88,15 +88,13 @@ void demonstrate_figures_array() {
     std::cout << "Total figures in array: " << figures.get_size() << std::endl;
     std::cout << std::fixed << std::setprecision(3);
     
-    double total_area = 0.0;
     for (size_t i = 0; i < figures.get_size(); ++i)
     {
         std::cout << "Figure " << i << " - ";
         figures.print(i);
-        total_area += figures[i]->area();
     }
     
-    std::cout << "\nTotal area of all figures: " << total_area << std::endl;
+    std::cout << "\nTotal area of all figures: " << figures.total_area() << std::endl;
     std::cout << std::endl;
 }
 
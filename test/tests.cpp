@@ -1,6 +1,25 @@
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <limits>
 #include <memory>
+#include <numeric>
+#include <optional>
+#include <ranges>
+#include <span>
+#include <sstream>
 #include <stdexcept>
+#include <string>
+#include <thread>
+#include <variant>
+#include <vector>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
 
 #include "../include/Point.h"
 #include "../include/Array.h"
@@ -9,6 +28,20 @@
 #include "../include/Rectangle.h"
 #include "../include/Rhombus.h"
 #include "../include/Trapezoid.h"
+#include "../include/FigureStore.h"
+#include "../include/AreaBatch.h"
+#include "../include/MemoryResource.h"
+#include "../include/ThreadPool.h"
+#include "../include/SceneFile.h"
+#include "../include/FigureVariant.h"
+#include "../include/SpatialIndex.h"
+#include "../include/FigureStream.h"
+#include "../include/TextCodec.h"
+#include "../include/PredicateBatch.h"
+#include "../include/ConcurrentArray.h"
+#include "../include/StaticPolygon.h"
+#include "../include/Instrumentation.h"
+#include "../include/Simplification.h"
 
 // ============================================================================
 // TESTS FOR POINT
@@ -91,6 +124,36 @@ TEST(PointTest, OutputOperator)
     EXPECT_EQ(output, "(3, 4)");
 }
 
+TEST(PointTest, TriviallyCopyableAndConstexpr)
+{
+    static_assert(std::is_trivially_copyable_v<Point<int>>);
+    static_assert(std::is_trivially_copyable_v<Point<double>>);
+
+    constexpr Point<double> origin;
+    constexpr Point<double> copy = Point<double>(1.5, -2.0);
+    static_assert(copy.x == 1.5 && copy.y == -2.0);
+    static_assert(origin == Point<double>(0.0, 1e-9));
+    static_assert(Point<int>(1, 2) != Point<int>(1, 3));
+
+    Point<double> source(5.5, 6.6);
+    Point<double> target = std::move(source);
+    EXPECT_DOUBLE_EQ(target.x, 5.5);
+    EXPECT_DOUBLE_EQ(source.x, 5.5);
+}
+
+TEST(PointTest, LayoutAndAlignment)
+{
+    static_assert(std::is_standard_layout_v<Point<double>>);
+    static_assert(std::is_trivially_copyable_v<Point<float>>);
+    static_assert(sizeof(Point<int>) == 8 && alignof(Point<int>) == 8);
+    static_assert(sizeof(Point<float>) == 8 && alignof(Point<float>) == 8);
+    static_assert(sizeof(Point<double>) == 16 && alignof(Point<double>) == 16);
+
+    Array<Point<double>> points;
+    points.append(Point<double>(1.0, 2.0));
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(points.data()) % 16, 0);
+}
+
 // ============================================================================
 // TESTS FOR ARRAY
 // ============================================================================
@@ -314,6 +377,519 @@ TEST(ArrayTest, PrintSingleElement)
     EXPECT_TRUE(output.find("42") != std::string::npos);
 }
 
+TEST(ArrayTest, SwapRemove)
+{
+    Array<int> arr;
+    arr.append(0).append(1).append(2).append(3).append(4);
+
+    arr.swap_remove(1);
+    EXPECT_EQ(arr.get_size(), 4);
+    EXPECT_EQ(arr[0], 0);
+    EXPECT_EQ(arr[1], 4);
+    EXPECT_EQ(arr[2], 2);
+    EXPECT_EQ(arr[3], 3);
+
+    arr.swap_remove(3);
+    EXPECT_EQ(arr.get_size(), 3);
+    EXPECT_EQ(arr[2], 2);
+
+    EXPECT_THROW(arr.swap_remove(3), std::out_of_range);
+}
+
+TEST(ArrayTest, RemoveRange)
+{
+    Array<int> arr;
+    for (int i = 0; i < 10; ++i)
+    {
+        arr.append(i);
+    }
+
+    arr.remove_range(2, 5);
+    EXPECT_EQ(arr.get_size(), 7);
+    EXPECT_EQ(arr[1], 1);
+    EXPECT_EQ(arr[2], 5);
+    EXPECT_EQ(arr[6], 9);
+
+    arr.remove_range(3, 3);
+    EXPECT_EQ(arr.get_size(), 7);
+
+    EXPECT_THROW(arr.remove_range(4, 3), std::out_of_range);
+    EXPECT_THROW(arr.remove_range(0, 8), std::out_of_range);
+
+    arr.remove_range(0, 7);
+    EXPECT_EQ(arr.get_size(), 0);
+}
+
+TEST(ArrayTest, EmptyRemoveRangeKeepsSharedStorage)
+{
+    Array<int> original;
+    original.append(1).append(2).append(3);
+    Array<int> copy(original);
+
+    copy.remove_range(1, 1);
+    EXPECT_TRUE(copy.is_shared());
+    EXPECT_EQ(copy.get_size(), 3);
+}
+
+TEST(ArrayTest, EraseIfKeepsOrder)
+{
+    Array<int> arr;
+    for (int i = 0; i < 100; ++i)
+    {
+        arr.append(i);
+    }
+
+    EXPECT_EQ(arr.erase_if([](int value) { return value % 2 == 0; }), 50);
+    EXPECT_EQ(arr.get_size(), 50);
+    for (size_t i = 0; i < arr.get_size(); ++i)
+    {
+        EXPECT_EQ(arr[i], static_cast<int>(2 * i + 1));
+    }
+
+    EXPECT_EQ(arr.erase_if([](int) { return false; }), 0);
+    EXPECT_EQ(arr.get_size(), 50);
+}
+
+TEST(ArrayTest, RemovalReleasesSharedPointers)
+{
+    Array<std::shared_ptr<int>> arr;
+    std::vector<std::shared_ptr<int>> values;
+    for (int i = 0; i < 8; ++i)
+    {
+        values.push_back(std::make_shared<int>(i));
+        arr.append(values.back());
+    }
+
+    arr.remove(0);
+    arr.swap_remove(0);
+    arr.remove_range(0, 1);
+    arr.erase_if([](const std::shared_ptr<int>& value) { return *value >= 6; });
+
+    EXPECT_EQ(arr.get_size(), 4);
+    for (int i : {0, 1, 6, 7})
+    {
+        EXPECT_EQ(values[i].use_count(), 1);
+    }
+    for (int i : {2, 3, 4, 5})
+    {
+        EXPECT_EQ(values[i].use_count(), 2);
+    }
+}
+
+struct TrackedElement
+{
+    static inline size_t default_constructions = 0;
+    static inline size_t constructions = 0;
+    static inline size_t moves = 0;
+    int value;
+
+    TrackedElement() : value(0) { ++default_constructions; }
+    TrackedElement(int value) : value(value) { ++constructions; }
+    TrackedElement(const TrackedElement& other) : value(other.value) { ++constructions; }
+    TrackedElement(TrackedElement&& other) noexcept : value(other.value) { ++moves; }
+    TrackedElement& operator=(const TrackedElement& other) = default;
+    TrackedElement& operator=(TrackedElement&& other) noexcept = default;
+
+    static void reset()
+    {
+        default_constructions = constructions = moves = 0;
+    }
+};
+
+struct NoDefaultConstructor
+{
+    std::string name;
+    int id;
+
+    NoDefaultConstructor(std::string name, int id) : name(std::move(name)), id(id) {}
+};
+
+TEST(ArrayTest, NoConstructionOfUnusedCapacity)
+{
+    TrackedElement::reset();
+    {
+        Array<TrackedElement> arr;
+        for (int i = 0; i < 100; ++i)
+        {
+            arr.append(TrackedElement(i));
+        }
+        EXPECT_EQ(arr[99].value, 99);
+    }
+    EXPECT_EQ(TrackedElement::default_constructions, 0);
+    EXPECT_EQ(TrackedElement::constructions, 100);
+
+    TrackedElement::reset();
+    Array<TrackedElement> reserved;
+    reserved.reserve(100);
+    EXPECT_EQ(reserved.get_capacity(), 100);
+    for (int i = 0; i < 100; ++i)
+    {
+        reserved.emplace_back(i);
+    }
+    EXPECT_EQ(TrackedElement::constructions, 100);
+    EXPECT_EQ(TrackedElement::moves, 0);
+}
+
+TEST(ArrayTest, EmplaceBackWithoutDefaultConstructor)
+{
+    Array<NoDefaultConstructor> arr(2);
+    arr.emplace_back("first", 1);
+    NoDefaultConstructor& third = arr.append(NoDefaultConstructor("second", 2)).emplace_back("third", 3);
+
+    EXPECT_EQ(arr.get_size(), 3);
+    EXPECT_EQ(third.name, "third");
+    EXPECT_EQ(arr[0].name, "first");
+
+    arr.remove(0);
+    EXPECT_EQ(arr[0].id, 2);
+}
+
+TEST(ArrayTest, AppendOwnElementWhileGrowing)
+{
+    Array<std::string> arr(1);
+    arr.append("a long string that does not fit into the small buffer");
+
+    for (int i = 0; i < 5; ++i)
+    {
+        arr.append(arr[0]);
+    }
+
+    EXPECT_EQ(arr.get_size(), 6);
+    EXPECT_EQ(arr[5], arr[0]);
+}
+
+TEST(ArrayTest, GrowthFactorReserveAndShrink)
+{
+    Array<int> arr;
+    EXPECT_DOUBLE_EQ(arr.get_growth_factor(), 2.0);
+    EXPECT_THROW(arr.set_growth_factor(1.0), std::invalid_argument);
+
+    arr.set_growth_factor(1.5);
+    for (int i = 0; i < 17; ++i)
+    {
+        arr.append(i);
+    }
+    EXPECT_EQ(arr.get_capacity(), 24);
+
+    arr.reserve(10);
+    EXPECT_EQ(arr.get_capacity(), 24);
+
+    arr.shrink_to_fit();
+    EXPECT_EQ(arr.get_capacity(), 17);
+    EXPECT_EQ(arr[16], 16);
+
+    arr.remove_range(0, 17);
+    arr.shrink_to_fit();
+    EXPECT_EQ(arr.get_capacity(), 0);
+    arr.append(5);
+    EXPECT_EQ(arr[0], 5);
+}
+
+TEST(ArrayTest, AssignmentCarriesGrowthFactor)
+{
+    std::pmr::monotonic_buffer_resource arena;
+    Array<int>::allocator_type other_allocator(&arena);
+
+    Array<int> source;
+    source.set_growth_factor(1.5);
+    source.append(1).append(2);
+
+    Array<int> shared;
+    shared = source;
+    EXPECT_DOUBLE_EQ(shared.get_growth_factor(), 1.5);
+
+    Array<int> copied(other_allocator);
+    copied = source;
+    EXPECT_DOUBLE_EQ(copied.get_growth_factor(), 1.5);
+
+    Array<int> moved_across(other_allocator);
+    moved_across = Array<int>(source);
+    EXPECT_DOUBLE_EQ(moved_across.get_growth_factor(), 1.5);
+
+    Array<int> moved;
+    moved = std::move(source);
+    EXPECT_DOUBLE_EQ(moved.get_growth_factor(), 1.5);
+    EXPECT_EQ(moved[1], 2);
+}
+
+TEST(ArrayTest, CopySharesStorageUntilWrite)
+{
+    Array<int> original;
+    original.append(1).append(2).append(3);
+
+    Array<int> copy(original);
+    Array<int> assigned;
+    assigned = original;
+    EXPECT_TRUE(original.is_shared());
+    EXPECT_TRUE(copy.is_shared());
+
+    const Array<int>& view = copy;
+    EXPECT_EQ(view[2], 3);
+    EXPECT_TRUE(copy.is_shared());
+
+    copy.append(4);
+    EXPECT_FALSE(copy.is_shared());
+    EXPECT_TRUE(original.is_shared());
+    EXPECT_EQ(copy.get_size(), 4);
+    EXPECT_EQ(original.get_size(), 3);
+
+    assigned[0] = 10;
+    EXPECT_FALSE(original.is_shared());
+    EXPECT_EQ(original[0], 1);
+    EXPECT_EQ(assigned[0], 10);
+}
+
+TEST(ArrayTest, EveryMutationDetaches)
+{
+    const std::vector<std::function<void(Array<int>&)>> mutations{
+        [](Array<int>& arr) { arr.append(9); },
+        [](Array<int>& arr) { arr.emplace_back(9); },
+        [](Array<int>& arr) { arr.remove(0); },
+        [](Array<int>& arr) { arr.swap_remove(0); },
+        [](Array<int>& arr) { arr.remove_range(0, 2); },
+        [](Array<int>& arr) { arr.erase_if([](int value) { return value == 1; }); },
+        [](Array<int>& arr) { arr[1] = 9; },
+        [](Array<int>& arr) { arr.reserve(64); },
+        [](Array<int>& arr) { arr.shrink_to_fit(); },
+    };
+
+    for (size_t i = 0; i < mutations.size(); ++i)
+    {
+        Array<int> original;
+        original.append(1).append(2).append(3);
+        Array<int> copy = original;
+
+        mutations[i](copy);
+        EXPECT_FALSE(original.is_shared()) << "mutation " << i;
+        EXPECT_EQ(original.get_size(), 3) << "mutation " << i;
+        EXPECT_EQ(static_cast<const Array<int>&>(original)[0], 1) << "mutation " << i;
+        EXPECT_EQ(static_cast<const Array<int>&>(original)[1], 2) << "mutation " << i;
+    }
+}
+
+TEST(ArrayTest, SharedElementsAreDestroyedOnce)
+{
+    const std::shared_ptr<int> value = std::make_shared<int>(7);
+    {
+        Array<std::shared_ptr<int>> first;
+        first.append(value).append(value);
+        {
+            Array<std::shared_ptr<int>> second = first;
+            Array<std::shared_ptr<int>> third = second.snapshot();
+            EXPECT_EQ(value.use_count(), 3);
+
+            third.remove(0);
+            EXPECT_EQ(value.use_count(), 4);
+        }
+        EXPECT_EQ(value.use_count(), 3);
+
+        Array<std::shared_ptr<int>> moved = first;
+        Array<std::shared_ptr<int>> target;
+        target = std::move(moved);
+        EXPECT_TRUE(first.is_shared());
+        EXPECT_EQ(value.use_count(), 3);
+    }
+    EXPECT_EQ(value.use_count(), 1);
+}
+
+TEST(ArrayTest, SnapshotIsConstantTime)
+{
+    CountingResource counting;
+    Array<Polygon<double>> polygons{Array<Polygon<double>>::allocator_type(&counting)};
+    for (int i = 0; i < 100; ++i)
+    {
+        polygons.emplace_back(3);
+    }
+
+    const size_t allocations = counting.allocation_count();
+    const Array<Polygon<double>> snapshot = polygons.snapshot();
+    EXPECT_EQ(counting.allocation_count(), allocations);
+    EXPECT_EQ(snapshot.get_allocator().resource(), &counting);
+
+    polygons[0].set_vertex(1, Point<double>(4.0, 0.0));
+    polygons[0].set_vertex(2, Point<double>(0.0, 4.0));
+    EXPECT_GT(counting.allocation_count(), allocations);
+    EXPECT_DOUBLE_EQ(polygons[0].area(), 8.0);
+    EXPECT_DOUBLE_EQ(snapshot[0].area(), 0.0);
+
+    // Копия в другой ресурс памяти не может делить хранилище.
+    Array<Polygon<double>> other(snapshot, Array<Polygon<double>>::allocator_type());
+    EXPECT_FALSE(other.is_shared());
+    EXPECT_EQ(other.get_size(), 100);
+}
+
+TEST(ArrayTest, SnapshotIsReadableWhileWriterMutates)
+{
+    Array<int> values;
+    for (int i = 0; i < 1000; ++i)
+    {
+        values.append(i);
+    }
+
+    std::vector<Array<int>> snapshots;
+    for (int round = 0; round < 8; ++round)
+    {
+        snapshots.push_back(values.snapshot());
+    }
+
+    std::vector<long long> sums(snapshots.size());
+    std::vector<std::thread> readers;
+    for (size_t i = 0; i < snapshots.size(); ++i)
+    {
+        readers.emplace_back([&snapshots, &sums, i]
+        {
+            const Array<int>& snapshot = snapshots[i];
+            for (size_t j = 0; j < snapshot.get_size(); ++j)
+            {
+                sums[i] += snapshot[j];
+            }
+        });
+    }
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        values[i] = -1;
+        values.append(i);
+    }
+
+    for (std::thread& reader : readers)
+    {
+        reader.join();
+    }
+
+    for (long long sum : sums)
+    {
+        EXPECT_EQ(sum, 999LL * 1000 / 2);
+    }
+    EXPECT_EQ(values.get_size(), 2000);
+}
+
+
+TEST(ArrayTest, ConstAccessReturnsReference)
+{
+    Array<Polygon<double>> figures;
+    figures.append(Polygon<double>(4));
+    const Array<Polygon<double>>& view = figures;
+
+    static_assert(std::is_same_v<decltype(view[0]), const Polygon<double>&>);
+    EXPECT_EQ(&view[0], view.data());
+    EXPECT_EQ(&view[0], &figures[0]);
+    EXPECT_THROW(view[1], std::out_of_range);
+}
+
+
+TEST(ArrayTest, IsContiguousRange)
+{
+    static_assert(std::ranges::contiguous_range<Array<int>>);
+    static_assert(std::ranges::contiguous_range<const Array<Polygon<double>>>);
+
+    Array<int> values;
+    for (int i = 0; i < 100; ++i)
+    {
+        values.append((i * 37) % 100);
+    }
+
+    std::ranges::sort(values);
+    EXPECT_TRUE(std::ranges::is_sorted(values));
+    EXPECT_EQ(std::ranges::size(values), 100);
+    EXPECT_EQ(std::accumulate(values.cbegin(), values.cend(), 0), 99 * 100 / 2);
+    EXPECT_EQ(std::ranges::find(values, 42) - values.begin(), 42);
+
+    int expected = 0;
+    for (int value : std::as_const(values))
+    {
+        EXPECT_EQ(value, expected++);
+    }
+}
+
+
+TEST(ArrayTest, MutableIterationDetaches)
+{
+    Array<int> values;
+    for (int i = 0; i < 10; ++i)
+    {
+        values.append(i);
+    }
+
+    Array<int> copy = values;
+    for (int& value : copy)
+    {
+        value = -value;
+    }
+
+    EXPECT_FALSE(values.is_shared());
+    EXPECT_EQ(values[3], 3);
+    EXPECT_EQ(copy[3], -3);
+}
+
+
+TEST(ArrayTest, BitwiseElementsAcrossResources)
+{
+    std::pmr::monotonic_buffer_resource arena;
+    Array<Point<double>> points{Array<Point<double>>::allocator_type(&arena)};
+    for (int i = 0; i < 100; ++i)
+    {
+        points.append(Point<double>(i, -i));
+    }
+
+    Array<Point<double>> copy(points, Array<Point<double>>::allocator_type(std::pmr::new_delete_resource()));
+    EXPECT_FALSE(copy.is_shared());
+    copy.remove(0);
+    copy.remove_range(10, 20);
+    copy.reserve(1000);
+
+    ASSERT_EQ(copy.get_size(), 89);
+    EXPECT_EQ(copy[0], Point<double>(1, -1));
+    EXPECT_EQ(copy[9], Point<double>(10, -10));
+    EXPECT_EQ(copy[10], Point<double>(21, -21));
+    EXPECT_EQ(copy[88], Point<double>(99, -99));
+
+    points = std::move(copy);
+    ASSERT_EQ(points.get_size(), 89);
+    EXPECT_EQ(points[10], Point<double>(21, -21));
+    EXPECT_EQ(points.get_allocator().resource(), &arena);
+}
+
+TEST(ArrayTest, AppendRangeBuildsFiguresFromFlatBuffer)
+{
+    std::vector<double> coordinates;
+    for (int i = 0; i < 40; ++i)
+    {
+        const double x = i;
+        coordinates.insert(coordinates.end(), {x, 0.0, x + 1.0, 0.0, x + 1.0, i + 1.0, x, i + 1.0});
+    }
+
+    CountingResource counting;
+    Array<Rectangle<double>> rectangles{Array<Rectangle<double>>::allocator_type(&counting)};
+    rectangles.append(Rectangle<double>());
+    const Array<Rectangle<double>> snapshot = rectangles.snapshot();
+    const size_t allocations = counting.allocation_count();
+
+    rectangles.append_range(coordinates, 8);
+    EXPECT_EQ(counting.allocation_count(), allocations + 1);
+    EXPECT_EQ(snapshot.get_size(), 1);
+    ASSERT_EQ(rectangles.get_size(), 41);
+    EXPECT_DOUBLE_EQ(rectangles[1].area(), 1.0);
+    EXPECT_DOUBLE_EQ(rectangles[40].area(), 40.0);
+    EXPECT_EQ(rectangles[40].get_vertex(2), Point<double>(40.0, 40.0));
+    EXPECT_EQ(rectangles[40].get_allocator().resource(), &counting);
+
+    Array<Polygon<double>> polygons;
+    polygons.append_range(std::span<const double>(coordinates).first(24), 12);
+    ASSERT_EQ(polygons.get_size(), 2);
+    EXPECT_EQ(polygons[1].vertex_count(), 6);
+
+    const std::vector<Point<int>> points(12, Point<int>(1, 1));
+    Array<Polygon<int>> triangles;
+    triangles.append_range(points, 3);
+    EXPECT_EQ(triangles.get_size(), 4);
+
+    EXPECT_THROW(polygons.append_range(coordinates, 0), std::invalid_argument);
+    EXPECT_THROW(polygons.append_range(coordinates, 7), std::invalid_argument);
+    EXPECT_THROW(rectangles.append_range(coordinates, 6), std::invalid_argument);
+    EXPECT_EQ(polygons.get_size(), 2);
+}
+
 // ============================================================================
 // TESTS FOR POLYGON
 // ============================================================================
@@ -468,48 +1044,361 @@ TEST(PolygonTest, DoubleConversionOperator)
     EXPECT_NEAR(area, 6.0, 1e-9);
 }
 
-// ============================================================================
-// TESTS FOR RECTANGLE, RHOMBUS, TRAPEZOID
-// ============================================================================
-
-TEST(RectangleTest, DefaultConstructor)
+TEST(PolygonTest, InlineAndHeapStorage)
 {
-    Rectangle<double> rect;
-    EXPECT_EQ(rect.vertex_count(), 4);
+    Polygon<double> small(Polygon<double>::inline_capacity);
+    Polygon<double> large(Polygon<double>::inline_capacity + 3);
+
+    for (size_t i = 0; i < small.vertex_count(); ++i)
+    {
+        small.set_vertex(i, Point<double>(std::cos(i * 1.5), std::sin(i * 1.5)));
+    }
+    for (size_t i = 0; i < large.vertex_count(); ++i)
+    {
+        large.set_vertex(i, Point<double>(std::cos(i * 0.8), std::sin(i * 0.8)));
+    }
+
+    const double small_area = small.area();
+    const double large_area = large.area();
+
+    Polygon<double> small_moved(std::move(small));
+    Polygon<double> large_moved(std::move(large));
+    EXPECT_DOUBLE_EQ(small_moved.area(), small_area);
+    EXPECT_DOUBLE_EQ(large_moved.area(), large_area);
+    EXPECT_EQ(small.vertex_count(), 0);
+    EXPECT_EQ(large.vertex_count(), 0);
+    EXPECT_THROW(small.get_center(), std::runtime_error);
+
+    Polygon<double> target(3);
+    target = large_moved;
+    EXPECT_EQ(target.vertex_count(), large_moved.vertex_count());
+    EXPECT_DOUBLE_EQ(target.area(), large_area);
+
+    target = small_moved;
+    EXPECT_EQ(target.vertex_count(), small_moved.vertex_count());
+    EXPECT_DOUBLE_EQ(target.area(), small_area);
+
+    target = std::move(large_moved);
+    EXPECT_DOUBLE_EQ(target.area(), large_area);
+    target = std::move(small_moved);
+    EXPECT_DOUBLE_EQ(target.area(), small_area);
+
+    small = target;
+    EXPECT_DOUBLE_EQ(small.area(), small_area);
 }
 
-TEST(RectangleTest, CopyConstructor)
+TEST(PolygonTest, BoundingBox)
 {
-    Rectangle<double> rect1;
-    rect1.set_vertex(0, Point<double>(0, 0));
-    rect1.set_vertex(1, Point<double>(5, 0));
-    rect1.set_vertex(2, Point<double>(5, 3));
-    rect1.set_vertex(3, Point<double>(0, 3));
-    
-    Rectangle<double> rect2(rect1);
-    EXPECT_EQ(rect2.vertex_count(), 4);
-    EXPECT_NEAR(rect2.area(), 15.0, 1e-9);
+    Polygon<int> triangle(3);
+    triangle.set_vertex(0, Point<int>(-1, 2));
+    triangle.set_vertex(1, Point<int>(4, -3));
+    triangle.set_vertex(2, Point<int>(0, 5));
+
+    BoundingBox<int> box = triangle.bounding_box();
+    EXPECT_TRUE(box.min == Point<int>(-1, -3));
+    EXPECT_TRUE(box.max == Point<int>(4, 5));
+    EXPECT_TRUE(box.contains(Point<int>(0, 0)));
+    EXPECT_FALSE(box.contains(Point<int>(5, 0)));
+
+    Polygon<int> empty;
+    EXPECT_THROW(empty.bounding_box(), std::runtime_error);
 }
 
-TEST(RhombusTest, DefaultConstructor)
+TEST(PolygonTest, CacheHitsAndMisses)
 {
-    Rhombus<float> rhombus;
-    EXPECT_EQ(rhombus.vertex_count(), 4);
+    Polygon<double> square(4);
+    square.set_vertex(0, Point<double>(0, 0));
+    square.set_vertex(1, Point<double>(2, 0));
+    square.set_vertex(2, Point<double>(2, 2));
+    square.set_vertex(3, Point<double>(0, 2));
+
+    Polygon<double>::reset_cache_statistics();
+
+    EXPECT_NEAR(square.area(), 4.0, 1e-9);
+    EXPECT_NEAR(static_cast<double>(square), 4.0, 1e-9);
+    EXPECT_TRUE(square.get_center() == Point<double>(1, 1));
+
+    // Без GEOMETRY_INSTRUMENTATION Polygon счетчики не ведет.
+    const size_t expected_misses = instrumentation_enabled ? 1 : 0;
+    const size_t expected_hits = instrumentation_enabled ? 2 : 0;
+    CacheStatistics statistics = Polygon<double>::cache_statistics();
+    EXPECT_EQ(statistics.misses, expected_misses);
+    EXPECT_EQ(statistics.hits, expected_hits);
+
+    Polygon<double> copy(square);
+    EXPECT_NEAR(copy.area(), 4.0, 1e-9);
+    EXPECT_EQ(Polygon<double>::cache_statistics().misses, expected_misses);
 }
 
-TEST(TrapezoidTest, DefaultConstructor)
+// Слоты завершившихся потоков сливаются в общий итог; reset() обнуляет
+// и его, и живые слоты.
+TEST(PolygonTest, CacheCountersSurviveThreadExit)
 {
-    Trapezoid<int> trapezoid;
-    EXPECT_EQ(trapezoid.vertex_count(), 4);
-}
+    PolygonCacheCounters::reset();
+    PolygonCacheCounters::hit();
 
-// ============================================================================
-// INTEGRATION TESTS
-// ============================================================================
+    for (int round = 0; round < 50; ++round)
+    {
+        std::thread worker([]
+        {
+            PolygonCacheCounters::hit();
+            PolygonCacheCounters::miss();
+        });
+        worker.join();
+    }
 
-TEST(IntegrationTest, ArrayOfFigures)
-{
-    Array<std::shared_ptr<Figure<double>>> figures;
+    CacheStatistics statistics = PolygonCacheCounters::snapshot();
+    EXPECT_EQ(statistics.hits, 51);
+    EXPECT_EQ(statistics.misses, 50);
+
+    PolygonCacheCounters::reset();
+    PolygonCacheCounters::miss();
+    statistics = PolygonCacheCounters::snapshot();
+    EXPECT_EQ(statistics.hits, 0);
+    EXPECT_EQ(statistics.misses, 1);
+    PolygonCacheCounters::reset();
+}
+
+TEST(PolygonTest, CacheInvalidation)
+{
+    Polygon<double> square(4);
+    square.set_vertex(0, Point<double>(0, 0));
+    square.set_vertex(1, Point<double>(2, 0));
+    square.set_vertex(2, Point<double>(2, 2));
+    square.set_vertex(3, Point<double>(0, 2));
+    EXPECT_NEAR(square.area(), 4.0, 1e-9);
+
+    square.set_vertex(2, Point<double>(4, 2));
+    EXPECT_NEAR(square.area(), 6.0, 1e-9);
+    EXPECT_TRUE(square.bounding_box().max == Point<double>(4, 2));
+
+    std::istringstream input("0 0 1 0 1 1 0 1");
+    input >> square;
+    EXPECT_NEAR(square.area(), 1.0, 1e-9);
+    EXPECT_TRUE(square.get_center() == Point<double>(0.5, 0.5));
+
+    Polygon<double> triangle(3);
+    triangle.set_vertex(1, Point<double>(3, 0));
+    triangle.set_vertex(2, Point<double>(0, 3));
+    square = triangle;
+    EXPECT_NEAR(square.area(), 4.5, 1e-9);
+
+    Polygon<double> other(4);
+    other.set_vertex(1, Point<double>(1, 0));
+    other.set_vertex(2, Point<double>(1, 5));
+    other.set_vertex(3, Point<double>(0, 5));
+    square = std::move(other);
+    EXPECT_NEAR(square.area(), 5.0, 1e-9);
+}
+
+TEST(PolygonTest, ContainsPoint)
+{
+    Polygon<int> shape(6);
+    shape.set_vertex(0, Point<int>(0, 0));
+    shape.set_vertex(1, Point<int>(4, 0));
+    shape.set_vertex(2, Point<int>(4, 1));
+    shape.set_vertex(3, Point<int>(1, 1));
+    shape.set_vertex(4, Point<int>(1, 4));
+    shape.set_vertex(5, Point<int>(0, 4));
+
+    EXPECT_TRUE(shape.contains(Point<int>(0, 3)));
+    EXPECT_TRUE(shape.contains(Point<int>(3, 0)));
+    EXPECT_TRUE(shape.contains(Point<int>(1, 1)));
+    EXPECT_TRUE(shape.contains(Point<int>(1, 3)));
+    EXPECT_FALSE(shape.contains(Point<int>(2, 2)));
+    EXPECT_FALSE(shape.contains(Point<int>(5, 0)));
+    EXPECT_FALSE(Polygon<int>().contains(Point<int>(0, 0)));
+
+    Polygon<double> triangle(3);
+    triangle.set_vertex(1, Point<double>(4, 0));
+    triangle.set_vertex(2, Point<double>(0, 4));
+    EXPECT_TRUE(triangle.contains(Point<double>(1.0, 1.0)));
+    EXPECT_TRUE(triangle.contains(Point<double>(2.0, 2.0)));
+    EXPECT_FALSE(triangle.contains(Point<double>(2.5, 2.5)));
+}
+
+TEST(PolygonTest, ConstructFromVertexBuffers)
+{
+    const std::vector<Point<int>> points{Point<int>(0, 0), Point<int>(4, 0), Point<int>(4, 3), Point<int>(0, 3)};
+    const Polygon<int> from_points(points);
+    ASSERT_EQ(from_points.vertex_count(), 4);
+    EXPECT_EQ(from_points.get_vertex(2), Point<int>(4, 3));
+    EXPECT_DOUBLE_EQ(from_points.area(), 12.0);
+
+    const std::vector<double> coordinates{0.0, 0.0, 6.0, 0.0, 6.0, 2.0, 3.0, 4.0, 0.0, 2.0, -1.0, 1.0};
+    const Polygon<double> from_coordinates(coordinates);
+    ASSERT_EQ(from_coordinates.vertex_count(), 6);
+    EXPECT_EQ(from_coordinates.get_vertex(3), Point<double>(3.0, 4.0));
+    EXPECT_EQ(from_coordinates.get_vertex(5), Point<double>(-1.0, 1.0));
+
+    const std::span<const double> all(coordinates);
+    EXPECT_THROW(Polygon<double>(all.first(5)), std::invalid_argument);
+    EXPECT_THROW(Polygon<double>(all.first(4)), std::invalid_argument);
+    EXPECT_THROW(Polygon<int>(std::span<const Point<int>>(points).first(2)), std::invalid_argument);
+}
+
+// ============================================================================
+// TESTS FOR RECTANGLE, RHOMBUS, TRAPEZOID
+// ============================================================================
+
+TEST(RectangleTest, DefaultConstructor)
+{
+    Rectangle<double> rect;
+    EXPECT_EQ(rect.vertex_count(), 4);
+}
+
+TEST(RectangleTest, CopyConstructor)
+{
+    Rectangle<double> rect1;
+    rect1.set_vertex(0, Point<double>(0, 0));
+    rect1.set_vertex(1, Point<double>(5, 0));
+    rect1.set_vertex(2, Point<double>(5, 3));
+    rect1.set_vertex(3, Point<double>(0, 3));
+    
+    Rectangle<double> rect2(rect1);
+    EXPECT_EQ(rect2.vertex_count(), 4);
+    EXPECT_NEAR(rect2.area(), 15.0, 1e-9);
+}
+
+TEST(RhombusTest, DefaultConstructor)
+{
+    Rhombus<float> rhombus;
+    EXPECT_EQ(rhombus.vertex_count(), 4);
+}
+
+TEST(TrapezoidTest, DefaultConstructor)
+{
+    Trapezoid<int> trapezoid;
+    EXPECT_EQ(trapezoid.vertex_count(), 4);
+}
+
+constexpr RectangleParameters<int> constexpr_rectangle{Point<int>(1, 2), 4, 3};
+constexpr RhombusParameters<double> constexpr_rhombus{Point<double>(0.0, 0.0), 6.0, 4.0};
+constexpr TrapezoidParameters<float> constexpr_trapezoid{Point<float>(0.0f, 0.0f), 6.0f, 2.0f, 3.0f, 1.0f};
+
+static_assert(constexpr_rectangle.area() == 12.0);
+static_assert(constexpr_rectangle.vertices()[2].x == 5 && constexpr_rectangle.vertices()[2].y == 5);
+static_assert(quad_area(constexpr_rectangle.vertices()) == constexpr_rectangle.area());
+static_assert(constexpr_rhombus.area() == 12.0);
+static_assert(quad_area(constexpr_rhombus.vertices()) == 12.0);
+static_assert(constexpr_trapezoid.area() == 12.0);
+static_assert(quad_area(constexpr_trapezoid.vertices()) == 12.0);
+static_assert(quad_center(constexpr_trapezoid.vertices()).x == constexpr_trapezoid.center().x);
+
+template<template<Scalar> class F, Scalar T>
+void check_quad_kernels_match_polygon()
+{
+    for (int i = 0; i < 50; ++i)
+    {
+        F<T> figure;
+        for (int j = 0; j < 4; ++j)
+        {
+            const double angle = 2.0 * M_PI * (j + 0.1 * (i % 7)) / 4.0;
+            const double radius = 3.0 + (i * 7 + j * 5) % 11;
+            figure.set_vertex(j, Point<T>(static_cast<T>(i % 13 + radius * std::cos(angle)),
+                                          static_cast<T>(i % 5 - radius * std::sin(angle))));
+        }
+
+        const Polygon<T> generic(figure);
+        const double tolerance = (std::is_same_v<T, float> ? 1e-4 : 1e-12) * std::max(1.0, generic.area());
+        EXPECT_NEAR(figure.area(), generic.area(), tolerance) << "figure " << i;
+        EXPECT_EQ(figure.get_center().x, generic.get_center().x) << "figure " << i;
+        EXPECT_EQ(figure.get_center().y, generic.get_center().y) << "figure " << i;
+    }
+}
+
+TEST(QuadKernelTest, RectangleMatchesPolygon)
+{
+    check_quad_kernels_match_polygon<Rectangle, int>();
+    check_quad_kernels_match_polygon<Rectangle, float>();
+    check_quad_kernels_match_polygon<Rectangle, double>();
+}
+
+TEST(QuadKernelTest, RhombusMatchesPolygon)
+{
+    check_quad_kernels_match_polygon<Rhombus, int>();
+    check_quad_kernels_match_polygon<Rhombus, float>();
+    check_quad_kernels_match_polygon<Rhombus, double>();
+}
+
+TEST(QuadKernelTest, TrapezoidMatchesPolygon)
+{
+    check_quad_kernels_match_polygon<Trapezoid, int>();
+    check_quad_kernels_match_polygon<Trapezoid, float>();
+    check_quad_kernels_match_polygon<Trapezoid, double>();
+}
+
+TEST(QuadKernelTest, ConstructFromParameters)
+{
+    const RectangleParameters<double> rectangle_parameters{Point<double>(-1.0, 2.0), 4.0, 2.5};
+    const Rectangle<double> rectangle(rectangle_parameters);
+    EXPECT_DOUBLE_EQ(rectangle.area(), 10.0);
+    EXPECT_DOUBLE_EQ(rectangle.get_center().x, rectangle_parameters.center().x);
+    EXPECT_DOUBLE_EQ(rectangle.get_center().y, rectangle_parameters.center().y);
+    EXPECT_DOUBLE_EQ(Polygon<double>(rectangle).area(), rectangle_parameters.area());
+
+    const RhombusParameters<int> rhombus_parameters{Point<int>(3, -2), 8, 6};
+    const Rhombus<int> rhombus(rhombus_parameters);
+    EXPECT_DOUBLE_EQ(rhombus.area(), 24.0);
+    EXPECT_DOUBLE_EQ(rhombus.get_center().x, 3.0);
+    EXPECT_DOUBLE_EQ(rhombus.get_center().y, -2.0);
+    EXPECT_DOUBLE_EQ(Polygon<int>(rhombus).area(), rhombus_parameters.area());
+
+    const TrapezoidParameters<float> trapezoid_parameters{Point<float>(1.0f, 1.0f), 5.0f, 3.0f, 2.0f, -1.0f};
+    const Trapezoid<float> trapezoid(trapezoid_parameters);
+    EXPECT_DOUBLE_EQ(trapezoid.area(), 8.0);
+    EXPECT_DOUBLE_EQ(trapezoid.get_center().x, trapezoid_parameters.center().x);
+    EXPECT_DOUBLE_EQ(trapezoid.get_center().y, trapezoid_parameters.center().y);
+    EXPECT_DOUBLE_EQ(Polygon<float>(trapezoid).area(), trapezoid_parameters.area());
+}
+
+TEST(QuadKernelTest, SetVertexChangesArea)
+{
+    Rectangle<double> rectangle(RectangleParameters<double>{Point<double>(0.0, 0.0), 2.0, 2.0});
+    EXPECT_DOUBLE_EQ(rectangle.area(), 4.0);
+
+    rectangle.set_vertex(2, Point<double>(3.0, 3.0));
+    rectangle.set_vertex(1, Point<double>(3.0, 0.0));
+    rectangle.set_vertex(3, Point<double>(0.0, 3.0));
+    EXPECT_DOUBLE_EQ(rectangle.area(), 9.0);
+}
+
+TEST(QuadKernelTest, MovedFromFigureHasNoArea)
+{
+    Trapezoid<double> trapezoid(TrapezoidParameters<double>{Point<double>(0.0, 0.0), 4.0, 2.0, 1.0, 1.0});
+    Trapezoid<double> moved(std::move(trapezoid));
+
+    EXPECT_DOUBLE_EQ(moved.area(), 3.0);
+    EXPECT_DOUBLE_EQ(trapezoid.area(), 0.0);
+    EXPECT_THROW(trapezoid.get_center(), std::runtime_error);
+}
+
+TEST(QuadKernelTest, ConstructFromVertexBuffers)
+{
+    const std::array<Point<double>, 4> corners{Point<double>(0.0, 0.0), Point<double>(2.0, 0.0), Point<double>(2.0, 3.0), Point<double>(0.0, 3.0)};
+    const Rectangle<double> rectangle(corners);
+    EXPECT_DOUBLE_EQ(rectangle.area(), 6.0);
+    EXPECT_EQ(rectangle.get_vertex(2), Point<double>(2.0, 3.0));
+
+    const std::array<int, 8> coordinates{-2, 0, 0, -1, 2, 0, 0, 1};
+    const Rhombus<int> rhombus(coordinates);
+    EXPECT_DOUBLE_EQ(rhombus.area(), 4.0);
+    EXPECT_EQ(rhombus.get_vertex(3), Point<int>(0, 1));
+
+    const std::vector<float> trapezoid_coordinates{0.0f, 0.0f, 4.0f, 0.0f, 3.0f, 2.0f, 1.0f, 2.0f};
+    EXPECT_DOUBLE_EQ(Trapezoid<float>(trapezoid_coordinates).area(), 6.0);
+
+    EXPECT_THROW(Rectangle<double>(std::span<const Point<double>>(corners).first(3)), std::invalid_argument);
+    EXPECT_THROW(Rhombus<int>(std::span<const int>(coordinates).first(6)), std::invalid_argument);
+}
+
+// ============================================================================
+// INTEGRATION TESTS
+// ============================================================================
+
+TEST(IntegrationTest, ArrayOfFigures)
+{
+    Array<std::shared_ptr<Figure<double>>> figures;
     
     auto triangle = std::make_shared<Polygon<double>>(3);
     triangle->set_vertex(0, Point<double>(0, 0));
@@ -599,6 +1488,2141 @@ TEST(EdgeCaseTest, ZeroAreaPolygon)
     EXPECT_NEAR(line.area(), 0.0, 1e-9);
 }
 
+// ============================================================================
+// TESTS FOR FIGURE STORE
+// ============================================================================
+
+TEST(FigureStoreTest, AppendAndView)
+{
+    FigureStore<double> store;
+
+    Polygon<double> triangle(3);
+    triangle.set_vertex(0, Point<double>(0, 0));
+    triangle.set_vertex(1, Point<double>(3, 0));
+    triangle.set_vertex(2, Point<double>(0, 4));
+
+    Rectangle<double> rect;
+    rect.set_vertex(0, Point<double>(0, 0));
+    rect.set_vertex(1, Point<double>(5, 0));
+    rect.set_vertex(2, Point<double>(5, 3));
+    rect.set_vertex(3, Point<double>(0, 3));
+
+    store.append(triangle).append(rect);
+
+    EXPECT_EQ(store.get_size(), 2);
+    EXPECT_EQ(store.total_vertices(), 7);
+    EXPECT_EQ(store[0].get_kind(), FigureKind::Polygon);
+    EXPECT_EQ(store[1].get_kind(), FigureKind::Rectangle);
+    EXPECT_EQ(store[1].vertex_count(), 4);
+    EXPECT_TRUE(store[1].get_vertex(2) == Point<double>(5, 3));
+    EXPECT_DOUBLE_EQ(store[0].area(), triangle.area());
+    EXPECT_DOUBLE_EQ(static_cast<double>(store[1]), rect.area());
+    EXPECT_THROW(store[2], std::out_of_range);
+}
+
+TEST(FigureStoreTest, AppendFromCoordinatesChecksVertexCount)
+{
+    FigureStore<double> store;
+    const double xs[] = {0, 1, 1, 0, 0.5};
+    const double ys[] = {0, 0, 1, 1, 2};
+    const std::span<const double> x_values(xs);
+    const std::span<const double> y_values(ys);
+
+    EXPECT_THROW(store.append(FigureKind::Rectangle, x_values.first(3), y_values.first(3)), std::invalid_argument);
+    EXPECT_THROW(store.append(FigureKind::Rhombus, x_values, y_values), std::invalid_argument);
+    EXPECT_THROW(store.append(FigureKind::Polygon, x_values.first(2), y_values.first(2)), std::invalid_argument);
+    EXPECT_EQ(store.get_size(), 0);
+
+    store.append(FigureKind::Trapezoid, x_values.first(4), y_values.first(4));
+    store.append(FigureKind::Polygon, x_values, y_values);
+
+    std::stringstream scene;
+    write_scene(store, scene);
+    const std::string bytes = scene.str();
+    std::vector<uint64_t> aligned((bytes.size() + 7) / 8);
+    std::memcpy(aligned.data(), bytes.data(), bytes.size());
+    EXPECT_EQ(SceneView<double>(reinterpret_cast<const std::byte*>(aligned.data()), bytes.size()).get_size(), 2);
+}
+
+TEST(FigureStoreTest, RemoveShiftsOffsets)
+{
+    FigureStore<int> store;
+
+    Polygon<int> triangle(3);
+    triangle.set_vertex(0, Point<int>(0, 0));
+    triangle.set_vertex(1, Point<int>(2, 0));
+    triangle.set_vertex(2, Point<int>(0, 2));
+
+    Trapezoid<int> trapezoid;
+    trapezoid.set_vertex(0, Point<int>(0, 0));
+    trapezoid.set_vertex(1, Point<int>(4, 0));
+    trapezoid.set_vertex(2, Point<int>(3, 2));
+    trapezoid.set_vertex(3, Point<int>(1, 2));
+
+    store.append(triangle).append(trapezoid).append(triangle);
+    store.remove(0);
+
+    EXPECT_EQ(store.get_size(), 2);
+    EXPECT_EQ(store.total_vertices(), 7);
+    EXPECT_EQ(store.vertex_offsets()[0], 0);
+    EXPECT_EQ(store.vertex_offsets()[1], 4);
+    EXPECT_EQ(store[0].get_kind(), FigureKind::Trapezoid);
+    EXPECT_NEAR(store.area(0), 6.0, 1e-9);
+    EXPECT_NEAR(store.area(1), 2.0, 1e-9);
+    EXPECT_THROW(store.remove(2), std::out_of_range);
+}
+
+TEST(FigureStoreTest, BulkAreaAndCenterMatchPolygon)
+{
+    FigureStore<double> store;
+    Array<Polygon<double>> polygons;
+
+    for (int i = 3; i < 10; ++i)
+    {
+        Polygon<double> polygon(i);
+        for (int j = 0; j < i; ++j)
+        {
+            polygon.set_vertex(j, Point<double>(i * std::cos(j * 0.7), j * std::sin(j * 0.3)));
+        }
+        store.append(polygon);
+        polygons.append(polygon);
+    }
+
+    std::vector<double> areas(store.get_size());
+    std::vector<Point<double>> centers(store.get_size());
+    store.areas(areas);
+    store.centers(centers);
+
+    double total = 0.0;
+    for (size_t i = 0; i < polygons.get_size(); ++i)
+    {
+        EXPECT_DOUBLE_EQ(areas[i], polygons[i].area());
+        EXPECT_TRUE(centers[i] == polygons[i].get_center());
+        total += polygons[i].area();
+    }
+    EXPECT_NEAR(store.total_area(), total, 1e-9);
+
+    Polygon<double> restored = store[4].to_polygon();
+    EXPECT_EQ(restored.vertex_count(), polygons[4].vertex_count());
+    EXPECT_DOUBLE_EQ(restored.area(), polygons[4].area());
+
+    std::vector<double> small(1);
+    EXPECT_THROW(store.areas(small), std::invalid_argument);
+}
+
+// ============================================================================
+// TESTS FOR AREA BATCH
+// ============================================================================
+
+template<Scalar T>
+FigureStore<T> make_mixed_store(Array<Polygon<T>>& polygons)
+{
+    FigureStore<T> store;
+
+    for (int i = 0; i < 37; ++i)
+    {
+        const int size = (i % 9 < 6) ? 4 : 3 + i % 5;
+        Polygon<T> polygon(size);
+        for (int j = 0; j < size; ++j)
+        {
+            polygon.set_vertex(j, Point<T>(static_cast<T>((i * 7 + j * 13) % 23) / static_cast<T>(3),
+                                           static_cast<T>((i * 5 + j * j * 11) % 19) / static_cast<T>(2)));
+        }
+        store.append(polygon);
+        polygons.append(polygon);
+    }
+
+    return store;
+}
+
+template<Scalar T>
+void check_area_batch_all_levels()
+{
+    Array<Polygon<T>> polygons;
+    FigureStore<T> store = make_mixed_store(polygons);
+    const SimdLevel detected = detect_simd_level();
+
+    for (SimdLevel level : {SimdLevel::Scalar, SimdLevel::SSE4, SimdLevel::AVX2})
+    {
+        if (static_cast<int>(level) > static_cast<int>(detected))
+        {
+            EXPECT_THROW(set_simd_level(level), std::invalid_argument);
+            continue;
+        }
+
+        set_simd_level(level);
+        std::vector<double> areas(store.get_size());
+        area_batch(store, std::span<double>(areas));
+
+        for (size_t i = 0; i < polygons.get_size(); ++i)
+        {
+            EXPECT_DOUBLE_EQ(areas[i], polygons[i].area()) << "level " << static_cast<int>(level) << ", figure " << i;
+        }
+    }
+
+    set_simd_level(detected);
+}
+
+TEST(AreaBatchTest, DoubleMatchesPolygonArea)
+{
+    check_area_batch_all_levels<double>();
+}
+
+TEST(AreaBatchTest, FloatMatchesPolygonArea)
+{
+    check_area_batch_all_levels<float>();
+}
+
+TEST(AreaBatchTest, IntMatchesPolygonArea)
+{
+    check_area_batch_all_levels<int>();
+}
+
+// Четверка фигур по четыре вершины не подряд в хранилище не должна
+// попадать в ветку с транспонированием.
+TEST(AreaBatchTest, NonContiguousQuadsMatchScalar)
+{
+    const std::vector<double> xs{0, 1, 1, 0, 0, 2, 2, 0, 0, 3, 3, 0, 0, 4, 4, 0, 0, 10, 10, 0};
+    const std::vector<double> ys{0, 0, 1, 1, 0, 0, 2, 2, 0, 0, 3, 3, 0, 0, 4, 4, 0, 0, 10, 10};
+    const std::vector<size_t> offsets{0, 16, 8, 12};
+    const std::vector<size_t> counts{4, 4, 4, 4};
+    const SimdLevel detected = detect_simd_level();
+
+    std::vector<double> expected(offsets.size());
+    area_batch_scalar(xs.data(), ys.data(), offsets.data(), counts.data(), offsets.size(), expected.data());
+    EXPECT_DOUBLE_EQ(expected[1], 100.0);
+
+    for (SimdLevel level : {SimdLevel::Scalar, SimdLevel::SSE4, SimdLevel::AVX2})
+    {
+        if (static_cast<int>(level) > static_cast<int>(detected))
+        {
+            continue;
+        }
+
+        set_simd_level(level);
+        std::vector<double> areas(offsets.size());
+        area_batch(xs.data(), ys.data(), std::span<const size_t>(offsets), std::span<const size_t>(counts), std::span<double>(areas));
+        for (size_t i = 0; i < areas.size(); ++i)
+        {
+            EXPECT_DOUBLE_EQ(areas[i], expected[i]) << "level " << static_cast<int>(level) << ", figure " << i;
+        }
+    }
+
+    set_simd_level(detected);
+}
+
+TEST(AreaBatchTest, PolygonSpan)
+{
+    std::vector<Polygon<double>> polygons;
+    for (int i = 3; i < 7; ++i)
+    {
+        Polygon<double> polygon(i);
+        for (int j = 0; j < i; ++j)
+        {
+            polygon.set_vertex(j, Point<double>(std::cos(j * 2.0), std::sin(j * 1.5) * i));
+        }
+        polygons.push_back(polygon);
+    }
+
+    std::vector<double> areas(polygons.size());
+    area_batch(std::span<const Polygon<double>>(polygons), std::span<double>(areas));
+
+    for (size_t i = 0; i < polygons.size(); ++i)
+    {
+        EXPECT_DOUBLE_EQ(areas[i], polygons[i].area());
+    }
+
+    std::vector<double> small(1);
+    EXPECT_THROW(area_batch(std::span<const Polygon<double>>(polygons), std::span<double>(small)), std::invalid_argument);
+}
+
+// ============================================================================
+// TESTS FOR MEMORY RESOURCES
+// ============================================================================
+
+TEST(MemoryResourceTest, PolygonUsesResourceOnlyForLargePolygons)
+{
+    CountingResource counting;
+
+    Polygon<double> small(4, &counting);
+    EXPECT_EQ(counting.allocation_count(), 0);
+
+    {
+        Polygon<double> large(9, &counting);
+        EXPECT_EQ(counting.allocation_count(), 1);
+
+        Polygon<double> copy(large, &counting);
+        EXPECT_EQ(counting.allocation_count(), 2);
+
+        Polygon<double> moved(std::move(copy));
+        EXPECT_EQ(counting.allocation_count(), 2);
+        EXPECT_EQ(moved.get_allocator().resource(), &counting);
+    }
+
+    EXPECT_EQ(counting.deallocation_count(), 2);
+}
+
+TEST(MemoryResourceTest, ArrayPropagatesResourceToPolygons)
+{
+    CountingResource counting;
+    Array<Polygon<double>> polygons{Array<Polygon<double>>::allocator_type(&counting)};
+    EXPECT_EQ(counting.allocation_count(), 1);
+
+    Polygon<double> octagon(8);
+    for (size_t i = 0; i < 8; ++i)
+    {
+        octagon.set_vertex(i, Point<double>(std::cos(i * 0.785), std::sin(i * 0.785)));
+    }
+
+    polygons.append(octagon);
+    EXPECT_EQ(polygons[0].get_allocator().resource(), &counting);
+    EXPECT_EQ(counting.allocation_count(), 2);
+    EXPECT_DOUBLE_EQ(polygons[0].area(), octagon.area());
+}
+
+TEST(MemoryResourceTest, FrameArenaResetReusesMemory)
+{
+    CountingResource upstream;
+    FrameArena arena(4096, &upstream);
+
+    for (int frame = 0; frame < 3; ++frame)
+    {
+        Array<std::shared_ptr<Figure<double>>> figures{Array<std::shared_ptr<Figure<double>>>::allocator_type(&arena)};
+        for (int i = 0; i < 100; ++i)
+        {
+            figures.append(std::allocate_shared<Rectangle<double>>(std::pmr::polymorphic_allocator<Rectangle<double>>(&arena)));
+        }
+        EXPECT_GT(arena.bytes_used(), 0);
+        arena.reset();
+        EXPECT_EQ(arena.bytes_used(), 0);
+    }
+
+    const size_t after_first_frames = upstream.allocation_count();
+    EXPECT_GT(after_first_frames, 0);
+    EXPECT_EQ(upstream.deallocation_count(), 0);
+
+    void* block = arena.allocate(64, 16);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(block) % 16, 0);
+    EXPECT_EQ(upstream.allocation_count(), after_first_frames);
+
+    arena.release();
+    EXPECT_EQ(upstream.deallocation_count(), upstream.allocation_count());
+}
+
+TEST(MemoryResourceTest, FixedBlockPoolRecyclesBlocks)
+{
+    CountingResource upstream;
+    FixedBlockPool pool = make_point_pool<double>(8, 16, &upstream);
+    EXPECT_EQ(pool.get_block_size(), 8 * sizeof(Point<double>));
+
+    {
+        Polygon<double> first(8, &pool);
+        Polygon<double> second(6, &pool);
+        EXPECT_EQ(upstream.allocation_count(), 1);
+    }
+    {
+        Polygon<double> third(7, &pool);
+        EXPECT_EQ(upstream.allocation_count(), 1);
+
+        Polygon<double> oversized(20, &pool);
+        EXPECT_EQ(upstream.allocation_count(), 2);
+    }
+
+    EXPECT_EQ(upstream.deallocation_count(), 1);
+    EXPECT_THROW(FixedBlockPool(16, 3), std::invalid_argument);
+}
+
+// Ресурс, который отказывает после заданного числа выделений.
+class LimitedResource final : public std::pmr::memory_resource
+{
+private:
+    size_t remaining;
+    size_t outstanding = 0;
+
+public:
+    explicit LimitedResource(size_t allocations): remaining(allocations) {}
+
+public:
+    size_t outstanding_count() const { return outstanding; }
+    void refill(size_t allocations) { remaining = allocations; }
+
+private:
+    void* do_allocate(size_t bytes, size_t alignment) override
+    {
+        if (remaining == 0)
+        {
+            throw std::bad_alloc();
+        }
+        --remaining;
+        ++outstanding;
+        return ::operator new(bytes, std::align_val_t(alignment));
+    }
+
+    void do_deallocate(void* pointer, size_t, size_t alignment) override
+    {
+        --outstanding;
+        ::operator delete(pointer, std::align_val_t(alignment));
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+    {
+        return this == &other;
+    }
+};
+
+static Polygon<double> make_regular_polygon(size_t size, double radius, std::pmr::memory_resource* resource)
+{
+    Polygon<double> polygon(size, resource);
+    for (size_t i = 0; i < size; ++i)
+    {
+        polygon.set_vertex(i, Point<double>(radius * std::cos(i * 0.5), radius * std::sin(i * 0.5)));
+    }
+    return polygon;
+}
+
+TEST(MemoryResourceTest, MoveAssignAcrossResources)
+{
+    CountingResource first;
+    CountingResource second;
+
+    Array<Polygon<double>> source{Array<Polygon<double>>::allocator_type(&first)};
+    for (size_t i = 0; i < 5; ++i)
+    {
+        source.append(make_regular_polygon(9, 1.0 + i, &first));
+    }
+    Array<Polygon<double>> target{Array<Polygon<double>>::allocator_type(&second)};
+    target.append(make_regular_polygon(3, 1.0, &second));
+    const size_t second_allocations = second.allocation_count();
+
+    target = std::move(source);
+    ASSERT_EQ(target.get_size(), 5);
+    EXPECT_EQ(source.get_size(), 0);
+    EXPECT_EQ(target.get_allocator().resource(), &second);
+    EXPECT_EQ(target[4].get_allocator().resource(), &second);
+    EXPECT_EQ(target[4].vertex_count(), 9);
+    EXPECT_EQ(second.allocation_count(), second_allocations + 1 + 5);
+
+    Polygon<double> polygon = make_regular_polygon(12, 2.0, &second);
+    const Polygon<double> expected = polygon;
+    polygon = make_regular_polygon(10, 3.0, &first);
+    EXPECT_EQ(polygon.get_allocator().resource(), &second);
+    EXPECT_EQ(polygon.vertex_count(), 10);
+    EXPECT_NE(polygon.get_vertex(9), expected.get_vertex(9));
+}
+
+// При отказе ресурса посреди переноса цель остается прежней и ничего
+// не утекает.
+TEST(MemoryResourceTest, FailedMoveAssignKeepsTarget)
+{
+    LimitedResource limited(5);
+    LimitedResource single(1);
+    {
+        Array<Polygon<double>> source;
+        for (size_t i = 0; i < 8; ++i)
+        {
+            source.append(make_regular_polygon(9, 1.0 + i, std::pmr::new_delete_resource()));
+        }
+        Array<Polygon<double>> target{Array<Polygon<double>>::allocator_type(&limited)};
+        target.append(make_regular_polygon(6, 5.0, &limited));
+
+        EXPECT_THROW(target = std::move(source), std::bad_alloc);
+        ASSERT_EQ(target.get_size(), 1);
+        EXPECT_EQ(target[0].vertex_count(), 6);
+        EXPECT_EQ(target[0].get_vertex(1), make_regular_polygon(6, 5.0, std::pmr::new_delete_resource()).get_vertex(1));
+
+        Polygon<double> polygon = make_regular_polygon(7, 1.0, &single);
+        EXPECT_THROW(polygon = make_regular_polygon(20, 2.0, std::pmr::new_delete_resource()), std::bad_alloc);
+        EXPECT_EQ(polygon.vertex_count(), 7);
+        EXPECT_DOUBLE_EQ(polygon.area(), make_regular_polygon(7, 1.0, std::pmr::new_delete_resource()).area());
+    }
+    EXPECT_EQ(limited.outstanding_count(), 0);
+    EXPECT_EQ(single.outstanding_count(), 0);
+}
+
+// ============================================================================
+// TESTS FOR PARALLEL REDUCTIONS
+// ============================================================================
+
+static Rectangle<double> make_scaled_rectangle(size_t i)
+{
+    const double width = 1e-3 * (i % 97 + 1);
+    const double height = (i % 13 == 0) ? 1e6 : 0.5 + i % 7;
+    const double x = static_cast<double>(i);
+
+    Rectangle<double> rectangle;
+    rectangle.set_vertex(0, Point<double>(x, 0));
+    rectangle.set_vertex(1, Point<double>(x + width, 0));
+    rectangle.set_vertex(2, Point<double>(x + width, height));
+    rectangle.set_vertex(3, Point<double>(x, height));
+    return rectangle;
+}
+
+TEST(ParallelReduceTest, TotalAreaOfValuesAndPointers)
+{
+    Array<std::shared_ptr<Figure<double>>> figures;
+    Array<Polygon<double>> polygons;
+
+    auto triangle = std::make_shared<Polygon<double>>(3);
+    triangle->set_vertex(0, Point<double>(0, 0));
+    triangle->set_vertex(1, Point<double>(3, 0));
+    triangle->set_vertex(2, Point<double>(0, 4));
+
+    auto square = std::make_shared<Rectangle<double>>(make_scaled_rectangle(1));
+
+    figures.append(triangle).append(square);
+    polygons.append(*triangle).append(*square);
+
+    EXPECT_NEAR(figures.total_area(), 6.0 + square->area(), 1e-12);
+    EXPECT_DOUBLE_EQ(polygons.total_area(), figures.total_area());
+    EXPECT_DOUBLE_EQ(static_cast<double>(figures), figures.total_area());
+
+    AreaStatistics statistics = figures.area_statistics();
+    EXPECT_EQ(statistics.count, 2);
+    EXPECT_DOUBLE_EQ(statistics.min_area, square->area());
+    EXPECT_DOUBLE_EQ(statistics.max_area, 6.0);
+    EXPECT_NEAR(statistics.centroid.x, (1.0 + square->get_center().x) / 2, 1e-12);
+    EXPECT_NEAR(statistics.centroid.y, (4.0 / 3 + square->get_center().y) / 2, 1e-12);
+}
+
+TEST(ParallelReduceTest, EmptyArray)
+{
+    Array<Polygon<double>> polygons;
+    ThreadPool pool(2);
+
+    EXPECT_EQ(polygons.total_area(pool), 0.0);
+
+    AreaStatistics statistics = polygons.area_statistics(pool);
+    EXPECT_EQ(statistics.count, 0);
+    EXPECT_EQ(statistics.min_area, 0.0);
+    EXPECT_EQ(statistics.max_area, 0.0);
+}
+
+TEST(ParallelReduceTest, DeterministicForAnyWorkerCount)
+{
+    const size_t count = 5 * Array<Rectangle<double>>::reduce_block_size + 123;
+    Array<Rectangle<double>> rectangles;
+    long double expected = 0.0;
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        Rectangle<double> rectangle = make_scaled_rectangle(i);
+        expected += rectangle.area();
+        rectangles.append(std::move(rectangle));
+    }
+
+    ThreadPool serial(0);
+    const AreaStatistics reference = rectangles.area_statistics(serial);
+    EXPECT_EQ(reference.count, count);
+    EXPECT_NEAR(reference.total_area, static_cast<double>(expected), 1e-6);
+
+    for (size_t workers : {1, 3, 8})
+    {
+        ThreadPool pool(workers);
+        EXPECT_EQ(pool.worker_count(), workers);
+
+        const AreaStatistics statistics = rectangles.area_statistics(pool);
+        EXPECT_EQ(statistics.total_area, reference.total_area);
+        EXPECT_EQ(statistics.min_area, reference.min_area);
+        EXPECT_EQ(statistics.max_area, reference.max_area);
+        EXPECT_EQ(statistics.centroid.x, reference.centroid.x);
+        EXPECT_EQ(statistics.centroid.y, reference.centroid.y);
+        EXPECT_EQ(rectangles.total_area(pool), reference.total_area);
+    }
+}
+
+TEST(ParallelReduceTest, ThreadPoolRethrowsAndNests)
+{
+    ThreadPool pool(3);
+    std::atomic<size_t> calls = 0;
+
+    pool.parallel_for(8, [&](size_t)
+    {
+        pool.parallel_for(8, [&](size_t) { calls.fetch_add(1); });
+    });
+    EXPECT_EQ(calls.load(), 64);
+
+    EXPECT_THROW(pool.parallel_for(16, [](size_t i)
+    {
+        if (i == 5)
+        {
+            throw std::runtime_error("Error: task failed.");
+        }
+    }), std::runtime_error);
+}
+
+TEST(ParallelReduceTest, ParallelForChunksCoverEveryIndexOnce)
+{
+    ThreadPool pool(3);
+
+    for (size_t count : {2, 15, 16, 17, 1001})
+    {
+        std::vector<std::atomic<int>> visits(count);
+        pool.parallel_for(count, [&](size_t i) { visits[i].fetch_add(1); });
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            EXPECT_EQ(visits[i].load(), 1) << "count " << count << ", index " << i;
+        }
+    }
+}
+
+TEST(ParallelReduceTest, SingleBlockRunsWithoutPool)
+{
+    Array<Rectangle<double>> rectangles;
+    double expected = 0.0;
+    for (int i = 0; i < 100; ++i)
+    {
+        rectangles.append(Rectangle<double>(RectangleParameters<double>{Point<double>(i, 0.0), 1.0, i / 10.0}));
+        expected += i / 10.0;
+    }
+
+    EXPECT_NEAR(rectangles.total_area(), expected, 1e-9);
+    EXPECT_EQ(rectangles.total_area(), rectangles.total_area(inline_thread_pool()));
+    EXPECT_EQ(inline_thread_pool().worker_count(), 0);
+    EXPECT_EQ(rectangles.area_statistics().count, 100);
+}
+
+// ============================================================================
+// TESTS FOR SCENE FILES
+// ============================================================================
+
+static FigureStore<double> make_scene_store()
+{
+    FigureStore<double> store;
+
+    Polygon<double> pentagon(5);
+    for (size_t i = 0; i < 5; ++i)
+    {
+        pentagon.set_vertex(i, Point<double>(std::cos(i * 1.2566370614359172), std::sin(i * 1.2566370614359172) + 0.1));
+    }
+
+    Rectangle<double> rectangle;
+    rectangle.set_vertex(0, Point<double>(0, 0));
+    rectangle.set_vertex(1, Point<double>(3.5, 0));
+    rectangle.set_vertex(2, Point<double>(3.5, 2));
+    rectangle.set_vertex(3, Point<double>(0, 2));
+
+    Trapezoid<double> trapezoid;
+    trapezoid.set_vertex(0, Point<double>(0, 0));
+    trapezoid.set_vertex(1, Point<double>(4, 0));
+    trapezoid.set_vertex(2, Point<double>(3, 1.0 / 3));
+    trapezoid.set_vertex(3, Point<double>(1, 1.0 / 3));
+
+    store.append(pentagon).append(rectangle).append(trapezoid);
+    return store;
+}
+
+static std::vector<uint64_t> scene_bytes(const FigureStore<double>& store)
+{
+    std::ostringstream stream;
+    write_scene(store, stream);
+    const std::string bytes = stream.str();
+
+    std::vector<uint64_t> buffer((bytes.size() + 7) / 8);
+    std::memcpy(buffer.data(), bytes.data(), bytes.size());
+    buffer.resize(bytes.size() / 8);
+    return buffer;
+}
+
+static void expect_same_figures(const FigureStore<double>& store, const SceneView<double>& scene)
+{
+    ASSERT_EQ(scene.get_size(), store.get_size());
+    EXPECT_EQ(scene.total_vertices(), store.total_vertices());
+
+    for (size_t i = 0; i < store.get_size(); ++i)
+    {
+        EXPECT_EQ(scene.get_kind(i), store[i].get_kind());
+        ASSERT_EQ(scene[i].vertex_count(), store[i].vertex_count());
+        for (size_t j = 0; j < store[i].vertex_count(); ++j)
+        {
+            EXPECT_EQ(scene[i].get_vertex(j), store[i].get_vertex(j));
+        }
+        EXPECT_EQ(scene.area(i), store.area(i));
+    }
+}
+
+TEST(SceneFileTest, BinaryRoundTripThroughFile)
+{
+    FigureStore<double> store = make_scene_store();
+    store.remove(0);
+    store.append(make_scene_store()[0].to_polygon());
+
+    const std::string path = (std::filesystem::temp_directory_path() / "figures_scene_test.bin").string();
+    save_scene(store, path);
+
+    {
+        SceneFile<double> file(path);
+        expect_same_figures(store, file.view());
+        EXPECT_DOUBLE_EQ(file.view().total_area(), store.total_area());
+
+        std::vector<Point<double>> centers(store.get_size());
+        file.view().centers(centers);
+        EXPECT_DOUBLE_EQ(centers[0].x, store[0].get_center().x);
+
+        SceneFile<double> moved(std::move(file));
+        EXPECT_EQ(moved.view().to_store().total_vertices(), store.total_vertices());
+
+        EXPECT_THROW(SceneFile<float> wrong_type(path), std::runtime_error);
+    }
+
+    std::filesystem::remove(path);
+    EXPECT_THROW(SceneFile<double> missing(path), std::runtime_error);
+}
+
+TEST(SceneFileTest, TextRoundTripIsExact)
+{
+    const FigureStore<double> store = make_scene_store();
+
+    std::stringstream text;
+    write_scene_text(store, text);
+    const FigureStore<double> parsed = read_scene_text<double>(text);
+
+    std::vector<uint64_t> bytes = scene_bytes(parsed);
+    expect_same_figures(store, SceneView<double>(reinterpret_cast<const std::byte*>(bytes.data()), bytes.size() * 8));
+
+    std::istringstream bad_kind("hexagon 3 0 0 1 0 0 1\n");
+    EXPECT_THROW(read_scene_text<double>(bad_kind), std::runtime_error);
+    std::istringstream truncated("polygon 3 0 0 1 0 0\n");
+    EXPECT_THROW(read_scene_text<double>(truncated), std::runtime_error);
+    std::istringstream bad_quad("rhombus 3 0 0 1 0 0 1\n");
+    EXPECT_THROW(read_scene_text<double>(bad_quad), std::runtime_error);
+    std::istringstream degenerate("polygon 2 0 0 1 0\n");
+    EXPECT_THROW(read_scene_text<double>(degenerate), std::runtime_error);
+    std::istringstream huge_count("polygon 1000000000000 0 0 1 0 0 1\n");
+    EXPECT_THROW(read_scene_text<double>(huge_count), std::runtime_error);
+
+    FigureStore<double> records;
+    const std::string degenerate_record = "polygon 3 0 0 1 0 0 1\nrectangle 3 0 0 1 0 0 1\n";
+    try
+    {
+        parse_scene_records(degenerate_record.data(), degenerate_record.data() + degenerate_record.size(), records, 5);
+        FAIL() << "Expected runtime_error";
+    }
+    catch (const std::runtime_error& error)
+    {
+        EXPECT_NE(std::string(error.what()).find("record 6"), std::string::npos);
+    }
+}
+
+TEST(SceneFileTest, ValidationRejectsCorruptedData)
+{
+    const std::vector<uint64_t> valid = scene_bytes(make_scene_store());
+    const size_t size = valid.size() * 8;
+
+    auto view = [](const std::vector<uint64_t>& bytes, size_t size)
+    {
+        return SceneView<double>(reinterpret_cast<const std::byte*>(bytes.data()), size);
+    };
+
+    EXPECT_NO_THROW(view(valid, size));
+    EXPECT_THROW(view(valid, size - 8), std::runtime_error);
+    EXPECT_THROW(view(valid, 16), std::runtime_error);
+
+    SceneHeader header;
+    std::memcpy(&header, valid.data(), sizeof(SceneHeader));
+
+    std::vector<uint64_t> bad_magic = valid;
+    reinterpret_cast<char*>(bad_magic.data())[0] = 'X';
+    EXPECT_THROW(view(bad_magic, size), std::runtime_error);
+
+    std::vector<uint64_t> bad_version = valid;
+    reinterpret_cast<SceneHeader*>(bad_version.data())->version = 2;
+    EXPECT_THROW(view(bad_version, size), std::runtime_error);
+
+    std::vector<uint64_t> bad_kind = valid;
+    reinterpret_cast<uint8_t*>(bad_kind.data())[header.kinds_offset] = 9;
+    EXPECT_THROW(view(bad_kind, size), std::runtime_error);
+
+    std::vector<uint64_t> bad_offset = valid;
+    bad_offset[header.offsets_offset / 8 + 2] = header.vertex_count - 1;
+    EXPECT_THROW(view(bad_offset, size), std::runtime_error);
+
+    std::vector<uint64_t> bad_count = valid;
+    bad_count[header.counts_offset / 8] = 0;
+    EXPECT_THROW(view(bad_count, size), std::runtime_error);
+
+    std::vector<uint64_t> degenerate_polygon = valid;
+    degenerate_polygon[header.counts_offset / 8] = 2;
+    EXPECT_THROW(view(degenerate_polygon, size), std::runtime_error);
+
+    std::vector<uint64_t> overlapping = valid;
+    overlapping[header.offsets_offset / 8 + 1] = 3;
+    EXPECT_THROW(view(overlapping, size), std::runtime_error);
+}
+
+// ============================================================================
+// TESTS FOR FIGURE VARIANT
+// ============================================================================
+
+template<class F>
+static F make_unit_quad(double scale)
+{
+    F figure;
+    figure.set_vertex(0, Point<double>(0, 0));
+    figure.set_vertex(1, Point<double>(scale, 0));
+    figure.set_vertex(2, Point<double>(scale, 2 * scale));
+    figure.set_vertex(3, Point<double>(0, 2 * scale));
+    return figure;
+}
+
+TEST(FigureVariantTest, DispatchMatchesVirtualCalls)
+{
+    Polygon<double> triangle(3);
+    triangle.set_vertex(0, Point<double>(0, 0));
+    triangle.set_vertex(1, Point<double>(4, 0));
+    triangle.set_vertex(2, Point<double>(0, 3));
+
+    const FigureVariant<double> figures[] = {
+        triangle,
+        make_unit_quad<Rectangle<double>>(1.0),
+        make_unit_quad<Rhombus<double>>(2.0),
+        make_unit_quad<Trapezoid<double>>(3.0)
+    };
+
+    for (size_t i = 0; i < 4; ++i)
+    {
+        const Figure<double>& figure = figures[i].as_figure();
+        EXPECT_EQ(figures[i].get_kind(), static_cast<FigureKind>(i));
+        EXPECT_DOUBLE_EQ(figures[i].area(), figure.area());
+        EXPECT_DOUBLE_EQ(static_cast<double>(figures[i]), figure.area());
+        EXPECT_EQ(figures[i].get_center(), figure.get_center());
+    }
+
+    EXPECT_TRUE(figures[1].holds<Rectangle<double>>());
+    EXPECT_FALSE(figures[1].holds<Polygon<double>>());
+    EXPECT_EQ(figures[2].get<Rhombus<double>>().vertex_count(), 4);
+    EXPECT_THROW(figures[0].get<Rectangle<double>>(), std::bad_variant_access);
+    EXPECT_EQ(figures[3].visit([](const auto& figure) { return figure.vertex_count(); }), 4);
+}
+
+TEST(FigureVariantTest, AdaptersToFigureHierarchy)
+{
+    Array<std::shared_ptr<Figure<double>>> figures;
+    figures.append(std::make_shared<Rectangle<double>>(make_unit_quad<Rectangle<double>>(1.5)));
+    figures.append(std::make_shared<Trapezoid<double>>(make_unit_quad<Trapezoid<double>>(0.5)));
+    figures.append(std::make_shared<Polygon<double>>(make_unit_quad<Rectangle<double>>(2.0)));
+
+    Array<FigureVariant<double>> variants = make_variant_array(figures);
+    ASSERT_EQ(variants.get_size(), 3);
+    EXPECT_EQ(variants[0].get_kind(), FigureKind::Rectangle);
+    EXPECT_EQ(variants[1].get_kind(), FigureKind::Trapezoid);
+    EXPECT_EQ(variants[2].get_kind(), FigureKind::Polygon);
+    EXPECT_DOUBLE_EQ(variants.total_area(), figures.total_area());
+
+    std::ostringstream from_variant;
+    std::ostringstream from_figure;
+    from_variant << variants[0];
+    from_figure << *figures[0];
+    EXPECT_EQ(from_variant.str(), from_figure.str());
+
+    std::istringstream input("1 1 2 1 2 2 1 2");
+    input >> variants[0];
+    EXPECT_DOUBLE_EQ(variants[0].area(), 1.0);
+
+    EXPECT_EQ(variants[0].get<Rectangle<double>>().get_vertex(2), Point<double>(2, 2));
+}
+
+TEST(FigureVariantTest, UnknownFigureTypeIsRejected)
+{
+    struct Circle final : Figure<double>
+    {
+        double area() const override { return 3.14; }
+
+    protected:
+        Point<double> calculate_center() const override { return Point<double>(); }
+        std::ostream& write_to_stream(std::ostream& ostream) const override { return ostream; }
+        std::istream& read_from_stream(std::istream& istream) override { return istream; }
+    };
+
+    Circle circle;
+    EXPECT_THROW(FigureVariant<double>::from_figure(circle), std::invalid_argument);
+}
+
+TEST(FigureVariantTest, PolygonSubclassIsNotSliced)
+{
+    struct LabeledTriangle final : Polygon<double>
+    {
+        LabeledTriangle(): Polygon<double>(3) {}
+    };
+
+    const LabeledTriangle triangle;
+    EXPECT_THROW(FigureVariant<double>::from_figure(triangle), std::invalid_argument);
+
+    const Polygon<double> plain(3);
+    EXPECT_TRUE(FigureVariant<double>::from_figure(plain).holds<Polygon<double>>());
+}
+
+// ============================================================================
+// TESTS FOR SPATIAL INDEX
+// ============================================================================
+
+static Array<Polygon<double>> make_spatial_figures(size_t count, size_t seed = 1)
+{
+    Array<Polygon<double>> figures;
+    unsigned long long state = seed;
+    auto next = [&state](double scale)
+    {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        return scale * static_cast<double>(state >> 11) / static_cast<double>(1ULL << 53);
+    };
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        const double x = next(100.0);
+        const double y = next(100.0);
+        const double size = 0.5 + next(i % 10 == 0 ? 30.0 : 4.0);
+
+        Polygon<double> polygon(3 + i % 3);
+        polygon.set_vertex(0, Point<double>(x, y));
+        polygon.set_vertex(1, Point<double>(x + size, y + next(1.0)));
+        polygon.set_vertex(2, Point<double>(x + size, y + size));
+        if (i % 3 >= 1)
+        {
+            polygon.set_vertex(3, Point<double>(x + size / 2, y + size / 3));
+        }
+        if (i % 3 == 2)
+        {
+            polygon.set_vertex(3, Point<double>(x + size / 2, y + 2 * size));
+            polygon.set_vertex(4, Point<double>(x - size / 2, y + size / 2));
+        }
+        figures.append(polygon);
+    }
+
+    return figures;
+}
+
+static std::vector<size_t> sorted_ids(std::vector<size_t> ids)
+{
+    std::sort(ids.begin(), ids.end());
+    return ids;
+}
+
+static void check_spatial_queries(const SpatialIndex<double>& index, const Array<Polygon<double>>& figures)
+{
+    ASSERT_EQ(index.get_size(), figures.get_size());
+
+    for (int q = 0; q < 40; ++q)
+    {
+        const double x = (q * 37) % 110 - 5.0;
+        const double y = (q * 53) % 110 - 5.0;
+        const BoundingBox<double> box(Point<double>(x, y), Point<double>(x + q % 7 * 3.0, y + q % 5 * 4.0));
+        const Point<double> point(x + 0.25, y + 0.75);
+
+        std::vector<size_t> in_range;
+        std::vector<size_t> containing;
+        std::vector<std::pair<double, size_t>> by_distance;
+        for (size_t i = 0; i < figures.get_size(); ++i)
+        {
+            if (figures[i].bounding_box().intersects(box))
+            {
+                in_range.push_back(i);
+            }
+            if (figures[i].contains(point))
+            {
+                containing.push_back(i);
+            }
+            by_distance.emplace_back(distance_squared(figures[i].get_center(), point), i);
+        }
+
+        std::sort(by_distance.begin(), by_distance.end());
+        const size_t k = std::min<size_t>(1 + q % 4 * 7, figures.get_size());
+        std::vector<size_t> nearest;
+        for (size_t i = 0; i < k; ++i)
+        {
+            nearest.push_back(by_distance[i].second);
+        }
+
+        EXPECT_EQ(sorted_ids(index.query_range(box)), in_range) << "query " << q;
+        EXPECT_EQ(sorted_ids(index.query_point(point)), containing) << "query " << q;
+        EXPECT_EQ(index.nearest(point, k), nearest) << "query " << q;
+    }
+}
+
+TEST(SpatialIndexTest, QueriesMatchLinearScan)
+{
+    const Array<Polygon<double>> figures = make_spatial_figures(2000);
+
+    for (SpatialIndexKind kind : {SpatialIndexKind::RTree, SpatialIndexKind::Grid})
+    {
+        const SpatialIndex<double> index(figures, kind);
+        EXPECT_EQ(index.get_kind(), kind);
+        check_spatial_queries(index, figures);
+    }
+}
+
+TEST(SpatialIndexTest, IncrementalInsertRemoveAndUpdate)
+{
+    const Array<Polygon<double>> extra = make_spatial_figures(600, 7);
+
+    for (SpatialIndexKind kind : {SpatialIndexKind::RTree, SpatialIndexKind::Grid})
+    {
+        Array<Polygon<double>> figures = make_spatial_figures(100);
+        SpatialIndex<double> index(figures, kind);
+
+        for (size_t i = 0; i < extra.get_size(); ++i)
+        {
+            figures.append(extra[i]);
+            index.insert(figures.get_size() - 1);
+        }
+        check_spatial_queries(index, figures);
+
+        for (size_t i = 0; i < 450; ++i)
+        {
+            const size_t id = (i * 131) % figures.get_size();
+            figures.swap_remove(id);
+            index.swap_remove(id);
+        }
+        check_spatial_queries(index, figures);
+
+        for (size_t i = 0; i < figures.get_size(); i += 5)
+        {
+            figures[i].set_vertex(0, Point<double>(120.0 - i % 50, -10.0 + i % 30));
+            index.update(i);
+        }
+        check_spatial_queries(index, figures);
+
+        figures.remove(0);
+        index.rebuild();
+        check_spatial_queries(index, figures);
+
+        while (figures.get_size() > 0)
+        {
+            figures.swap_remove(0);
+            index.swap_remove(0);
+        }
+        EXPECT_EQ(index.get_size(), 0);
+        EXPECT_TRUE(index.query_range(BoundingBox<double>(Point<double>(-1e9, -1e9), Point<double>(1e9, 1e9))).empty());
+        EXPECT_TRUE(index.nearest(Point<double>(0.0, 0.0), 3).empty());
+
+        figures.append(extra[0]);
+        index.insert(0);
+        EXPECT_EQ(index.nearest(Point<double>(0.0, 0.0), 3), std::vector<size_t>{0});
+    }
+}
+
+TEST(SpatialIndexTest, InvalidUpdatesThrow)
+{
+    Array<Polygon<double>> figures = make_spatial_figures(10);
+
+    for (SpatialIndexKind kind : {SpatialIndexKind::RTree, SpatialIndexKind::Grid})
+    {
+        SpatialIndex<double> index(figures, kind);
+        EXPECT_THROW(index.insert(3), std::invalid_argument);
+        EXPECT_THROW(index.insert(10), std::out_of_range);
+        index.remove(3);
+        EXPECT_THROW(index.remove(3), std::out_of_range);
+        EXPECT_EQ(index.get_size(), 9);
+        EXPECT_TRUE(index.nearest(Point<double>(0.0, 0.0), 0).empty());
+    }
+}
+
+TEST(SpatialIndexTest, PointerElements)
+{
+    Array<std::shared_ptr<Rectangle<int>>> figures;
+    for (int i = 0; i < 100; ++i)
+    {
+        figures.append(std::make_shared<Rectangle<int>>(RectangleParameters<int>{Point<int>(i % 10 * 10, i / 10 * 10), 5, 5}));
+    }
+
+    for (SpatialIndexKind kind : {SpatialIndexKind::RTree, SpatialIndexKind::Grid})
+    {
+        const SpatialIndex<int, std::shared_ptr<Rectangle<int>>> index(figures, kind);
+        EXPECT_EQ(index.query_point(Point<int>(23, 45)), std::vector<size_t>{42});
+        EXPECT_TRUE(index.query_point(Point<int>(27, 45)).empty());
+        EXPECT_EQ(sorted_ids(index.query_range(BoundingBox<int>(Point<int>(5, 5), Point<int>(10, 10)))), (std::vector<size_t>{0, 1, 10, 11}));
+        EXPECT_EQ(index.nearest(Point<double>(91.0, 91.0), 2), (std::vector<size_t>{99, 89}));
+    }
+}
+
+// ============================================================================
+// TESTS FOR FIGURE STREAM
+// ============================================================================
+
+template<SceneScalar T>
+void check_stream_matches_text_reader(size_t chunk_size, size_t queue_depth)
+{
+    Array<Polygon<T>> polygons;
+    FigureStore<T> store = make_mixed_store(polygons);
+    Polygon<T> large(300);
+    for (size_t i = 0; i < 300; ++i)
+    {
+        large.set_vertex(i, Point<T>(static_cast<T>(i % 17) / static_cast<T>(3), static_cast<T>(i % 11)));
+    }
+    store.append(large);
+
+    std::stringstream text;
+    write_scene_text(store, text);
+    const FigureStore<T> expected = read_scene_text<T>(text);
+    text.clear();
+    text.seekg(0);
+
+    FigureStreamReader<T> reader(text, chunk_size, queue_depth);
+    size_t index = 0;
+    for (const PolygonView<T>& figure : reader)
+    {
+        ASSERT_LT(index, expected.get_size());
+        EXPECT_EQ(figure.get_kind(), expected[index].get_kind());
+        ASSERT_EQ(figure.vertex_count(), expected[index].vertex_count());
+        for (size_t j = 0; j < figure.vertex_count(); ++j)
+        {
+            EXPECT_EQ(figure.get_vertex(j).x, expected[index].get_vertex(j).x);
+            EXPECT_EQ(figure.get_vertex(j).y, expected[index].get_vertex(j).y);
+        }
+        ++index;
+    }
+
+    EXPECT_EQ(index, expected.get_size());
+    EXPECT_EQ(reader.bytes_read(), text.str().size());
+}
+
+TEST(FigureStreamTest, MatchesTextReaderForAllChunkSizes)
+{
+    for (size_t chunk_size : {size_t(1), size_t(7), size_t(64), size_t(1) << 20})
+    {
+        check_stream_matches_text_reader<double>(chunk_size, 1);
+        check_stream_matches_text_reader<float>(chunk_size, 2);
+        check_stream_matches_text_reader<int32_t>(chunk_size, 4);
+    }
+}
+
+TEST(FigureStreamTest, AreaStatisticsAndHistogram)
+{
+    FigureStore<double> store;
+    for (int i = 1; i <= 1000; ++i)
+    {
+        store.append(Rectangle<double>(RectangleParameters<double>{Point<double>(i, -i), 1.0, i / 100.0}));
+    }
+
+    std::stringstream text;
+    write_scene_text(store, text);
+
+    AreaHistogram histogram(0.0, 5.0, 5);
+    const AreaStatistics statistics = stream_area_statistics<double>(text, &histogram);
+
+    EXPECT_EQ(statistics.count, 1000);
+    EXPECT_NEAR(statistics.total_area, store.total_area(), 1e-9);
+    EXPECT_NEAR(statistics.min_area, 0.01, 1e-12);
+    EXPECT_NEAR(statistics.max_area, 10.0, 1e-12);
+    EXPECT_NEAR(statistics.centroid.x, 501.0, 1e-9);
+    EXPECT_EQ(histogram.total(), 1000);
+    EXPECT_EQ(histogram.count(0), 99);
+    EXPECT_EQ(histogram.get_overflow(), 501);
+}
+
+TEST(FigureStreamTest, ErrorIsReportedAfterValidRecords)
+{
+    std::istringstream text("rectangle 4 0 0 1 0 1 1 0 1\npolygon 3 0 0 2 0 0 2\ntrapezoid 4 0 0 1 x 1 1 0 1\npolygon 3 0 0 1 0 0 1\n");
+    FigureStreamReader<double> reader(text, 8);
+
+    ASSERT_TRUE(reader.next().has_value());
+    ASSERT_TRUE(reader.next().has_value());
+    try
+    {
+        reader.next();
+        FAIL() << "Expected runtime_error";
+    }
+    catch (const std::runtime_error& error)
+    {
+        EXPECT_NE(std::string(error.what()).find("record 2"), std::string::npos);
+    }
+}
+
+TEST(FigureStreamTest, ErrorMidChunkKeepsEarlierRecordsOfChunk)
+{
+    std::istringstream text("rectangle 4 0 0 1 0 1 1 0 1\npolygon 3 0 0 2 0 0 2\nhexagon 3 0 0 1 0 0 1\npolygon 3 0 0 1 0 0 1\n");
+    FigureStreamReader<double> reader(text);
+
+    std::optional<PolygonView<double>> first = reader.next();
+    ASSERT_TRUE(first.has_value());
+    EXPECT_EQ(first->get_kind(), FigureKind::Rectangle);
+
+    std::optional<PolygonView<double>> second = reader.next();
+    ASSERT_TRUE(second.has_value());
+    EXPECT_DOUBLE_EQ(second->area(), 2.0);
+
+    EXPECT_THROW(reader.next(), std::runtime_error);
+}
+
+TEST(FigureStreamTest, StopsEarlyWithoutReadingEverything)
+{
+    std::string text;
+    for (int i = 0; i < 100000; ++i)
+    {
+        text += "rectangle 4 0 0 1 0 1 1 0 1\n";
+    }
+    std::istringstream stream(text);
+
+    {
+        FigureStreamReader<int32_t> reader(stream, 256, 1);
+        ASSERT_TRUE(reader.next().has_value());
+        EXPECT_DOUBLE_EQ(reader.next()->area(), 1.0);
+    }
+
+    EXPECT_LT(static_cast<size_t>(stream.tellg()), text.size());
+}
+
+TEST(FigureStreamTest, HistogramBins)
+{
+    AreaHistogram first(0.0, 1.0, 4);
+    for (double value : {-1.0, 0.0, 0.1, 0.25, 0.5, 0.99, 1.0, 7.0})
+    {
+        first.add(value);
+    }
+
+    EXPECT_EQ(first.get_underflow(), 1);
+    EXPECT_EQ(first.get_overflow(), 2);
+    EXPECT_EQ(first.count(0), 2);
+    EXPECT_EQ(first.count(1), 1);
+    EXPECT_EQ(first.count(2), 1);
+    EXPECT_EQ(first.count(3), 1);
+    EXPECT_DOUBLE_EQ(first.bin_low(2), 0.5);
+
+    AreaHistogram second(0.0, 1.0, 4);
+    second.add(0.3);
+    first.merge(second);
+    EXPECT_EQ(first.count(1), 2);
+    EXPECT_EQ(first.total(), 9);
+
+    EXPECT_THROW(first.merge(AreaHistogram(0.0, 2.0, 4)), std::invalid_argument);
+    EXPECT_THROW(AreaHistogram(1.0, 1.0, 4), std::invalid_argument);
+    EXPECT_THROW(AreaHistogram(0.0, 1.0, 0), std::invalid_argument);
+}
+
+// ============================================================================
+// TESTS FOR TEXT CODEC
+// ============================================================================
+
+template<class F>
+void check_text_round_trip_exact()
+{
+    std::vector<F> values = {F(0), -F(0), F(1) / F(3), F(0.1), std::numeric_limits<F>::max(), std::numeric_limits<F>::lowest(),
+                             std::numeric_limits<F>::min(), std::numeric_limits<F>::denorm_min(), std::numeric_limits<F>::epsilon()};
+    uint64_t state = 12345;
+    while (values.size() < 50000)
+    {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        const uint64_t bits = state >> 16;
+        F value;
+        std::memcpy(&value, &bits, sizeof(F));
+        if (std::isfinite(value))
+        {
+            values.push_back(value);
+        }
+    }
+
+    std::ostringstream output;
+    {
+        TextWriter writer(output);
+        for (F value : values)
+        {
+            writer.write_number(value);
+            writer.put(' ');
+        }
+    }
+
+    std::istringstream input(output.str());
+    TextScanner scanner(input);
+    for (F expected : values)
+    {
+        F value;
+        ASSERT_TRUE(scanner.read(value));
+        EXPECT_EQ(std::memcmp(&value, &expected, sizeof(F)), 0) << expected;
+    }
+
+    F extra;
+    EXPECT_FALSE(scanner.read(extra));
+}
+
+TEST(TextCodecTest, RoundTripIsBitExact)
+{
+    check_text_round_trip_exact<double>();
+    check_text_round_trip_exact<float>();
+}
+
+TEST(TextCodecTest, PolygonLayoutMatchesStreamOperator)
+{
+    Polygon<int> polygon(3);
+    polygon.set_vertex(0, Point<int>(-1, 2));
+    polygon.set_vertex(1, Point<int>(30, 0));
+    polygon.set_vertex(2, Point<int>(7, -400));
+
+    std::ostringstream expected;
+    expected << polygon;
+
+    std::ostringstream actual;
+    {
+        TextWriter writer(actual);
+        write_text(writer, polygon);
+    }
+
+    EXPECT_EQ(actual.str(), expected.str());
+
+    std::ostringstream empty;
+    {
+        TextWriter writer(empty);
+        write_text(writer, Polygon<int>());
+    }
+    EXPECT_EQ(empty.str(), "Empty");
+}
+
+TEST(TextCodecTest, ReadsOwnOutputAndPlainPairs)
+{
+    Polygon<double> polygon(1000);
+    for (size_t i = 0; i < 1000; ++i)
+    {
+        polygon.set_vertex(i, Point<double>(std::sin(i * 0.37) * 1e5, std::cos(i * 0.11) / 3.0));
+    }
+
+    std::stringstream text;
+    {
+        TextWriter writer(text);
+        write_text(writer, polygon);
+    }
+
+    Polygon<double> copy(1000);
+    TextScanner scanner(text);
+    read_text(scanner, copy);
+    for (size_t i = 0; i < 1000; ++i)
+    {
+        EXPECT_EQ(copy.get_vertex(i).x, polygon.get_vertex(i).x);
+        EXPECT_EQ(copy.get_vertex(i).y, polygon.get_vertex(i).y);
+    }
+
+    std::istringstream pairs("1 2\n+3 4.5e1\t5 -6");
+    Polygon<float> triangle(3);
+    TextScanner pair_scanner(pairs);
+    read_text(pair_scanner, triangle);
+    EXPECT_EQ(triangle.get_vertex(1), Point<float>(3.0f, 45.0f));
+    EXPECT_EQ(triangle.get_vertex(2), Point<float>(5.0f, -6.0f));
+}
+
+TEST(TextCodecTest, MalformedInput)
+{
+    std::istringstream fraction("1 2 3.5 4 5 6");
+    Polygon<int> polygon(3);
+    TextScanner scanner(fraction);
+    EXPECT_THROW(read_text(scanner, polygon), std::runtime_error);
+
+    std::istringstream truncated("1 2 3");
+    TextScanner short_scanner(truncated);
+    EXPECT_THROW(read_text(short_scanner, polygon), std::runtime_error);
+
+    std::istringstream words("abc 12");
+    TextScanner word_scanner(words);
+    int value = 0;
+    std::string word;
+    EXPECT_FALSE(word_scanner.read(value));
+    EXPECT_TRUE(word_scanner.read_word(word));
+    EXPECT_EQ(word, "abc");
+    EXPECT_TRUE(word_scanner.read(value));
+    EXPECT_EQ(value, 12);
+}
+
+// ============================================================================
+// TESTS FOR PREDICATES
+// ============================================================================
+
+template<Scalar T>
+Polygon<T> make_polygon(std::initializer_list<Point<T>> points)
+{
+    Polygon<T> polygon(points.size());
+    size_t i = 0;
+    for (const Point<T>& point : points)
+    {
+        polygon.set_vertex(i++, point);
+    }
+    return polygon;
+}
+
+TEST(PredicatesTest, Rectangle)
+{
+    const Rectangle<int> rectangle(RectangleParameters<int>{Point<int>(0, 0), 4, 2});
+
+    EXPECT_TRUE(rectangle.is_convex());
+    EXPECT_DOUBLE_EQ(rectangle.perimeter(), 12.0);
+    EXPECT_TRUE(rectangle.contains(Point<int>(2, 1)));
+    EXPECT_TRUE(rectangle.contains(Point<int>(4, 1)));
+    EXPECT_TRUE(rectangle.contains(Point<int>(0, 0)));
+    EXPECT_FALSE(rectangle.contains(Point<int>(5, 1)));
+    EXPECT_EQ(std::abs(rectangle.winding_number(Point<int>(2, 1))), 1);
+    EXPECT_EQ(rectangle.winding_number(Point<int>(5, 1)), 0);
+}
+
+TEST(PredicatesTest, Rhombus)
+{
+    const Rhombus<double> rhombus(RhombusParameters<double>{Point<double>(0.0, 0.0), 4.0, 2.0});
+
+    EXPECT_TRUE(rhombus.is_convex());
+    EXPECT_DOUBLE_EQ(rhombus.perimeter(), 4.0 * std::sqrt(5.0));
+    EXPECT_TRUE(rhombus.contains(Point<double>(0.0, 0.0)));
+    EXPECT_TRUE(rhombus.contains(Point<double>(2.0, 0.0)));
+    EXPECT_TRUE(rhombus.contains(Point<double>(1.0, 0.5)));
+    EXPECT_FALSE(rhombus.contains(Point<double>(1.5, 1.0)));
+    EXPECT_EQ(std::abs(rhombus.winding_number(Point<double>(0.5, 0.0))), 1);
+}
+
+TEST(PredicatesTest, Trapezoid)
+{
+    const Trapezoid<float> trapezoid(TrapezoidParameters<float>{Point<float>(0.0f, 0.0f), 6.0f, 2.0f, 2.0f, 2.0f});
+
+    EXPECT_TRUE(trapezoid.is_convex());
+    EXPECT_DOUBLE_EQ(trapezoid.perimeter(), 8.0 + 2.0 * std::sqrt(8.0));
+    EXPECT_TRUE(trapezoid.contains(Point<float>(3.0f, 1.0f)));
+    EXPECT_TRUE(trapezoid.contains(Point<float>(3.0f, 2.0f)));
+    EXPECT_FALSE(trapezoid.contains(Point<float>(0.5f, 1.8f)));
+    EXPECT_FALSE(trapezoid.contains(Point<float>(3.0f, 2.5f)));
+}
+
+TEST(PredicatesTest, Convexity)
+{
+    EXPECT_TRUE(make_polygon<int>({{0, 0}, {4, 0}, {0, 3}}).is_convex());
+    EXPECT_TRUE(make_polygon<int>({{0, 0}, {0, 2}, {2, 2}, {2, 0}}).is_convex());
+    EXPECT_TRUE(make_polygon<int>({{0, 0}, {2, 0}, {4, 0}, {4, 4}, {0, 4}}).is_convex());
+    EXPECT_FALSE(make_polygon<int>({{0, 0}, {4, 0}, {4, 1}, {1, 1}, {1, 4}, {0, 4}}).is_convex());
+    EXPECT_FALSE(make_polygon<int>({{0, 0}, {1, 1}, {2, 2}}).is_convex());
+    EXPECT_FALSE(make_polygon<int>({{0, 0}, {2, 2}, {2, 0}, {0, 2}}).is_convex());
+    EXPECT_FALSE(make_polygon<double>({{0.0, 10.0}, {5.9, -8.1}, {-9.5, 3.1}, {9.5, 3.1}, {-5.9, -8.1}}).is_convex());
+    EXPECT_FALSE(Polygon<int>().is_convex());
+    EXPECT_DOUBLE_EQ(Polygon<int>().perimeter(), 0.0);
+}
+
+TEST(PredicatesTest, WindingNumber)
+{
+    const Polygon<double> counterclockwise = make_polygon<double>({{0.0, 0.0}, {2.0, 0.0}, {2.0, 2.0}, {0.0, 2.0}});
+    const Polygon<double> clockwise = make_polygon<double>({{0.0, 0.0}, {0.0, 2.0}, {2.0, 2.0}, {2.0, 0.0}});
+    EXPECT_EQ(counterclockwise.winding_number(Point<double>(1.0, 1.0)), 1);
+    EXPECT_EQ(clockwise.winding_number(Point<double>(1.0, 1.0)), -1);
+
+    // Центр пентаграммы обходится дважды: по правилу чет-нечет он был бы снаружи.
+    const Polygon<double> star = make_polygon<double>({{0.0, 10.0}, {5.9, -8.1}, {-9.5, 3.1}, {9.5, 3.1}, {-5.9, -8.1}});
+    EXPECT_EQ(std::abs(star.winding_number(Point<double>(0.0, 0.0))), 2);
+    EXPECT_TRUE(star.contains(Point<double>(0.0, 0.0)));
+    EXPECT_EQ(std::abs(star.winding_number(Point<double>(0.0, 7.0))), 1);
+    EXPECT_FALSE(star.contains(Point<double>(0.0, -7.0)));
+}
+
+TEST(PredicatesTest, Intersects)
+{
+    const Rectangle<double> rectangle(RectangleParameters<double>{Point<double>(0.0, 0.0), 4.0, 2.0});
+    const Rhombus<double> overlapping(RhombusParameters<double>{Point<double>(4.0, 1.0), 2.0, 2.0});
+    const Rhombus<double> touching(RhombusParameters<double>{Point<double>(5.0, 1.0), 2.0, 2.0});
+    const Rhombus<double> corner(RhombusParameters<double>{Point<double>(5.0, 3.0), 2.0, 2.0});
+    const Trapezoid<double> inner(TrapezoidParameters<double>{Point<double>(1.0, 0.5), 2.0, 1.0, 1.0, 0.5});
+
+    EXPECT_TRUE(rectangle.intersects(overlapping));
+    EXPECT_TRUE(overlapping.intersects(rectangle));
+    EXPECT_TRUE(rectangle.intersects(touching));
+    EXPECT_FALSE(rectangle.intersects(corner));
+    EXPECT_TRUE(rectangle.intersects(inner));
+    EXPECT_TRUE(inner.intersects(rectangle));
+    EXPECT_FALSE(rectangle.intersects(Polygon<double>()));
+
+    // Невыпуклый случай: квадрат в вырезе буквы L не касается ее,
+    // хотя габариты пересекаются.
+    const Polygon<int> shape = make_polygon<int>({{0, 0}, {4, 0}, {4, 1}, {1, 1}, {1, 4}, {0, 4}});
+    EXPECT_FALSE(shape.intersects(make_polygon<int>({{2, 2}, {3, 2}, {3, 3}, {2, 3}})));
+    EXPECT_TRUE(shape.intersects(make_polygon<int>({{2, 1}, {3, 1}, {3, 3}, {2, 3}})));
+    EXPECT_TRUE(shape.intersects(make_polygon<int>({{-1, -1}, {5, -1}, {5, 5}, {-1, 5}})));
+    EXPECT_TRUE(make_polygon<int>({{-1, -1}, {5, -1}, {5, 5}, {-1, 5}}).intersects(shape));
+}
+
+template<Scalar T>
+void check_contains_batch_all_levels(const Polygon<T>& polygon)
+{
+    std::vector<Point<T>> points;
+    for (int i = -2; i <= 14; ++i)
+    {
+        for (int j = -2; j <= 14; ++j)
+        {
+            points.emplace_back(static_cast<T>(i) / static_cast<T>(2), static_cast<T>(j) / static_cast<T>(2));
+        }
+    }
+    for (size_t k = 0; k < polygon.vertex_count(); ++k)
+    {
+        points.push_back(polygon.get_vertex(k));
+    }
+
+    const SimdLevel detected = detect_simd_level();
+    for (SimdLevel level : {SimdLevel::Scalar, SimdLevel::SSE4, SimdLevel::AVX2})
+    {
+        if (static_cast<int>(level) > static_cast<int>(detected))
+        {
+            continue;
+        }
+
+        set_simd_level(level);
+        std::vector<unsigned char> inside(points.size());
+        contains_batch(polygon, std::span<const Point<T>>(points), std::span<unsigned char>(inside));
+
+        for (size_t i = 0; i < points.size(); ++i)
+        {
+            EXPECT_EQ(inside[i] != 0, polygon.contains(points[i])) << "level " << static_cast<int>(level) << ", point " << i;
+        }
+    }
+
+    set_simd_level(detected);
+}
+
+TEST(PredicatesTest, ContainsBatchMatchesContains)
+{
+    check_contains_batch_all_levels<int>(Rectangle<int>(RectangleParameters<int>{Point<int>(1, 2), 4, 3}));
+    check_contains_batch_all_levels<double>(Rhombus<double>(RhombusParameters<double>{Point<double>(3.0, 3.0), 5.0, 3.0}));
+    check_contains_batch_all_levels<float>(Trapezoid<float>(TrapezoidParameters<float>{Point<float>(0.5f, 1.0f), 6.0f, 2.5f, 4.0f, 1.5f}));
+    check_contains_batch_all_levels<int>(make_polygon<int>({{0, 0}, {4, 0}, {4, 1}, {1, 1}, {1, 4}, {0, 4}}));
+    check_contains_batch_all_levels<double>(make_polygon<double>({{3.0, 6.0}, {4.7, 0.6}, {0.2, 4.0}, {5.8, 4.0}, {1.3, 0.6}}));
+}
+
+TEST(PredicatesTest, ContainsBatchEdgeCases)
+{
+    const std::vector<Point<int>> points{{0, 0}, {1, 1}};
+    std::vector<unsigned char> inside(points.size(), 7);
+
+    contains_batch(Polygon<int>(), std::span<const Point<int>>(points), std::span<unsigned char>(inside));
+    EXPECT_EQ(inside, std::vector<unsigned char>({0, 0}));
+
+    std::vector<unsigned char> small(1);
+    EXPECT_THROW(contains_batch(make_polygon<int>({{0, 0}, {2, 0}, {0, 2}}), std::span<const Point<int>>(points), std::span<unsigned char>(small)), std::invalid_argument);
+}
+
+// ============================================================================
+// TESTS FOR ARITHMETIC POLICIES
+// ============================================================================
+
+template<Scalar T, ArithmeticPolicy Policy>
+Polygon<T, Policy> make_square(T x, T y, T side)
+{
+    Polygon<T, Policy> square(4);
+    square.set_vertex(0, Point<T>(x, y));
+    square.set_vertex(1, Point<T>(x + side, y));
+    square.set_vertex(2, Point<T>(x + side, y + side));
+    square.set_vertex(3, Point<T>(x, y + side));
+    return square;
+}
+
+TEST(ArithmeticTest, IntegerAreaDoesNotOverflow)
+{
+    const Polygon<int, RobustArithmetic> square = make_square<int, RobustArithmetic>(-1000000000, -1000000000, 2000000000);
+    EXPECT_DOUBLE_EQ(square.area(), 4e18);
+    EXPECT_DOUBLE_EQ(square.get_center().x, 0.0);
+
+    const Polygon<int64_t, RobustArithmetic> wide = make_square<int64_t, RobustArithmetic>(int64_t(1) << 40, 0, int64_t(3) << 40);
+    EXPECT_DOUBLE_EQ(wide.area(), std::ldexp(9.0, 80));
+
+    const Polygon<int> fast = make_square<int, FastArithmetic>(0, 0, 3);
+    const Polygon<int, RobustArithmetic> robust = make_square<int, RobustArithmetic>(0, 0, 3);
+    EXPECT_EQ(fast.area(), robust.area());
+}
+
+TEST(ArithmeticTest, FloatingAreaFarFromOrigin)
+{
+    const Polygon<double, RobustArithmetic> square = make_square<double, RobustArithmetic>(1e8 + 0.1, 1e8 + 0.3, 1.0);
+    const double side = (1e8 + 0.1 + 1.0) - (1e8 + 0.1);
+    const double height = (1e8 + 0.3 + 1.0) - (1e8 + 0.3);
+    EXPECT_NEAR(square.area(), side * height, 1e-9);
+
+    const Polygon<float, RobustArithmetic> single = make_square<float, RobustArithmetic>(1048576.0f, 1048576.0f, 0.5f);
+    EXPECT_DOUBLE_EQ(single.area(), 0.25);
+
+    EXPECT_DOUBLE_EQ((make_square<double, RobustArithmetic>(0.0, 0.0, 3.0).perimeter()), 12.0);
+}
+
+TEST(ArithmeticTest, IntegerOrientationIsExact)
+{
+    const int n = std::numeric_limits<int>::max();
+    const Point<int> origin(0, 0);
+    const Point<int> b(n, n - 1);
+    const Point<int> c(n - 1, n - 2);
+
+    // Точное значение (b - a) x (c - a) равно -1.
+    EXPECT_EQ(RobustArithmetic::orientation(origin, b, c), -1);
+    EXPECT_EQ(RobustArithmetic::orientation(origin, c, b), 1);
+    EXPECT_EQ(RobustArithmetic::orientation(origin, b, Point<int>(-n, -(n - 1))), 0);
+}
+
+TEST(ArithmeticTest, FloatingOrientationIsExact)
+{
+    // Пример Шевчука: точки около (0.5, 0.5) на сетке в ulp против
+    // прямой через (12, 12) и (24, 24). Точный знак - знак j - i.
+    const Point<double> q(12.0, 12.0);
+    const Point<double> r(24.0, 24.0);
+    const double ulp = std::ldexp(1.0, -53);
+    size_t fast_mistakes = 0;
+
+    for (int i = 0; i < 16; ++i)
+    {
+        for (int j = 0; j < 16; ++j)
+        {
+            const Point<double> p(0.5 + i * ulp, 0.5 + j * ulp);
+            const int expected = (j > i) - (j < i);
+            EXPECT_EQ(RobustArithmetic::orientation(q, r, p), expected) << i << ", " << j;
+            EXPECT_EQ(RobustArithmetic::orientation(r, p, q), expected) << i << ", " << j;
+            fast_mistakes += FastArithmetic::orientation(q, r, p) != expected;
+        }
+    }
+
+    EXPECT_GT(fast_mistakes, 0u);
+    EXPECT_EQ(RobustArithmetic::orientation(Point<float>(0.0f, 0.0f), Point<float>(1.0f, 1.0f), Point<float>(2.0f, 2.0f)), 0);
+}
+
+TEST(ArithmeticTest, RobustPredicates)
+{
+    const Polygon<int, RobustArithmetic> square = make_square<int, RobustArithmetic>(-2000000000, -2000000000, 2000000000);
+
+    EXPECT_TRUE(square.contains(Point<int>(-1, -1)));
+    EXPECT_TRUE(square.contains(Point<int>(0, -5)));
+    EXPECT_FALSE(square.contains(Point<int>(1, -5)));
+    EXPECT_TRUE(square.is_convex());
+    EXPECT_TRUE(square.intersects(make_square<int, RobustArithmetic>(0, 0, 5)));
+    EXPECT_FALSE(square.intersects(make_square<int, RobustArithmetic>(1, 1, 5)));
+
+    Polygon<double, RobustArithmetic> triangle(3);
+    triangle.set_vertex(0, Point<double>(12.0, 12.0));
+    triangle.set_vertex(1, Point<double>(24.0, 24.0));
+    triangle.set_vertex(2, Point<double>(0.5, 24.0));
+    EXPECT_TRUE(triangle.contains(Point<double>(18.0, 18.0)));
+    EXPECT_TRUE(triangle.contains(Point<double>(18.0, 18.0 + std::ldexp(1.0, -48))));
+    EXPECT_FALSE(triangle.contains(Point<double>(18.0 + std::ldexp(1.0, -48), 18.0)));
+
+    const Polygon<double, RobustArithmetic> copy = triangle;
+    EXPECT_DOUBLE_EQ(copy.area(), triangle.area());
+}
+
+TEST(ArithmeticTest, PointEqualityIsTypeAware)
+{
+    EXPECT_EQ(Point<int>(3, 4), Point<int>(3, 4));
+    EXPECT_NE(Point<int>(3, 4), Point<int>(3, 5));
+    EXPECT_NE(Point<int64_t>(int64_t(1) << 60, 0), Point<int64_t>((int64_t(1) << 60) + 1, 0));
+
+    EXPECT_EQ(Point<double>(1.0, 0.0), Point<double>(1.0 + 1e-7, 0.0));
+    EXPECT_NE(Point<double>(1.0, 0.0), Point<double>(1.00001, 0.0));
+    EXPECT_EQ(Point<double>(1e9, 0.0), Point<double>(1e9 + 1.0, 0.0));
+    EXPECT_NE(Point<double>(1e9, 0.0), Point<double>(1e9 + 1e4, 0.0));
+
+    EXPECT_EQ(Point<float>(1048576.0f, 0.0f), Point<float>(1048576.125f, 0.0f));
+    EXPECT_NE(Point<float>(1.0f, 0.0f), Point<float>(1.001f, 0.0f));
+}
+
+// ============================================================================
+// TESTS FOR CONCURRENT ARRAY
+// ============================================================================
+
+namespace
+{
+    // Конструктор бросает исключение для отрицательных значений.
+    struct FragileValue
+    {
+        int value;
+
+        explicit FragileValue(int value): value(value)
+        {
+            if (value < 0)
+            {
+                throw std::invalid_argument("Error: Negative value.");
+            }
+        }
+
+        FragileValue(FragileValue&& other) noexcept = default;
+    };
+}
+
+
+TEST(ConcurrentArrayTest, AppendNeverMovesElements)
+{
+    ConcurrentArray<int> values(4);
+    values.append(0);
+    const int* first = &values[0];
+
+    for (int i = 1; i < 1000; ++i)
+    {
+        EXPECT_EQ(values.append(i), static_cast<size_t>(i));
+    }
+
+    EXPECT_EQ(values.get_size(), 1000);
+    EXPECT_EQ(&values[0], first);
+    EXPECT_LE(values.segment_count(), 9);
+    for (int i = 0; i < 1000; ++i)
+    {
+        EXPECT_EQ(values[i], i);
+    }
+    EXPECT_THROW(values[1000], std::out_of_range);
+
+    long long sum = 0;
+    values.for_each([&](int value) { sum += value; });
+    EXPECT_EQ(sum, 999LL * 1000 / 2);
+}
+
+
+TEST(ConcurrentArrayTest, ProducersAndReaderStress)
+{
+    constexpr size_t producers = 8;
+    constexpr size_t per_producer = 20000;
+    ConcurrentArray<uint64_t> values(2);
+    std::atomic<bool> done = false;
+    std::atomic<bool> corrupted = false;
+
+    // Читатель проверяет, что каждый видимый элемент уже построен.
+    std::thread reader([&]
+    {
+        while (!done.load())
+        {
+            const size_t size = values.get_size();
+            for (size_t i = 0; i < size; ++i)
+            {
+                if ((values[i] >> 32) >= producers || (values[i] & 0xffffffff) >= per_producer)
+                {
+                    corrupted.store(true);
+                }
+            }
+        }
+    });
+
+    std::vector<std::thread> writers;
+    for (size_t producer = 0; producer < producers; ++producer)
+    {
+        writers.emplace_back([&values, producer]
+        {
+            for (size_t i = 0; i < per_producer; ++i)
+            {
+                values.append((producer << 32) | i);
+            }
+        });
+    }
+    for (std::thread& writer : writers)
+    {
+        writer.join();
+    }
+    done.store(true);
+    reader.join();
+
+    EXPECT_FALSE(corrupted.load());
+    ASSERT_EQ(values.get_size(), producers * per_producer);
+
+    // Элементы одного производителя идут в порядке добавления, без пропусков.
+    std::vector<size_t> next(producers, 0);
+    values.for_each([&](uint64_t value)
+    {
+        const size_t producer = value >> 32;
+        EXPECT_EQ(value & 0xffffffff, next[producer]);
+        ++next[producer];
+    });
+    for (size_t count : next)
+    {
+        EXPECT_EQ(count, per_producer);
+    }
+}
+
+
+TEST(ConcurrentArrayTest, ThrowingConstructorDoesNotStallSize)
+{
+    ConcurrentArray<FragileValue> values;
+
+    values.emplace_back(1);
+    EXPECT_THROW(values.emplace_back(-1), std::invalid_argument);
+    values.emplace_back(2);
+
+    ASSERT_EQ(values.get_size(), 2);
+    EXPECT_EQ(values[0].value, 1);
+    EXPECT_EQ(values[1].value, 2);
+}
+
+
+TEST(ConcurrentArrayTest, FailedSegmentAllocationDoesNotStallSize)
+{
+    // Таблица, сегмент 0 и заранее выделенный сегмент 1
+    LimitedResource resource(3);
+    ConcurrentArray<int> array(1, &resource);
+
+    EXPECT_EQ(array.append(0), 0);
+    EXPECT_THROW(array.append(1), std::bad_alloc);
+    EXPECT_EQ(array.get_size(), 1);
+
+    resource.refill(16);
+    EXPECT_EQ(array.append(1), 1);
+    EXPECT_EQ(array.append(2), 2);
+    EXPECT_EQ(array.get_size(), 3);
+    EXPECT_EQ(array[2], 2);
+}
+
+TEST(ConcurrentArrayTest, CompactMergesSegments)
+{
+    ConcurrentArray<std::string> values(4);
+    for (int i = 0; i < 100; ++i)
+    {
+        values.append(std::to_string(i));
+    }
+    EXPECT_GT(values.segment_count(), 1);
+
+    values.compact();
+
+    EXPECT_EQ(values.segment_count(), 1);
+    ASSERT_EQ(values.get_size(), 100);
+    for (int i = 0; i < 100; ++i)
+    {
+        EXPECT_EQ(values[i], std::to_string(i));
+    }
+
+    values.append("tail");
+    EXPECT_EQ(values[100], "tail");
+    EXPECT_EQ(values.segment_count(), 1);
+}
+
+
+TEST(ConcurrentArrayTest, CompactWaitsForPinnedReaders)
+{
+    ConcurrentArray<std::string> values(4);
+    for (int i = 0; i < 100; ++i)
+    {
+        values.append(std::to_string(i));
+    }
+
+    std::atomic<bool> compacted = false;
+    std::optional<ConcurrentArray<std::string>::ReadGuard> guard(values.pin());
+    const std::string& old = values[42];
+
+    std::thread compactor([&]
+    {
+        values.compact();
+        compacted.store(true);
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_FALSE(compacted.load());
+    EXPECT_EQ(old, "42");
+
+    guard.reset();
+    compactor.join();
+
+    EXPECT_TRUE(compacted.load());
+    EXPECT_EQ(values.segment_count(), 1);
+    EXPECT_EQ(values[42], "42");
+}
+
+
+TEST(ConcurrentArrayTest, CompactRefusesWhileCallerIsPinned)
+{
+    ConcurrentArray<int> values(4);
+    ConcurrentArray<int> other(4);
+    for (int i = 0; i < 20; ++i)
+    {
+        values.append(i);
+        other.append(i);
+    }
+
+    {
+        ConcurrentArray<int>::ReadGuard guard = values.pin();
+        ConcurrentArray<int>::ReadGuard moved(std::move(guard));
+        EXPECT_THROW(values.compact(), std::logic_error);
+
+        other.compact();
+        EXPECT_EQ(other.segment_count(), 1);
+    }
+
+    values.compact();
+    EXPECT_EQ(values.segment_count(), 1);
+    EXPECT_EQ(values[19], 19);
+}
+
+// ============================================================================
+// TESTS FOR STATIC POLYGON
+// ============================================================================
+
+namespace
+{
+    constexpr StaticPolygon stencil(Point<int>(0, 0), Point<int>(4, 0), Point<int>(4, 3), Point<int>(0, 3));
+    constexpr StaticPolygon<double, 3> footprint(std::array{Point<double>(0.0, 0.0), Point<double>(3.0, 0.0), Point<double>(0.0, 3.0)});
+}
+
+
+TEST(StaticPolygonTest, AreaAndCenterAtCompileTime)
+{
+    static_assert(stencil.vertex_count() == 4);
+    static_assert(stencil.area() == 12.0);
+    static_assert(stencil.center() == Point<double>(2.0, 1.5));
+    static_assert(footprint.area() == 4.5);
+    static_assert(footprint.center() == Point<double>(1.0, 1.0));
+    static_assert(stencil.get_vertex(2) == Point<int>(4, 3));
+}
+
+
+TEST(StaticPolygonTest, MutableInConstexprFunction)
+{
+    constexpr double area = []
+    {
+        StaticPolygon<int, 3> triangle;
+        triangle.set_vertex(1, Point<int>(2, 0));
+        triangle.set_vertex(2, Point<int>(0, 2));
+        return triangle.area();
+    }();
+
+    static_assert(area == 2.0);
+}
+
+
+TEST(StaticPolygonTest, MatchesPolygon)
+{
+    const Polygon<int> polygon = stencil.to_polygon();
+
+    EXPECT_EQ(polygon.vertex_count(), 4);
+    EXPECT_DOUBLE_EQ(polygon.area(), stencil.area());
+    EXPECT_EQ(polygon.get_center(), stencil.center());
+    EXPECT_THROW(stencil.get_vertex(4), std::out_of_range);
+}
+
+// ============================================================================
+// TESTS FOR INSTRUMENTATION
+// ============================================================================
+
+TEST(InstrumentationTest, RecordAndReset)
+{
+    Instrumentation::reset();
+    Instrumentation::record(InstrumentedOperation::ArrayShift, 10, 100);
+    Instrumentation::record(InstrumentedOperation::ArrayShift, 5, 3);
+    Instrumentation::record(InstrumentedOperation::PolygonCopy, 4, 0);
+
+    InstrumentationSnapshot snapshot = Instrumentation::snapshot();
+    const OperationStatistics& shifts = snapshot[InstrumentedOperation::ArrayShift];
+    EXPECT_EQ(shifts.count, 2);
+    EXPECT_EQ(shifts.items, 15);
+    EXPECT_EQ(shifts.total_nanoseconds, 103);
+    EXPECT_EQ(shifts.latency_buckets[6], 1);
+    EXPECT_EQ(shifts.latency_buckets[1], 1);
+    EXPECT_EQ(snapshot[InstrumentedOperation::PolygonCopy].latency_buckets[0], 1);
+
+    Instrumentation::reset();
+    snapshot = Instrumentation::snapshot();
+    EXPECT_EQ(snapshot[InstrumentedOperation::ArrayShift].count, 0);
+    EXPECT_EQ(snapshot[InstrumentedOperation::PolygonCopy].count, 0);
+}
+
+
+TEST(InstrumentationTest, ThreadSlotsAreSummed)
+{
+    Instrumentation::reset();
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; ++i)
+    {
+        threads.emplace_back([]
+        {
+            for (int j = 0; j < 1000; ++j)
+            {
+                Instrumentation::record(InstrumentedOperation::PolygonArea, 1, 50);
+            }
+        });
+    }
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+
+    const InstrumentationSnapshot snapshot = Instrumentation::snapshot();
+    EXPECT_EQ(snapshot[InstrumentedOperation::PolygonArea].count, 4000);
+    EXPECT_EQ(snapshot[InstrumentedOperation::PolygonArea].items, 4000);
+}
+
+
+TEST(InstrumentationTest, CountsSurviveThreadExitAndResetKeepsLaterRecords)
+{
+    Instrumentation::reset();
+    Instrumentation::record(InstrumentedOperation::PolygonCopy, 4, 10);
+
+    for (int round = 0; round < 50; ++round)
+    {
+        std::thread worker([] { Instrumentation::record(InstrumentedOperation::PolygonCopy, 2, 10); });
+        worker.join();
+    }
+
+    InstrumentationSnapshot snapshot = Instrumentation::snapshot();
+    EXPECT_EQ(snapshot[InstrumentedOperation::PolygonCopy].count, 51);
+    EXPECT_EQ(snapshot[InstrumentedOperation::PolygonCopy].items, 104);
+    EXPECT_EQ(snapshot[InstrumentedOperation::PolygonCopy].latency_buckets[3], 51);
+
+    Instrumentation::reset();
+    Instrumentation::record(InstrumentedOperation::PolygonCopy, 1, 10);
+    snapshot = Instrumentation::snapshot();
+    EXPECT_EQ(snapshot[InstrumentedOperation::PolygonCopy].count, 1);
+    EXPECT_EQ(snapshot[InstrumentedOperation::PolygonCopy].items, 1);
+    EXPECT_EQ(snapshot[InstrumentedOperation::PolygonCopy].latency_buckets[3], 1);
+    Instrumentation::reset();
+}
+
+
+TEST(InstrumentationTest, JsonAndPrometheusOutput)
+{
+    InstrumentationSnapshot snapshot;
+    snapshot.operations[static_cast<size_t>(InstrumentedOperation::ArrayReallocation)].count = 2;
+    snapshot.operations[static_cast<size_t>(InstrumentedOperation::ArrayReallocation)].items = 48;
+    snapshot.operations[static_cast<size_t>(InstrumentedOperation::ArrayReallocation)].total_nanoseconds = 300;
+    snapshot.operations[static_cast<size_t>(InstrumentedOperation::ArrayReallocation)].latency_buckets[7] = 2;
+
+    std::ostringstream json;
+    Instrumentation::write_json(json, snapshot);
+    EXPECT_NE(json.str().find("\"array_reallocation\": {\"count\": 2, \"items\": 48, \"total_ns\": 300, \"latency_buckets_ns\": [0, 0, 0, 0, 0, 0, 0, 2, 0"), std::string::npos);
+    EXPECT_NE(json.str().find("\"polygon_area\": {\"count\": 0"), std::string::npos);
+
+    std::ostringstream prometheus;
+    Instrumentation::write_prometheus(prometheus, snapshot);
+    const std::string text = prometheus.str();
+    EXPECT_NE(text.find("geometry_operations_total{operation=\"array_reallocation\"} 2\n"), std::string::npos);
+    EXPECT_NE(text.find("geometry_operation_items_total{operation=\"array_reallocation\"} 48\n"), std::string::npos);
+    EXPECT_NE(text.find("geometry_operation_latency_nanoseconds_bucket{operation=\"array_reallocation\",le=\"127\"} 0\n"), std::string::npos);
+    EXPECT_NE(text.find("geometry_operation_latency_nanoseconds_bucket{operation=\"array_reallocation\",le=\"255\"} 2\n"), std::string::npos);
+    EXPECT_NE(text.find("geometry_operation_latency_nanoseconds_bucket{operation=\"array_reallocation\",le=\"+Inf\"} 2\n"), std::string::npos);
+    EXPECT_NE(text.find("geometry_operation_latency_nanoseconds_sum{operation=\"array_reallocation\"} 300\n"), std::string::npos);
+}
+
+
+// Без GEOMETRY_INSTRUMENTATION операции ничего не записывают.
+TEST(InstrumentationTest, HooksFollowBuildSwitch)
+{
+    Instrumentation::reset();
+
+    Array<int> values(4);
+    for (int i = 0; i < 10; ++i)
+    {
+        values.append(i);
+    }
+    values.remove(0);
+
+    Polygon<int> square(4);
+    square.set_vertex(1, Point<int>(1, 0));
+    square.set_vertex(2, Point<int>(1, 1));
+    square.set_vertex(3, Point<int>(0, 1));
+    const Polygon<int> copy = square;
+    EXPECT_DOUBLE_EQ(copy.area(), 1.0);
+
+    const InstrumentationSnapshot snapshot = Instrumentation::snapshot();
+    if constexpr (instrumentation_enabled)
+    {
+        EXPECT_EQ(snapshot[InstrumentedOperation::ArrayReallocation].count, 2);
+        EXPECT_EQ(snapshot[InstrumentedOperation::ArrayReallocation].items, 4 + 8);
+        EXPECT_EQ(snapshot[InstrumentedOperation::ArrayShift].count, 1);
+        EXPECT_EQ(snapshot[InstrumentedOperation::ArrayShift].items, 9);
+        EXPECT_EQ(snapshot[InstrumentedOperation::PolygonCopy].count, 1);
+        EXPECT_EQ(snapshot[InstrumentedOperation::PolygonArea].count, 1);
+    }
+    else
+    {
+        for (const OperationStatistics& statistics : snapshot.operations)
+        {
+            EXPECT_EQ(statistics.count, 0);
+        }
+    }
+}
+
+// ============================================================================
+// TESTS FOR SIMPLIFICATION
+// ============================================================================
+
+static Polygon<double> make_wavy_circle(size_t count, double radius, double wave)
+{
+    std::vector<Point<double>> vertices;
+    for (size_t i = 0; i < count; ++i)
+    {
+        const double angle = 2.0 * M_PI * i / count;
+        const double r = radius + wave * std::sin(40.0 * angle);
+        vertices.emplace_back(r * std::cos(angle), r * std::sin(angle));
+    }
+
+    return Polygon<double>(vertices);
+}
+
+TEST(SimplificationTest, DouglasPeuckerDropsNearlyCollinearVertices)
+{
+    const std::vector<Point<double>> vertices{
+        Point<double>(0.0, 0.0), Point<double>(2.0, 0.05), Point<double>(4.0, 0.0), Point<double>(4.0, 2.0),
+        Point<double>(4.1, 4.0), Point<double>(2.0, 4.0), Point<double>(0.0, 4.0), Point<double>(0.0, 2.0)};
+    const Polygon<double> polygon(vertices);
+
+    const LevelOfDetail<double> coarse = simplify_polygon(polygon, SimplificationMethod::DouglasPeucker, 0.2);
+    ASSERT_EQ(coarse.polygon.vertex_count(), 4);
+    EXPECT_EQ(coarse.polygon.get_vertex(0), Point<double>(0.0, 0.0));
+    EXPECT_EQ(coarse.polygon.get_vertex(2), Point<double>(4.1, 4.0));
+    EXPECT_LE(coarse.deviation, 0.2);
+    EXPECT_GT(coarse.deviation, 0.0);
+
+    EXPECT_EQ(simplify_polygon(polygon, SimplificationMethod::DouglasPeucker, 0.01).polygon.vertex_count(), 6);
+    EXPECT_EQ(simplify_polygon(polygon, SimplificationMethod::DouglasPeucker, 100.0).polygon.vertex_count(), 3);
+}
+
+TEST(SimplificationTest, VisvalingamWhyattRemovesSmallestTrianglesFirst)
+{
+    const std::vector<Point<int>> vertices{
+        Point<int>(0, 0), Point<int>(5, 1), Point<int>(10, 0), Point<int>(10, 10), Point<int>(5, 7), Point<int>(0, 10)};
+    const Polygon<int> polygon(vertices);
+
+    const LevelOfDetail<int> level = simplify_polygon(polygon, SimplificationMethod::VisvalingamWhyatt, 3.0);
+    ASSERT_EQ(level.polygon.vertex_count(), 5);
+    EXPECT_EQ(level.polygon.get_vertex(1), Point<int>(10, 0));
+    EXPECT_NEAR(level.area_error, 5.0 / 80.0, 1e-12);
+
+    EXPECT_EQ(simplify_polygon(polygon, SimplificationMethod::VisvalingamWhyatt, 0.0).polygon.vertex_count(), 6);
+    EXPECT_EQ(simplify_polygon(polygon, SimplificationMethod::VisvalingamWhyatt, 1000.0).polygon.vertex_count(), 3);
+    EXPECT_EQ(simplify_polygon(Polygon<int>(3), SimplificationMethod::VisvalingamWhyatt, 1000.0).polygon.vertex_count(), 3);
+}
+
+TEST(SimplificationTest, AreaPreservingKeepsArea)
+{
+    const Polygon<double> circle = make_wavy_circle(2000, 100.0, 0.5);
+
+    const LevelOfDetail<double> plain = simplify_polygon(circle, SimplificationMethod::VisvalingamWhyatt, 3.0);
+    const LevelOfDetail<double> preserved = simplify_polygon(circle, SimplificationMethod::AreaPreserving, 3.0);
+    EXPECT_EQ(plain.polygon.vertex_count(), preserved.polygon.vertex_count());
+    EXPECT_LT(plain.polygon.vertex_count(), 200);
+    EXPECT_GT(plain.area_error, 1e-3);
+    EXPECT_LT(preserved.area_error, 1e-12);
+    EXPECT_NEAR(preserved.polygon.area(), circle.area(), 1e-9 * circle.area());
+}
+
+TEST(SimplificationTest, LevelsAreSelectedByTolerance)
+{
+    const Polygon<double> circle = make_wavy_circle(1000, 50.0, 0.2);
+    const std::vector<double> tolerances{5.0, 0.01, 0.5, 0.5, 2.0};
+    const PolygonLevels<double> levels(circle, SimplificationMethod::DouglasPeucker, tolerances);
+
+    ASSERT_GE(levels.level_count(), 4);
+    EXPECT_EQ(levels.get_level(0).polygon.vertex_count(), 1000);
+    EXPECT_EQ(levels.get_level(0).deviation, 0.0);
+    for (size_t i = 1; i < levels.level_count(); ++i)
+    {
+        const LevelOfDetail<double>& level = levels.get_level(i);
+        EXPECT_LT(level.polygon.vertex_count(), levels.get_level(i - 1).polygon.vertex_count());
+        EXPECT_LE(level.deviation, level.tolerance);
+    }
+
+    EXPECT_EQ(&levels.select(0.0), &levels.get_level(0).polygon);
+    EXPECT_EQ(&levels.select(1000.0), &levels.get_level(levels.level_count() - 1).polygon);
+    const Polygon<double>& chosen = levels.select(0.6);
+    EXPECT_LT(chosen.vertex_count(), 1000);
+    EXPECT_THROW(levels.get_level(levels.level_count()), std::out_of_range);
+    EXPECT_THROW(PolygonLevels<double>().select(1.0), std::runtime_error);
+}
+
+TEST(SimplificationTest, ParallelBuildMatchesSequential)
+{
+    Array<Polygon<double>> polygons;
+    for (size_t i = 0; i < 70; ++i)
+    {
+        polygons.append(make_wavy_circle(100 + 10 * i, 10.0 + i, 0.1 * (i % 5)));
+    }
+
+    const std::vector<double> tolerances{0.05, 0.3, 1.0};
+    ThreadPool pool(3);
+    const std::vector<PolygonLevels<double>> levels = build_levels_of_detail(polygons, pool, SimplificationMethod::AreaPreserving, tolerances);
+
+    ASSERT_EQ(levels.size(), 70);
+    for (size_t i = 0; i < levels.size(); i += 7)
+    {
+        const PolygonLevels<double> expected(polygons[i], SimplificationMethod::AreaPreserving, tolerances);
+        ASSERT_EQ(levels[i].level_count(), expected.level_count());
+        for (size_t j = 0; j < expected.level_count(); ++j)
+        {
+            EXPECT_EQ(levels[i].get_level(j).polygon.vertex_count(), expected.get_level(j).polygon.vertex_count());
+            EXPECT_EQ(levels[i].get_level(j).deviation, expected.get_level(j).deviation);
+        }
+    }
+}
+
 // ============================================================================
 // MAIN FOR TESTS
 // ============================================================================
@@ -0,0 +1,110 @@
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+
+#include "../include/SceneFile.h"
+
+
+// Конвертер сцен между текстовым и двоичным форматами.
+// Направление определяется по входному файлу: двоичная сцена
+// превращается в текст, текст - в двоичную сцену.
+
+
+void print_usage(const char* program)
+{
+    std::cerr << "Usage: " << program << " [--type int|float|double] <input> <output>\n"
+              << "Converts a text scene to binary or a binary scene to text.\n"
+              << "--type selects the coordinate type for text input (default: double).\n";
+}
+
+
+template<SceneScalar T>
+void binary_to_text(const MappedFile& file, const std::string& output)
+{
+    std::ofstream ostream(output);
+    if (!ostream)
+    {
+        throw std::runtime_error("Error: Cannot open file " + output + ".");
+    }
+
+    SceneView<T> scene(file.get_data(), file.get_size());
+    write_scene_text(scene.to_store(), ostream);
+}
+
+
+template<SceneScalar T>
+void text_to_binary(const std::string& input, const std::string& output)
+{
+    std::ifstream istream(input);
+    if (!istream)
+    {
+        throw std::runtime_error("Error: Cannot open file " + input + ".");
+    }
+
+    save_scene(read_scene_text<T>(istream), output);
+}
+
+
+int main(int argc, char** argv)
+{
+    std::string type = "double";
+    int first = 1;
+
+    if (argc == 5 && std::strcmp(argv[1], "--type") == 0)
+    {
+        type = argv[2];
+        first = 3;
+    }
+    else if (argc != 3)
+    {
+        print_usage(argv[0]);
+        return 2;
+    }
+
+    const std::string input = argv[first];
+    const std::string output = argv[first + 1];
+
+    try
+    {
+        MappedFile file(input);
+
+        if (std::optional<SceneScalarType> scalar = peek_scene_scalar_type(file.get_data(), file.get_size()))
+        {
+            switch (*scalar)
+            {
+                case SceneScalarType::Int32: binary_to_text<int32_t>(file, output); break;
+                case SceneScalarType::Float32: binary_to_text<float>(file, output); break;
+                case SceneScalarType::Float64: binary_to_text<double>(file, output); break;
+                default: throw std::runtime_error("Error: Unknown coordinate type in scene.");
+            }
+        }
+        else if (type == "int")
+        {
+            text_to_binary<int32_t>(input, output);
+        }
+        else if (type == "float")
+        {
+            text_to_binary<float>(input, output);
+        }
+        else if (type == "double")
+        {
+            text_to_binary<double>(input, output);
+        }
+        else
+        {
+            print_usage(argv[0]);
+            return 2;
+        }
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,114 @@
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+
+#include "../include/FigureStream.h"
+
+
+// Статистика площадей текстовой сцены, прочитанной потоком:
+// файл любого размера обрабатывается в ограниченной памяти.
+
+
+void print_usage(const char* program)
+{
+    std::cerr << "Usage: " << program << " [--type int|float|double] [--bins N] [--max-area A] [<input>|-]\n"
+              << "Streams a text scene from a file or stdin and prints area statistics.\n";
+}
+
+
+template<SceneScalar T>
+void print_statistics(std::istream& istream, size_t bins, double max_area)
+{
+    AreaHistogram histogram(0.0, max_area, bins);
+    const AreaStatistics statistics = stream_area_statistics<T>(istream, &histogram);
+
+    std::cout << "figures: " << statistics.count << '\n'
+              << "total area: " << statistics.total_area << '\n'
+              << "min area: " << statistics.min_area << '\n'
+              << "max area: " << statistics.max_area << '\n'
+              << "centroid: (" << statistics.centroid.x << ", " << statistics.centroid.y << ")\n";
+
+    for (size_t i = 0; i < histogram.bin_count(); ++i)
+    {
+        std::cout << "[" << histogram.bin_low(i) << ", " << histogram.bin_low(i + 1) << "): " << histogram.count(i) << '\n';
+    }
+    std::cout << ">= " << max_area << ": " << histogram.get_overflow() << '\n';
+}
+
+
+int main(int argc, char** argv)
+{
+    std::string type = "double";
+    std::string input = "-";
+    size_t bins = 10;
+    double max_area = 100.0;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--type") == 0 && i + 1 < argc)
+        {
+            type = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--bins") == 0 && i + 1 < argc)
+        {
+            bins = std::strtoul(argv[++i], nullptr, 10);
+        }
+        else if (std::strcmp(argv[i], "--max-area") == 0 && i + 1 < argc)
+        {
+            max_area = std::strtod(argv[++i], nullptr);
+        }
+        else if (i + 1 == argc)
+        {
+            input = argv[i];
+        }
+        else
+        {
+            print_usage(argv[0]);
+            return 2;
+        }
+    }
+
+    try
+    {
+        std::ifstream file;
+        if (input != "-")
+        {
+            file.open(input, std::ios::binary);
+            if (!file)
+            {
+                throw std::runtime_error("Error: Cannot open file " + input + ".");
+            }
+        }
+        std::istream& istream = input == "-" ? std::cin : file;
+
+        if (type == "int")
+        {
+            print_statistics<int32_t>(istream, bins, max_area);
+        }
+        else if (type == "float")
+        {
+            print_statistics<float>(istream, bins, max_area);
+        }
+        else if (type == "double")
+        {
+            print_statistics<double>(istream, bins, max_area);
+        }
+        else
+        {
+            print_usage(argv[0]);
+            return 2;
+        }
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}